@@ -15,7 +15,9 @@
 
 #include <algorithm>
 #include <cctype>
+#include <chrono>
 #include <sstream>
+#include <vector>
 #include "wx/app.h"
 #include "wx/cmdline.h"
 #include "wx/filename.h"
@@ -56,12 +58,14 @@ struct CommandLine{
     preventServer(false),
     silentMode(false),
     script(false),
+    startupProfile(false),
     port(get_default_faint_port())
   {}
   bool forceNew; // single instance
   bool preventServer; // single instance
   bool silentMode;
   bool script;
+  bool startupProfile;
   Optional<FilePath> scriptPath;
   utf8_string port;
   FileList files;
@@ -101,6 +105,10 @@ static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
    "Custom argument stored in ifaint.cmd_arg.", // Fixme: Duplication
    wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL},
 
+  {wxCMD_LINE_SWITCH, "", "startup-profile",
+   "Print the time spent in each phase of the start-up",
+   wxCMD_LINE_VAL_NONE, wxCMD_LINE_PARAM_OPTIONAL},
+
   {wxCMD_LINE_NONE, "", "", "",
    wxCMD_LINE_VAL_NONE, wxCMD_LINE_PARAM_OPTIONAL} // Sentinel
 };
@@ -169,6 +177,42 @@ static PaintMap default_palette(){
   return palette;
 }
 
+class StartupProfile{
+  // Measures the time spent in each phase of the start-up, for
+  // --startup-profile.
+public:
+  using clock = std::chrono::steady_clock;
+
+  StartupProfile()
+    : m_start(clock::now()),
+      m_phaseStart(m_start)
+  {}
+
+  void EndPhase(const char* name){
+    const auto now = clock::now();
+    m_phases.emplace_back(name, Milliseconds(m_phaseStart, now));
+    m_phaseStart = now;
+  }
+
+  void Print() const{
+    for (const auto& phase : m_phases){
+      console_message(wxString::Format("%-20s %8.1f ms",
+        phase.first, phase.second));
+    }
+    console_message(wxString::Format("%-20s %8.1f ms", "total",
+      Milliseconds(m_start, m_phaseStart)));
+  }
+
+private:
+  static double Milliseconds(clock::time_point t0, clock::time_point t1){
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+  }
+
+  clock::time_point m_start;
+  clock::time_point m_phaseStart;
+  std::vector<std::pair<const char*, double>> m_phases;
+};
+
 class Application : public wxApp{
 public:
   Application()
@@ -250,6 +294,7 @@ public:
     m_cmd.silentMode = parser.Found("s");
     m_cmd.forceNew = parser.Found("i");
     m_cmd.preventServer = parser.Found("ii");
+    m_cmd.startupProfile = parser.Found("startup-profile");
     m_cmd.port = get_string(parser, "port", get_default_faint_port());
     m_cmd.arg = get_string(parser, "arg", "");
     utf8_string scriptPath = get_string(parser, "run");
@@ -316,12 +361,16 @@ public:
     if (!m_faintInstance->AllowStart()){
       return false;
     }
+    m_profile.EndPhase("instance");
 
     wxInitAllImageHandlers();
     m_art.SetRoot(get_data_dir().SubDir("graphics"));
     load_faint_resources(m_art);
+    m_art.LoadPending();
+    m_profile.EndPhase("resources");
 
-    // Create frames and restore their states from the last run
+    // The frames are created, and their states restored from the
+    // last run, when first shown.
     m_interpreterFrame = std::make_unique<InterpreterFrame>();
     m_interpreterFrame->SetIcons(get_icon(m_art, Icon::FAINT_PYTHON16),
       get_icon(m_art, Icon::FAINT_PYTHON32));
@@ -341,6 +390,7 @@ public:
     m_appContext.reset(&(m_faintWindow->GetAppContext()));
 
     m_pythonContext.reset(&(m_faintWindow->GetPythonContext()));
+    m_profile.EndPhase("main window");
 
     bool ok = init_python(m_cmd.arg);
     if (!ok){
@@ -350,12 +400,14 @@ public:
       // Must the frame be deleted on error if before SetTopWindow?
       return false;
     }
+    m_profile.EndPhase("python");
 
     if (!m_cmd.silentMode){
       m_faintWindow->Show();
     }
 
     m_faintWindow->Initialize();
+    m_profile.EndPhase("show");
 
     bool configOk = run_python_user_config(*m_pythonContext);
     if (!configOk){
@@ -369,9 +421,16 @@ public:
       }
     }
     m_interpreterFrame->AddNames(list_ifaint_names());
+    m_profile.EndPhase("user config");
+
     if (!m_cmd.files.empty()){
       m_faintWindow->Open(m_cmd.files);
     }
+    m_profile.EndPhase("open files");
+
+    if (m_cmd.startupProfile){
+      m_profile.Print();
+    }
 
     SetTopWindow(&m_faintWindow->GetRawFrame());
     return true;
@@ -438,6 +497,7 @@ private:
   std::unique_ptr<InterpreterFrame> m_interpreterFrame;
   std::unique_ptr<PythonContext> m_pythonContext;
   Optional<FilePath> m_crashFile;
+  StartupProfile m_profile;
 };
 
 } // namespace
@@ -33,6 +33,7 @@ class Grid;
 class Image;
 class Index;
 class IntPoint;
+class IntRect;
 class IntSize;
 class Object;
 class Point;
@@ -101,6 +102,8 @@ public:
   virtual Point GetRelativeMousePos() = 0;
   virtual IntPoint GetScrollPos() = 0;
   virtual Index GetSelectedFrame() const = 0;
+  // The part of the image visible in the canvas window
+  virtual IntRect GetVisibleImageRect() const = 0;
   virtual IntSize GetSize() const = 0;
   virtual ToolInterface& GetTool() = 0;
   virtual const ToolInterface& GetTool() const = 0;
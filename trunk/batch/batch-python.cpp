@@ -0,0 +1,94 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include "python/py-include.hh"
+#include "batch/batch-python.hh"
+#include "bitmap/bitmap.hh"
+#include "python/py-bitmap.hh"
+#include "python/py-exception.hh"
+#include "python/py-initialize-ifaint.hh"
+#include "python/py-interface.hh"
+#include "python/py-parse.hh"
+#include "python/py-util.hh"
+
+namespace faint{
+
+class ScopedGIL{
+  // Holds the global interpreter lock for the calling thread.
+public:
+  ScopedGIL()
+    : m_state(PyGILState_Ensure())
+  {}
+
+  ~ScopedGIL(){
+    PyGILState_Release(m_state);
+  }
+
+  ScopedGIL(const ScopedGIL&) = delete;
+  ScopedGIL& operator=(const ScopedGIL&) = delete;
+private:
+  PyGILState_STATE m_state;
+};
+
+static OrError<Bitmap> call_process(PyObject* process, const Bitmap& bmp){
+  ScopedGIL gil;
+  scoped_ref pyBmp(build_result(bmp));
+  if (pyBmp == nullptr){
+    return format_error_info(py_error_info());
+  }
+
+  scoped_ref result(PyObject_CallFunctionObjArgs(process, pyBmp.get(),
+    nullptr));
+  if (result == nullptr){
+    return format_error_info(py_error_info());
+  }
+
+  PyObject* out = result.get() == Py_None ? pyBmp.get() : result.get();
+  if (PyObject_IsInstance(out, (PyObject*)&BitmapType) != 1){
+    PyErr_Clear();
+    return utf8_string("process returned neither a Bitmap nor None.");
+  }
+  return *((bitmapObject*)out)->bmp;
+}
+
+Either<batch_process_t, utf8_string> load_batch_script(const FilePath& path){
+  init_python_headless();
+#if PY_VERSION_HEX < 0x03070000
+  PyEval_InitThreads();
+#endif
+
+  Optional<FaintPyExc> err = run_python_file(path);
+  if (err.IsSet()){
+    return format_error_info(err.Get());
+  }
+
+  scoped_ref module(PyImport_ImportModule("__main__"));
+  scoped_ref func(PyObject_GetAttrString(module.get(), "process"));
+  if (func == nullptr || PyCallable_Check(func.get()) == 0){
+    PyErr_Clear();
+    return utf8_string("The script does not define a function "
+      "process(bitmap).");
+  }
+
+  // Kept for the remaining lifetime of the interpreter
+  PyObject* process = func.release();
+  PyEval_SaveThread();
+
+  return batch_process_t([process](const Bitmap& bmp){
+    return call_process(process, bmp);
+  });
+}
+
+} // namespace
@@ -0,0 +1,38 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FAINT_BATCH_PYTHON_HH
+#define FAINT_BATCH_PYTHON_HH
+#include "batch/batch.hh"
+
+namespace faint{
+
+// Initializes Python with the ifaint module and runs the script,
+// which must define a function process(bitmap). Returns a function
+// which calls it for each image, or a description of why the script
+// could not be used.
+//
+// The process function receives an ifaint.Bitmap and should return
+// the Bitmap to save, or None to save the received Bitmap as modified
+// in place.
+//
+// The main thread releases the global interpreter lock when this
+// returns, so the Python calls from concurrent workers are
+// serialized, while loading and saving is not.
+Either<batch_process_t, utf8_string> load_batch_script(const FilePath&);
+
+} // namespace
+
+#endif
@@ -0,0 +1,203 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include "batch/batch.hh"
+#include "bitmap/bitmap.hh"
+#include "formats/bmp/file-bmp.hh"
+#include "formats/wx/file-image-wx.hh"
+#include "text/char-constants.hh"
+#include "text/formatting.hh"
+#include "util/image-props.hh"
+#include "util/image-util.hh"
+#include "util/image.hh"
+
+namespace faint{
+
+using clock = std::chrono::steady_clock;
+
+static double milliseconds_since(clock::time_point t0){
+  return std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+}
+
+BatchOptions::BatchOptions(const DirPath& outDir, int numJobs)
+  : outDir(outDir),
+    numJobs(numJobs)
+{}
+
+BatchResult::BatchResult()
+  : loadMs(0.0),
+    processMs(0.0),
+    saveMs(0.0)
+{}
+
+OrError<Bitmap> load_flattened(const Formats& formats, const FilePath& path){
+  Format* format = get_load_format(formats, path.Extension());
+  if (format == nullptr){
+    return space_sep("Unsupported file format:",
+      quoted(path.Extension().Str()));
+  }
+
+  ImageProps props;
+  format->Load(path, props);
+  if (!props.IsOk()){
+    return props.GetError();
+  }
+  if (props.GetNumFrames() == 0){
+    return utf8_string("No image in file.");
+  }
+
+  const Image image(std::move(props.GetFrame(0_idx)));
+  return flatten(image);
+}
+
+SaveResult save_bitmap(const Bitmap& bmp, const FilePath& path){
+  const FileExtension ext(path.Extension());
+  if (ext == FileExtension("png")){
+    return write_image_wx(bmp, wxBITMAP_TYPE_PNG, path);
+  }
+  else if (ext == FileExtension("jpg") || ext == FileExtension("jpeg")){
+    return write_image_wx(bmp, wxBITMAP_TYPE_JPEG, path);
+  }
+  else if (ext == FileExtension("bmp")){
+    return write_bmp(path, bmp, BitmapQuality::COLOR_24BIT);
+  }
+  return SaveResult::SaveFailed(space_sep("Unsupported output format:",
+    quoted(ext.Str())));
+}
+
+static utf8_string file_name_without_extension(const FilePath& path){
+  const utf8_string name(path.StripPath().Str());
+  const size_t dot = name.rfind(full_stop);
+  return dot == utf8_string::npos ?
+    name : name.substr(0, dot);
+}
+
+FilePath batch_output_path(const FilePath& path, const BatchOptions& options){
+  const FileExtension ext(options.extension.Or(path.Extension()));
+  return options.outDir.File(
+    file_name_without_extension(path) + "." + ext.Str());
+}
+
+static BatchResult process_file(const Formats& formats,
+  const FilePath& path,
+  const FilePath& outPath,
+  const batch_process_t& process)
+{
+  BatchResult result;
+  result.file = path.Str();
+
+  auto t0 = clock::now();
+  OrError<Bitmap> loaded(load_flattened(formats, path));
+  result.loadMs = milliseconds_since(t0);
+  if (loaded.Get<utf8_string>().IsSet()){
+    result.error.Set(loaded.Expect<utf8_string>());
+    return result;
+  }
+
+  t0 = clock::now();
+  OrError<Bitmap> processed(process(loaded.Expect<Bitmap>()));
+  result.processMs = milliseconds_since(t0);
+  if (processed.Get<utf8_string>().IsSet()){
+    result.error.Set(processed.Expect<utf8_string>());
+    return result;
+  }
+
+  t0 = clock::now();
+  SaveResult saved(save_bitmap(processed.Expect<Bitmap>(), outPath));
+  result.saveMs = milliseconds_since(t0);
+  if (saved.Failed()){
+    result.error.Set(saved.ErrorDescription());
+  }
+  return result;
+}
+
+std::vector<BatchResult> run_batch(const FileList& files,
+  const BatchOptions& options,
+  const batch_process_t& process)
+{
+  const Formats formats(built_in_file_formats());
+  std::vector<BatchResult> results(files.size());
+
+  // A file with the same output path as an earlier file is not
+  // processed, since the workers would write the output concurrently
+  // and one would overwrite the other.
+  std::vector<FilePath> outPaths;
+  std::vector<bool> skipped(files.size(), false);
+  std::map<utf8_string, size_t> firstWithOutput;
+  for (size_t i = 0; i != files.size(); i++){
+    outPaths.push_back(batch_output_path(files[i], options));
+    const utf8_string outPath(outPaths.back().Str());
+    auto inserted = firstWithOutput.insert(std::make_pair(outPath, i));
+    if (!inserted.second){
+      skipped[i] = true;
+      results[i].file = files[i].Str();
+      results[i].error.Set(space_sep("Output file", quoted(outPath),
+        "is already written for", quoted(files[inserted.first->second].Str())));
+    }
+  }
+
+  // Each worker claims the next unprocessed file until none remain,
+  // so that a few large images do not leave the other workers idle.
+  std::atomic<size_t> next(0);
+  auto work = [&](){
+    for (size_t i = next++; i < files.size(); i = next++){
+      if (!skipped[i]){
+        results[i] = process_file(formats, files[i], outPaths[i], process);
+      }
+    }
+  };
+
+  const int numThreads = std::max(1,
+    std::min(options.numJobs, static_cast<int>(files.size())));
+
+  std::vector<std::thread> threads;
+  for (int i = 1; i < numThreads; i++){
+    threads.emplace_back(work);
+  }
+  work();
+  for (auto& t : threads){
+    t.join();
+  }
+
+  for (Format* f : formats){
+    delete f;
+  }
+  return results;
+}
+
+utf8_string timing_report(const std::vector<BatchResult>& results){
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(1);
+  ss << "file\tload_ms\tprocess_ms\tsave_ms\ttotal_ms\tstatus\n";
+  for (const auto& r : results){
+    ss << r.file.str() << "\t" <<
+      r.loadMs << "\t" <<
+      r.processMs << "\t" <<
+      r.saveMs << "\t" <<
+      r.loadMs + r.processMs + r.saveMs << "\t" <<
+      r.error.Or(utf8_string("ok")).str() << "\n";
+  }
+  return utf8_string(ss.str());
+}
+
+} // namespace
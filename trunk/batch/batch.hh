@@ -0,0 +1,88 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FAINT_BATCH_HH
+#define FAINT_BATCH_HH
+#include <functional>
+#include <vector>
+#include "formats/save-result.hh"
+#include "util/optional.hh"
+#include "util/or-error.hh"
+#include "util-wx/file-path.hh"
+#include "util-wx/file-format-util.hh"
+
+namespace faint{
+
+class Bitmap;
+
+// Applied to each loaded image before it is saved. Called
+// concurrently from the worker threads.
+using batch_process_t = std::function<OrError<Bitmap>(const Bitmap&)>;
+
+class BatchOptions{
+public:
+  BatchOptions(const DirPath& outDir, int numJobs);
+
+  // The folder the processed images are written to
+  DirPath outDir;
+
+  // The extension (and thereby format) of the saved images. The
+  // extension of each input file is kept if not set.
+  Optional<FileExtension> extension;
+
+  // The number of files processed concurrently
+  int numJobs;
+};
+
+class BatchResult{
+public:
+  BatchResult();
+
+  utf8_string file;
+  Optional<utf8_string> error;
+  double loadMs;
+  double processMs;
+  double saveMs;
+};
+
+// Loads the first frame of the image at the path, with any objects
+// rendered onto the background.
+OrError<Bitmap> load_flattened(const Formats&, const FilePath&);
+
+// Saves the bitmap in the format determined by the extension of the
+// path. Supports the built in raster formats with a single frame
+// (png, jpg, bmp).
+SaveResult save_bitmap(const Bitmap&, const FilePath&);
+
+// Returns the path in the output folder which run_batch saves the
+// processed file to.
+FilePath batch_output_path(const FilePath&, const BatchOptions&);
+
+// Loads each file, passes it through the process function and saves
+// the result in the output folder under the same name. Processes
+// up to numJobs files at a time. The results are in the order of the
+// files. A file with the same output path as an earlier file (e.g.
+// the same name in another folder) is not processed, but gets an
+// error.
+std::vector<BatchResult> run_batch(const FileList&, const BatchOptions&,
+  const batch_process_t&);
+
+// A tab-separated report with the times spent loading, processing
+// and saving each file.
+utf8_string timing_report(const std::vector<BatchResult>&);
+
+} // namespace
+
+#endif
@@ -0,0 +1,184 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <algorithm>
+#include <fstream>
+#include <thread>
+#include "wx/cmdline.h"
+#include "wx/filename.h"
+#include "wx/image.h"
+#include "wx/init.h"
+#include "batch/batch-python.hh"
+#include "batch/batch.hh"
+#include "bitmap/bitmap.hh"
+#include "text/formatting.hh"
+#include "util-wx/convert-wx.hh"
+#include "util-wx/gui-util.hh"
+
+// faint-batch: Applies a Python script to image files and saves the
+// results, without creating any windows. For example:
+//
+//   faint-batch --out=out --run=blur.py --format=png *.jpg
+//
+// where blur.py contains:
+//
+//   def process(bmp):
+//       bmp.gaussian_blur(2.0)
+
+namespace faint{
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+  {wxCMD_LINE_SWITCH, "h", "help",
+    "Displays help on the command line parameters",
+   wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP},
+
+  {wxCMD_LINE_OPTION, "o", "out",
+   "Folder for the processed images",
+   wxCMD_LINE_VAL_STRING, wxCMD_LINE_OPTION_MANDATORY},
+
+  {wxCMD_LINE_OPTION, "", "run",
+   "Python script defining process(bitmap), called for each image",
+   wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL},
+
+  {wxCMD_LINE_OPTION, "f", "format",
+   "Extension of the saved images (png, jpg or bmp). "
+   "Defaults to the extension of each input file.",
+   wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL},
+
+  {wxCMD_LINE_OPTION, "j", "jobs",
+   "Number of images processed concurrently. Defaults to one per core.",
+   wxCMD_LINE_VAL_NUMBER, wxCMD_LINE_PARAM_OPTIONAL},
+
+  {wxCMD_LINE_OPTION, "", "report",
+   "Write the per-file timing report to this file instead of stdout",
+   wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL},
+
+  {wxCMD_LINE_PARAM, "", "", "Image files", wxCMD_LINE_VAL_STRING,
+   wxCMD_LINE_PARAM_MULTIPLE},
+
+  {wxCMD_LINE_NONE, "", "", "",
+   wxCMD_LINE_VAL_NONE, wxCMD_LINE_PARAM_OPTIONAL} // Sentinel
+};
+
+static int default_num_jobs(){
+  return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+static Optional<DirPath> get_out_dir(const wxCmdLineParser& parser){
+  wxString str;
+  parser.Found("out", &str);
+  wxFileName dirName(wxFileName::DirName(str));
+  dirName.MakeAbsolute();
+  const DirPath dir(dirName.GetFullPath());
+  if (!exists(dir) && !make_dir(dir)){
+    return no_option();
+  }
+  return option(dir);
+}
+
+static int run(int argc, char** argv){
+  wxCmdLineParser parser(g_cmdLineDesc, argc, argv);
+  const int parseResult = parser.Parse();
+  if (parseResult != 0){
+    // Help (-1) or an invalid command line, reported by the parser.
+    return parseResult == -1 ? 0 : 1;
+  }
+
+  wxInitAllImageHandlers();
+
+  Optional<DirPath> outDir = get_out_dir(parser);
+  if (outDir.NotSet()){
+    console_message("Error: Failed creating the output folder.");
+    return 1;
+  }
+
+  long numJobs = default_num_jobs();
+  parser.Found("jobs", &numJobs);
+  BatchOptions options(outDir.Get(), static_cast<int>(numJobs));
+
+  wxString format;
+  if (parser.Found("format", &format)){
+    options.extension.Set(FileExtension(format));
+  }
+
+  FileList files;
+  for (size_t i = 0; i != parser.GetParamCount(); i++){
+    wxFileName absPath(absoluted(wxFileName(parser.GetParam(i))));
+    if (absPath.IsDir()){
+      console_message(wxString("Error: Folder path specified on command "
+        "line - image path expected (") + parser.GetParam(i) + ").");
+      return 1;
+    }
+    files.push_back(FilePath::FromAbsoluteWx(absPath));
+  }
+
+  batch_process_t process = [](const Bitmap& bmp){
+    return OrError<Bitmap>(bmp);
+  };
+
+  wxString scriptPath;
+  if (parser.Found("run", &scriptPath)){
+    auto script = make_absolute_file_path(to_faint(scriptPath));
+    if (script.NotSet()){
+      console_message("Error: Invalid script path " + scriptPath);
+      return 1;
+    }
+    bool ok = load_batch_script(script.Get()).Visit(
+      [&](const batch_process_t& scriptProcess){
+        process = scriptProcess;
+        return true;
+      },
+      [&](const utf8_string& error){
+        console_message(to_wx(space_sep("Error in",
+          quoted(script.Get().Str()) + ":\n" + error)));
+        return false;
+      });
+    if (!ok){
+      return 1;
+    }
+  }
+
+  const std::vector<BatchResult> results = run_batch(files, options,
+    process);
+
+  const utf8_string report = timing_report(results);
+  wxString reportPath;
+  if (parser.Found("report", &reportPath)){
+    std::ofstream f(iostream_friendly(
+      FilePath::FromAbsoluteWx(absoluted(wxFileName(reportPath)))));
+    f << report.str();
+  }
+  else{
+    console_message(to_wx(report));
+  }
+
+  const bool failed = std::any_of(begin(results), end(results),
+    [](const BatchResult& r){
+      return r.error.IsSet();
+    });
+  return failed ? 2 : 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv){
+  // Initializes wxWidgets without an application object, for the
+  // string, file name and image handling.
+  wxInitializer initializer(argc, argv);
+  if (!initializer.IsOk()){
+    return 1;
+  }
+  return faint::run(argc, argv);
+}
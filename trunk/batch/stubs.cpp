@@ -0,0 +1,44 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include "python/py-include.hh"
+#include "python/py-function-error.hh"
+
+// The batch runner has no application, windows or interpreter
+// console. Python functions which require them raise RuntimeError.
+
+namespace faint{
+class AppContext;
+class ArtContainer;
+class PythonContext;
+
+static PythonError no_application(){
+  return PythonError(PyExc_RuntimeError,
+    "Not available in faint-batch (requires the Faint application).");
+}
+
+AppContext& get_app_context(){
+  throw no_application();
+}
+
+const ArtContainer& get_art_container(){
+  throw no_application();
+}
+
+PythonContext& get_python_context(){
+  throw no_application();
+}
+
+} // namespace
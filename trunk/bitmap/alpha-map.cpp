@@ -16,6 +16,8 @@
 #include <algorithm>
 #include <cassert>
 #include <cstring> // memcpy
+#include <utility>
+#include <vector>
 #include "bitmap/alpha-map.hh"
 #include "bitmap/brush.hh"
 #include "geo/int-point.hh"
@@ -24,135 +26,249 @@
 
 namespace faint{
 
+// Tiles are tile_size x tile_size values, stored row by row
+static const int tile_shift = 6;
+static const int tile_size = 1 << tile_shift;
+static const int tile_mask = tile_size - 1;
+static const size_t tile_bytes = tile_size * tile_size;
+
 inline bool valid_pos(int x, int y, const IntSize& size){
   return 0 <= x && x < size.w && 0 <= y && y < size.h;
 }
 
-inline int to_index(int x, int y, int stride){
-  return x + y * stride;
+inline int to_index(int x, int y){
+  // Index of x,y within its tile
+  return (x & tile_mask) + (y & tile_mask) * tile_size;
+}
+
+static int tiles_for(int length){
+  return (length + tile_size - 1) >> tile_shift;
 }
 
-AlphaMapRef::AlphaMapRef(const uchar* data, const IntSize& size, int stride)
-  : m_data(data),
-    m_size(size),
-    m_stride(stride)
+AlphaMapRef::AlphaMapRef(const AlphaMap& map, const IntRect& region)
+  : m_map(map),
+    m_region(region)
 {}
 
 uchar AlphaMapRef::Get(int x, int y) const{
-  return m_data[to_index(x,y,m_stride)];
+  return m_map.Get(x + m_region.x, y + m_region.y);
 }
 
 IntSize AlphaMapRef::GetSize() const{
-  return m_size;
+  return m_region.GetSize();
 }
 
 Optional<IntRect> AlphaMapRef::BoundingRect() const{
-  int minX = m_size.w;
-  int minY = m_size.h;
+  int minX = m_region.w;
+  int minY = m_region.h;
   int maxX = 0;
   int maxY = 0;
-  for (int y = 0; y != m_size.h; y++){
-    for (int x = 0; x != m_size.w; x++){
-      if (Get(x,y) != 0){
-        minX = std::min(minX, x);
-        minY = std::min(minY, y);
-        maxX = std::max(maxX, x);
-        maxY = std::max(maxY, y);
+  VisitTiles([&](const IntRect& r, const uchar* values, int stride){
+    for (int y = 0; y != r.h; y++){
+      const uchar* row = values + y * stride;
+      const uchar* first = std::find_if(row, row + r.w,
+        [](uchar v){return v != 0;});
+      if (first == row + r.w){
+        continue;
+      }
+      const uchar* last = row + r.w - 1;
+      while (*last == 0){
+        last--;
       }
+      minX = std::min(minX, r.x + static_cast<int>(first - row));
+      maxX = std::max(maxX, r.x + static_cast<int>(last - row));
+      minY = std::min(minY, r.y + y);
+      maxY = std::max(maxY, r.y + y);
     }
-  }
+  });
+
   if (minX <= maxX && minY <= maxY){
     return IntRect(IntPoint(minX, minY), IntPoint(maxX, maxY));
   }
   return {};
 }
 
+void AlphaMapRef::VisitTiles(const alpha_tile_func_t& func) const{
+  if (empty(m_region)){
+    return;
+  }
 
-AlphaMap::AlphaMap(const IntSize& sz)
-  : m_data(nullptr),
-    m_stride(0)
-{
+  const int tx0 = m_region.x >> tile_shift;
+  const int ty0 = m_region.y >> tile_shift;
+  const int tx1 = (m_region.x + m_region.w - 1) >> tile_shift;
+  const int ty1 = (m_region.y + m_region.h - 1) >> tile_shift;
+  for (int ty = ty0; ty <= ty1; ty++){
+    for (int tx = tx0; tx <= tx1; tx++){
+      const uchar* tile = m_map.GetTile(tx, ty);
+      if (tile == nullptr){
+        continue;
+      }
+
+      const IntRect r(intersection(m_region,
+        IntRect(IntPoint(tx << tile_shift, ty << tile_shift),
+          IntSize(tile_size, tile_size))));
+      func(translated(r, -m_region.TopLeft()),
+        tile + to_index(r.x, r.y), tile_size);
+    }
+  }
+}
+
+AlphaMap::AlphaMap(const IntSize& sz){
   Initialize(sz);
 }
 
-AlphaMap::AlphaMap(const AlphaMap& other)
-  : m_size(other.m_size),
-    m_stride(other.m_stride)
+AlphaMap::AlphaMap(const AlphaMap& other){
+  Initialize(other.m_size);
+  const int numTiles = area(m_numTiles);
+  for (int i = 0; i != numTiles; i++){
+    const uchar* tile = other.m_tiles[i].load(std::memory_order_acquire);
+    if (tile != nullptr){
+      uchar* copy = new uchar[tile_bytes];
+      memcpy(copy, tile, tile_bytes);
+      m_tiles[i].store(copy, std::memory_order_relaxed);
+    }
+  }
+}
+
+AlphaMap::AlphaMap(AlphaMap&& other)
+  : m_tiles(std::move(other.m_tiles)),
+    m_size(other.m_size),
+    m_numTiles(other.m_numTiles)
 {
-  assert(m_size.w > 0 && m_size.h > 0);
-  size_t length = to_size_t(area(m_size));
-  m_data = new uchar[length];
-  memcpy(m_data, other.m_data, length);
+  other.m_size = IntSize(0, 0);
+  other.m_numTiles = IntSize(0, 0);
 }
 
 AlphaMap::~AlphaMap(){
-  delete[] m_data;
+  Clear();
 }
 
 void AlphaMap::Add(int x, int y, uchar value){
-  uchar& item = m_data[to_index(x, y, m_stride)];
+  if (value == 0){
+    // Avoid allocating a tile for nothing
+    return;
+  }
+  uchar& item = GetOrCreateTile(x >> tile_shift, y >> tile_shift)
+    [to_index(x, y)];
   item = static_cast<uchar>(std::min(int(item) + value, 255));
 }
 
 void AlphaMap::Set(int x, int y, uchar value){
-  if (valid_pos(x, y, m_size)){
-    m_data[to_index(x, y, m_stride)] = value;
+  if (!valid_pos(x, y, m_size)){
+    return;
+  }
+
+  uchar* tile = value == 0 ?
+    GetTile(x >> tile_shift, y >> tile_shift) :
+    GetOrCreateTile(x >> tile_shift, y >> tile_shift);
+  if (tile != nullptr){
+    tile[to_index(x, y)] = value;
+  }
+}
+
+void AlphaMap::SetSpan(int x, int y, int count, uchar value){
+  if (y < 0 || m_size.h <= y){
+    return;
+  }
+
+  const int xEnd = std::min(x + count, m_size.w);
+  x = std::max(x, 0);
+  while (x < xEnd){
+    // Set the part of the span within one tile
+    const int n = std::min(xEnd, (x | tile_mask) + 1) - x;
+    uchar* tile = value == 0 ?
+      GetTile(x >> tile_shift, y >> tile_shift) :
+      GetOrCreateTile(x >> tile_shift, y >> tile_shift);
+    if (tile != nullptr){
+      memset(tile + to_index(x, y), value, to_size_t(n));
+    }
+    x += n;
   }
 }
 
 void AlphaMap::Clear(){
-  memset(m_data, 0, to_size_t(area(m_size)));
+  const int numTiles = area(m_numTiles);
+  for (int i = 0; i != numTiles; i++){
+    delete[] m_tiles[i].exchange(nullptr);
+  }
 }
 
 AlphaMapRef AlphaMap::FullReference() const{
-  return AlphaMapRef(m_data, m_size, m_stride);
+  return AlphaMapRef(*this, IntRect(IntPoint(0, 0), m_size));
 }
 
 uchar AlphaMap::Get(int x, int y) const {
-  return m_data[to_index(x,y, m_stride)];
+  const uchar* tile = GetTile(x >> tile_shift, y >> tile_shift);
+  return tile == nullptr ? 0 : tile[to_index(x, y)];
 }
 
-uchar* AlphaMap::GetRaw(){
-  return m_data;
+IntSize AlphaMap::GetSize() const{
+  return m_size;
 }
 
-const uchar* AlphaMap::GetRaw() const{
-  return m_data;
+uchar* AlphaMap::GetTile(int tileX, int tileY) const{
+  return m_tiles[tileX + tileY * m_numTiles.w].load(
+    std::memory_order_acquire);
 }
 
-IntSize AlphaMap::GetSize() const{
-  return m_size;
+uchar* AlphaMap::GetOrCreateTile(int tileX, int tileY){
+  std::atomic<uchar*>& slot = m_tiles[tileX + tileY * m_numTiles.w];
+  uchar* tile = slot.load(std::memory_order_acquire);
+  if (tile != nullptr){
+    return tile;
+  }
+
+  // Another thread may create the same tile concurrently, in which
+  // case the first one stored is used.
+  uchar* created = new uchar[tile_bytes]();
+  if (slot.compare_exchange_strong(tile, created,
+    std::memory_order_acq_rel, std::memory_order_acquire))
+  {
+    return created;
+  }
+  delete[] created;
+  return tile;
 }
 
 void AlphaMap::Initialize(const IntSize& sz){
   assert(sz.w > 0 && sz.h > 0);
   m_size = sz;
-  m_data = new uchar[to_size_t(area(m_size))];
-  m_stride = sz.w;
-  Clear();
+  m_numTiles = IntSize(tiles_for(sz.w), tiles_for(sz.h));
+  const int numTiles = area(m_numTiles);
+  m_tiles.reset(new std::atomic<uchar*>[to_size_t(numTiles)]);
+  for (int i = 0; i != numTiles; i++){
+    m_tiles[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+int AlphaMap::NumTiles() const{
+  const int numTiles = area(m_numTiles);
+  int count = 0;
+  for (int i = 0; i != numTiles; i++){
+    if (m_tiles[i].load(std::memory_order_acquire) != nullptr){
+      count++;
+    }
+  }
+  return count;
 }
 
 void AlphaMap::Reset(const IntSize& size){
+  Clear();
   if (GetSize() != size){
-    delete[] m_data;
     Initialize(size);
   }
-  else{
-    Clear();
-  }
 }
 
 AlphaMap AlphaMap::SubCopy(const IntRect& r) const{
-  assert(0 <= r.x && 0 <= r.y &&
-    r.x + r.w <= m_size.w &&
-    r.y + r.h <= m_size.h);
-
   AlphaMap a(r.GetSize());
-  for (int y = 0; y != r.h; y++){
-    for (int x = 0; x != r.w; x++){
-      a.Set(x,y,Get(x + r.x,y + r.y));
-    }
-  }
+  SubReference(r).VisitTiles(
+    [&](const IntRect& tileRect, const uchar* values, int stride){
+      for (int y = 0; y != tileRect.h; y++){
+        for (int x = 0; x != tileRect.w; x++){
+          a.Set(tileRect.x + x, tileRect.y + y, values[y * stride + x]);
+        }
+      }
+    });
   return a;
 }
 
@@ -160,8 +276,7 @@ AlphaMapRef AlphaMap::SubReference(const IntRect& r) const{
   assert(0 <= r.x && 0 <= r.y &&
     r.x + r.w <= m_size.w &&
     r.y + r.h <= m_size.h);
-  return AlphaMapRef(m_data +
-    to_index(r.x, r.y, m_stride), r.GetSize(), m_stride);
+  return AlphaMapRef(*this, r);
 }
 
 static void brush_stroke(AlphaMap& data, int x, int y, const Brush& b){
@@ -186,12 +301,35 @@ static int int_abs(int v){
   return v < 0 ? -v : v;
 }
 
+class LineRun{
+  // Horizontally adjacent positions [x0, x1] on row y of a line
+public:
+  int y;
+  int x0;
+  int x1;
+};
+
+static bool opaque(const Brush& b){
+  // True if the brush values are all either 0 or 255
+  const IntSize sz(b.GetSize());
+  for (int y = 0; y != sz.h; y++){
+    for (int x = 0; x != sz.w; x++){
+      const uchar v = b.Get(x, y);
+      if (v != 0 && v != 255){
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 using std::swap;
-void stroke(AlphaMap& data, const UpperLeft& p0, const UpperLeft& p1,
-  const Brush& b)
+static std::vector<LineRun> line_runs(const UpperLeft& p0,
+  const UpperLeft& p1)
 {
-
-int x0 = p0.Get().x;
+  // The positions of a Bresenham line from p0 to p1, grouped into
+  // horizontal runs.
+  int x0 = p0.Get().x;
   int y0 = p0.Get().y;
   int x1 = p1.Get().x;
   int y1 = p1.Get().y;
@@ -205,6 +343,17 @@ int x0 = p0.Get().x;
     swap(y0, y1);
   }
 
+  std::vector<LineRun> runs;
+  auto add = [&runs](int x, int y){
+    if (!runs.empty() && runs.back().y == y){
+      runs.back().x0 = std::min(runs.back().x0, x);
+      runs.back().x1 = std::max(runs.back().x1, x);
+    }
+    else{
+      runs.push_back({y, x, x});
+    }
+  };
+
   int dx = x1 - x0;
   int dy = int_abs(y1 - y0);
   int err = 0;
@@ -213,10 +362,10 @@ int x0 = p0.Get().x;
   for (int x = x0; x <= x1; x++){
     err += dy;
     if (steep){
-      brush_stroke(data, y, x, b);
+      add(y, x);
     }
     else {
-      brush_stroke(data, x, y, b);
+      add(x, y);
     }
 
     if (2 * err > dx){
@@ -224,6 +373,84 @@ int x0 = p0.Get().x;
       err -= dx;
     }
   }
+  return runs;
+}
+
+static void fill_swept_brush(AlphaMap& data,
+  const std::vector<LineRun>& runs,
+  const Brush& b)
+{
+  // Fills the region covered by the opaque brush swept along the
+  // runs (a capsule for a round brush), as merged spans per row,
+  // instead of stamping the brush at each position.
+  const IntSize brushSize(b.GetSize());
+
+  // The opaque spans [x0, x1) of each brush row
+  std::vector<LineRun> brushSpans;
+  for (int y = 0; y != brushSize.h; y++){
+    for (int x = 0; x != brushSize.w; x++){
+      if (b.Get(x, y) != 0){
+        const int x0 = x;
+        while (x != brushSize.w && b.Get(x, y) != 0){
+          x++;
+        }
+        brushSpans.push_back({y, x0, x});
+        if (x == brushSize.w){
+          break;
+        }
+      }
+    }
+  }
+
+  int top = runs.front().y;
+  int bottom = runs.front().y;
+  for (const LineRun& run : runs){
+    top = std::min(top, run.y);
+    bottom = std::max(bottom, run.y);
+  }
+
+  using span_t = std::pair<int, int>;
+  std::vector<std::vector<span_t>> rows(
+    to_size_t(bottom - top + brushSize.h));
+  for (const LineRun& run : runs){
+    for (const LineRun& span : brushSpans){
+      rows[to_size_t(run.y + span.y - top)].emplace_back(
+        run.x0 + span.x0, run.x1 + span.x1);
+    }
+  }
+
+  for (size_t i = 0; i != rows.size(); i++){
+    std::vector<span_t>& spans = rows[i];
+    std::sort(spans.begin(), spans.end());
+    const int y = top + static_cast<int>(i);
+    size_t j = 0;
+    while (j != spans.size()){
+      const int x0 = spans[j].first;
+      int x1 = spans[j].second;
+      for (j++; j != spans.size() && spans[j].first <= x1; j++){
+        x1 = std::max(x1, spans[j].second);
+      }
+      data.SetSpan(x0, y, x1 - x0, 255);
+    }
+  }
+}
+
+void stroke(AlphaMap& data, const UpperLeft& p0, const UpperLeft& p1,
+  const Brush& b)
+{
+  const std::vector<LineRun> runs = line_runs(p0, p1);
+  if (opaque(b)){
+    // Adding an opaque brush saturates, so the union of the brush
+    // positions gives the same result as stamping
+    fill_swept_brush(data, runs, b);
+    return;
+  }
+
+  for (const LineRun& run : runs){
+    for (int x = run.x0; x <= run.x1; x++){
+      brush_stroke(data, x, run.y, b);
+    }
+  }
 }
 
 } // namespace
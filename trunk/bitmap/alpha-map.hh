@@ -15,15 +15,24 @@
 
 #ifndef FAINT_ALPHA_MAP_HH
 #define FAINT_ALPHA_MAP_HH
+#include <atomic>
+#include <functional>
+#include <memory>
+#include "geo/int-rect.hh"
 #include "geo/int-size.hh"
 #include "util/distinct.hh"
 #include "util/optional.hh"
 
 namespace faint{
 
+class AlphaMap;
 class Brush;
 class IntPoint;
-class IntRect;
+
+// Receives a region of an AlphaMap(Ref), the value at its top-left
+// position and the stride between its rows.
+using alpha_tile_func_t = std::function<void(const IntRect&,
+  const uchar* values, int stride)>;
 
 class AlphaMapRef{
   // View of a sub-region in an AlphaMap.
@@ -33,40 +42,57 @@ public:
 
   // Returns the rectangle surrounding >0 positions
   Optional<IntRect> BoundingRect() const;
+
+  // Calls the function for each allocated tile within the
+  // referenced region, with the region in reference coordinates. All
+  // values outside these regions are zero.
+  void VisitTiles(const alpha_tile_func_t&) const;
 private:
   friend class AlphaMap;
-  AlphaMapRef(const uchar*, const IntSize&, int);
-  const uchar* m_data;
-  IntSize m_size;
-  int m_stride;
+  AlphaMapRef(const AlphaMap&, const IntRect&);
+  const AlphaMap& m_map;
+  IntRect m_region;
 };
 
 class AlphaMap{
   // A "one-channel" Bitmap for alpha values and what not.
+  //
+  // The values are stored in square tiles, which are allocated when
+  // first given a non-zero value, so that a large map with few values
+  // set uses little memory. Different threads may modify disjoint
+  // positions concurrently.
 public:
   explicit AlphaMap(const IntSize&);
   AlphaMap(const AlphaMap&);
+  AlphaMap(AlphaMap&&);
   ~AlphaMap();
   void Add(int x, int y, uchar value);
   AlphaMapRef FullReference() const;
   uchar Get(int x, int y) const;
-  uchar* GetRaw();
-  const uchar* GetRaw() const;
   IntSize GetSize() const;
+
+  // The number of allocated tiles
+  int NumTiles() const;
   void Reset(const IntSize&);
   void Set(int x, int y, uchar value);
+
+  // Sets count values starting at x,y, clipped to the map.
+  void SetSpan(int x, int y, int count, uchar value);
+
   AlphaMapRef SubReference(const IntRect&) const;
   AlphaMap SubCopy(const IntRect&) const;
 
   AlphaMap& operator=(const AlphaMap&) = delete;
 private:
+  friend class AlphaMapRef;
   void Initialize(const IntSize&);
   void Clear();
-  uchar* m_data;
+  uchar* GetTile(int tileX, int tileY) const;
+  uchar* GetOrCreateTile(int tileX, int tileY);
+  std::unique_ptr<std::atomic<uchar*>[]> m_tiles;
   IntSize m_size;
-  int m_stride;
+  IntSize m_numTiles;
 };
-
 class category_alpha_map;
 using UpperLeft = Distinct<IntPoint, category_alpha_map, 0>;
 
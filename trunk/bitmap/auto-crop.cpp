@@ -14,11 +14,13 @@
 // permissions and limitations under the License.
 
 #include <algorithm>
+#include <cstdint>
 #include "bitmap/auto-crop.hh"
 #include "bitmap/bitmap.hh"
 #include "bitmap/color-counting.hh"
 #include "bitmap/color.hh"
 #include "bitmap/draw.hh"
+#include "bitmap/pixel-view.hh"
 #include "geo/geo-func.hh"
 #include "geo/int-rect.hh"
 #include "util/at-most.hh"
@@ -26,69 +28,131 @@
 
 namespace faint{
 
+// Pixels compared per block when scanning rows. The block compare
+// has no early exit, so that the compiler can vectorize it.
+static const int scan_block = 8;
+
+static const uchar* row_ptr(const Bitmap& bmp, int y){
+  return bmp.m_data + y * bmp.m_row_stride;
+}
+
+template<bool EQUAL>
+static bool is_sought(uint32_t pixel, uint32_t px){
+  return EQUAL ? pixel == px : pixel != px;
+}
+
+template<bool EQUAL>
+static bool block_has(const uchar* p, uint32_t px){
+  bool found = false;
+  for (int i = 0; i != scan_block; i++){
+    found |= is_sought<EQUAL>(load_pixel(p + i * BPP), px);
+  }
+  return found;
+}
+
+template<bool EQUAL>
+static int find_first(const uchar* row, int begin, int end, uint32_t px){
+  // Returns the first x in [begin, end) where the pixel is (EQUAL) or
+  // is not (!EQUAL) px, or end if there is none.
+  int x = begin;
+  while (end - x >= scan_block && !block_has<EQUAL>(row + x * BPP, px)){
+    x += scan_block;
+  }
+  for (; x != end; x++){
+    if (is_sought<EQUAL>(load_pixel(row + x * BPP), px)){
+      return x;
+    }
+  }
+  return end;
+}
+
+template<bool EQUAL>
+static int find_last(const uchar* row, int begin, int end, uint32_t px){
+  // Returns one past the last x in [begin, end) where the pixel is
+  // (EQUAL) or is not (!EQUAL) px, or begin if there is none.
+  int x = end;
+  while (x - begin >= scan_block &&
+    !block_has<EQUAL>(row + (x - scan_block) * BPP, px))
+  {
+    x -= scan_block;
+  }
+  for (; x != begin; x--){
+    if (is_sought<EQUAL>(load_pixel(row + (x - 1) * BPP), px)){
+      return x;
+    }
+  }
+  return begin;
+}
+
+static int first_differing(const uchar* row, int begin, int end,
+  uint32_t px)
+{
+  return find_first<false>(row, begin, end, px);
+}
+
+static int last_differing(const uchar* row, int begin, int end,
+  uint32_t px)
+{
+  return find_last<false>(row, begin, end, px);
+}
+
+static int first_equal(const uchar* row, int begin, int end, uint32_t px){
+  return find_first<true>(row, begin, end, px);
+}
+
+static int last_equal(const uchar* row, int begin, int end, uint32_t px){
+  return find_last<true>(row, begin, end, px);
+}
+
+static bool row_matches(const Bitmap& bmp, int y, int begin, int end,
+  uint32_t px)
+{
+  return first_differing(row_ptr(bmp, y), begin, end, px) == end;
+}
+
+static bool column_matches(const Bitmap& bmp, int x, int begin, int end,
+  uint32_t px)
+{
+  const uchar* p = bmp.m_data + x * BPP;
+  for (int y = begin; y != end; y++){
+    if (load_pixel(p + y * bmp.m_row_stride) != px){
+      return false;
+    }
+  }
+  return true;
+}
+
 static IntRect get_auto_crop_rect(const Bitmap& bmp, const Color& bgCol){
+  // Returns the rectangle bounding all pixels which differ from bgCol,
+  // or an empty rectangle if there are none.
+  //
+  // The top and bottom are found by comparing whole rows. The left
+  // and right are then found with row-wise scans of the remaining
+  // band, which only need to cover the margins not yet excluded.
+  const uint32_t bg = BitmapFormat::Pack(bgCol);
   const int width = bmp.m_w;
   const int height = bmp.m_h;
+
   int y0 = 0;
-  int y1 = 0;
-  bool upDone = false;
-  bool dnDone = false;
-
-  for (int y = 0; y != height; y++){
-    for (int x = 0; x!= width; x++){
-      if (!upDone){
-        if (get_color_raw(bmp, x, y) != bgCol){
-          y0 = y;
-          upDone = true;
-          if (dnDone){
-            goto yDone;
-          }
-        }
-      }
-      if (!dnDone){
-        if (get_color_raw(bmp, x, height - y - 1) != bgCol){
-          y1 = height - y;
-          dnDone = true;
-          if (upDone){
-            goto yDone;
-          }
-        }
-      }
-    }
+  while (y0 != height && row_matches(bmp, y0, 0, width, bg)){
+    y0++;
+  }
+  if (y0 == height){
+    return IntRect(IntPoint(0, 0), IntSize(0, 0));
   }
 
-  // Post-y computation-label
- yDone:
-  int x0 = 0;
-  int x1 = 0;
-  bool leftDone = false;
-  bool rightDone = false;
-
-  for (int x = 0; x!= width; x++){
-    for (int y = 0; y!= height; y++){
-      if (!leftDone){
-        if (get_color_raw(bmp, x, y) != bgCol){
-          x0 = x;
-          leftDone = true;
-          if (rightDone){
-            goto xDone;
-          }
-        }
-      }
-      if (!rightDone){
-        if (get_color_raw(bmp, width - x - 1, y) != bgCol){
-          x1 = width - x;
-          rightDone = true;
-          if (leftDone){
-            goto xDone;
-          }
-        }
-      }
-    }
+  int y1 = height;
+  while (row_matches(bmp, y1 - 1, 0, width, bg)){
+    y1--;
   }
 
-  // Done
- xDone:
+  int x0 = width;
+  int x1 = 0;
+  for (int y = y0; y != y1 && (x0 != 0 || x1 != width); y++){
+    const uchar* row = row_ptr(bmp, y);
+    x0 = first_differing(row, 0, x0, bg);
+    x1 = last_differing(row, x1, width, bg);
+  }
   return IntRect(IntPoint(x0, y0), IntSize(x1 - x0, y1 - y0));
 }
 
@@ -99,20 +163,13 @@ Optional<Color> get_edge_color(const Bitmap& bmp, const IntRect& r){
   }
 
   Color color = get_color_raw(bmp, r.x, r.y);
-  for (int x = r.x; x != r.x + r.w; x++){
-    if (get_color_raw(bmp, x, r.y) != color ||
-      get_color_raw(bmp, x, r.y + r.h - 1) != color)
-    {
-      return {};
-    }
-  }
-
-  for (int y = r.y; y != r.y + r.h; y++){
-    if (get_color_raw(bmp, r.x + r.w - 1, y) != color ||
-      get_color_raw(bmp, r.x, y) != color)
-    {
-      return {};
-    }
+  const uint32_t px = BitmapFormat::Pack(color);
+  if (!row_matches(bmp, r.y, r.x, r.x + r.w, px) ||
+    !row_matches(bmp, r.y + r.h - 1, r.x, r.x + r.w, px) ||
+    !column_matches(bmp, r.x + r.w - 1, r.y, r.y + r.h, px) ||
+    !column_matches(bmp, r.x, r.y, r.y + r.h, px))
+  {
+    return {};
   }
 
   // Color determined
@@ -167,22 +224,12 @@ Color most_common_edge_color(const Bitmap& bmp){
 
 static bool get_horizontal_scanline_color(const Bitmap& bmp, int y, Color& result){
   result = get_color_raw(bmp, 0, y);
-  for (int x = 1; x != bmp.m_w; x++){
-    if (get_color_raw(bmp, x, y) != result){
-      return false;
-    }
-  }
-  return true;
+  return row_matches(bmp, y, 1, bmp.m_w, BitmapFormat::Pack(result));
 }
 
 static bool get_vertical_scanline_color(const Bitmap& bmp, int x, Color& result){
   result = get_color_raw(bmp, x, 0);
-  for (int y = 1; y != bmp.m_h; y++){
-    if (get_color_raw(bmp, x, y) != result){
-      return false;
-    }
-  }
-  return true;
+  return column_matches(bmp, x, 1, bmp.m_h, BitmapFormat::Pack(result));
 }
 
 bool get_bottom_edge_color(const Bitmap& bmp, Color& result){
@@ -256,29 +303,41 @@ AtMost2<IntRect> get_auto_crop_rectangles(const Optional<Bitmap>& bmp){
 }
 
 Optional<IntRect> find_color_extents(const Bitmap& bmp, const Color& c){
-  int minX = bmp.m_w;
-  int minY = bmp.m_h;
-  int maxX = 0;
-  int maxY = 0;
-  for (int y = 0; y != bmp.m_h; y++){
-    for (int x = 0; x != bmp.m_w; x++){
-      if (get_color_raw(bmp, x, y) == c){
-
-        minY = std::min(minY, y);
-        maxY = std::max(maxY, y);
-
-        minX = std::min(minX, x);
-        maxX = std::max(maxX, x);
-
-      }
+  // Finds the top- and bottom-most rows containing the color, then
+  // narrows the columns with the rows from the top to the bottom row,
+  // scanning only outside the extents found so far.
+  const uint32_t px = BitmapFormat::Pack(c);
+  const int w = bmp.m_w;
+  const int h = bmp.m_h;
+
+  int minY = 0;
+  int minX = w;
+  for (; minY != h; minY++){
+    minX = first_equal(row_ptr(bmp, minY), 0, w, px);
+    if (minX != w){
+      break;
     }
   }
-  if (minX <= maxX && minY <= maxY){
-    return {IntRect(IntPoint(minX, minY), IntSize(maxX - minX + 1,
-      maxY - minY + 1))};
+  if (minY == h){
+    return {};
   }
+  int maxX = last_equal(row_ptr(bmp, minY), minX + 1, w, px);
 
-  return {};
+  int maxY = h; // One past the bottom-most found
+  while (maxY - 1 != minY &&
+    first_equal(row_ptr(bmp, maxY - 1), 0, w, px) == w)
+  {
+    maxY--;
+  }
+
+  for (int y = minY + 1; y != maxY && (minX != 0 || maxX != w); y++){
+    const uchar* row = row_ptr(bmp, y);
+    minX = first_equal(row, 0, minX, px);
+    maxX = last_equal(row, maxX, w, px);
+  }
+
+  return {IntRect(IntPoint(minX, minY), IntSize(maxX - minX,
+    maxY - minY))};
 }
 
 } // namespace
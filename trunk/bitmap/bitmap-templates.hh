@@ -15,14 +15,18 @@
 
 #ifndef FAINT_BITMAP_TEMPLATES_HH
 #define FAINT_BITMAP_TEMPLATES_HH
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <functional>
 #include "bitmap/bitmap.hh"
 #include "bitmap/color.hh"
 #include "bitmap/draw.hh"
+#include "bitmap/gradient.hh"
 #include "bitmap/paint.hh"
 #include "bitmap/pattern.hh"
+#include "bitmap/pixel-view.hh"
 #include "geo/int-rect.hh"
-#include "rendering/cairo-context.hh" // FIXME
 
 namespace faint{
 
@@ -62,6 +66,39 @@ inline Color get_color_modulo(const Bitmap& bmp, const IntPoint& pos){
 }
 
 
+inline bool clip_span(const Bitmap& bmp, int& x, int y, int& n){
+  // Clips the span of n pixels starting at x,y to the bitmap. Returns
+  // false if no pixels remain.
+  if (y < 0 || y >= bmp.m_h){
+    return false;
+  }
+  if (x < 0){
+    n += x;
+    x = 0;
+  }
+  n = std::min(n, bmp.m_w - x);
+  return n > 0;
+}
+
+inline uchar* span_start(Bitmap& bmp, int x, int y){
+  return bmp.GetRaw() + y * bmp.m_row_stride + x * BPP;
+}
+
+inline void blend_span_pixel(uchar* dst, uchar r, uchar g, uchar b,
+  uchar alpha)
+{
+  // Blends the color onto the pixel with the specified alpha, keeping
+  // the greater alpha, like blend does.
+  dst[iR] = static_cast<uchar>((r * alpha + dst[iR] * (255 - alpha)) / 255);
+  dst[iG] = static_cast<uchar>((g * alpha + dst[iG] * (255 - alpha)) / 255);
+  dst[iB] = static_cast<uchar>((b * alpha + dst[iB] * (255 - alpha)) / 255);
+  dst[iA] = std::max(alpha, dst[iA]);
+}
+
+// The paint sources below are used as draw source for the template
+// draw-functions. Each sets single pixels with operator() and
+// horizontal runs of pixels with Span.
+
 struct ColorFromColor{
   ColorFromColor(const Color& color)
     : m_color(color)
@@ -69,32 +106,109 @@ struct ColorFromColor{
   void operator()(Bitmap& dst, int x, int y) const{
     put_pixel_raw(dst, x, y, m_color);
   }
+
+  void Span(Bitmap& dst, int x, int y, int n) const{
+    if (!clip_span(dst, x, y, n)){
+      return;
+    }
+    fill_pixels(span_start(dst, x, y), to_size_t(n),
+      BitmapFormat::Pack(m_color));
+  }
+
   Color m_color;
 };
 
 struct ColorFromGradient{
-  // Functor for using a Gradient as draw source
-  // Fixme: Use new ColorFromBitmap with both Pattern and Gradient
+  // Functor for using a Gradient as draw source, with the gradient
+  // stretched over the rectangle and repeated outside it.
   ColorFromGradient(const Gradient& g, const IntRect& r)
-    : m_bmp(cairo_gradient_bitmap(g, r.GetSize())),
-      m_x(-r.x),
-      m_y(-r.y)
-  {}
+    : m_ramp(g.GetRamp()),
+      m_radial(g.IsRadial()),
+      m_x(r.x),
+      m_y(r.y),
+      m_w(std::max(r.w, 1)),
+      m_h(std::max(r.h, 1))
+  {
+    // The offsets are evaluated at pixel centers, for the same
+    // result as Cairo's gradients with this size.
+    if (m_radial){
+      // Like the Cairo gradient matrix, the center offset is
+      // subtracted horizontally but added vertically.
+      m_center = g.GetRadial().GetCenter();
+    }
+    else{
+      const Angle angle = g.GetLinear().GetAngle();
+      m_cos = cos(angle);
+      m_sin = sin(angle);
+    }
+  }
+
   void operator()(Bitmap& dst, int x, int y) const{
     // Fixme: Blend or set should depend on ts_AlphaBlending
-    put_pixel_raw(dst, x, y, get_color_modulo_raw(m_bmp, x + m_x, y + m_y));
+    Span(dst, x, y, 1);
   }
 
-  void operator()(Bitmap& dst, int x, int y, uchar a) const{
-    // Fixme: Blend or set should depend on ts_AlphaBlending
-    Color c(strip_alpha(get_color_modulo_raw(m_bmp, x + m_x, y + m_y)), a);
-    put_pixel_raw(dst, x, y, c);
+  void Span(Bitmap& dst, int x, int y, int n) const{
+    if (!clip_span(dst, x, y, n)){
+      return;
+    }
+    uchar* p = span_start(dst, x, y);
+    ForSpan(x, y, n, [&](const Color& c){
+      p[iR] = c.r;
+      p[iG] = c.g;
+      p[iB] = c.b;
+      p[iA] = c.a;
+      p += BPP;
+    });
   }
 
-  Bitmap m_bmp;
+  void BlendSpan(uchar* dst, int x, int y, int n, const uchar* alpha) const{
+    // Blends the n colors from x,y onto the pixels at dst, using the
+    // alpha values instead of the gradient's.
+    ForSpan(x, y, n, [&](const Color& c){
+      blend_span_pixel(dst, c.r, c.g, c.b, *alpha);
+      dst += BPP;
+      alpha++;
+    });
+  }
+
+  const ColorRamp& m_ramp;
+  bool m_radial;
+  Point m_center;
+  coord m_cos = 0.0;
+  coord m_sin = 0.0;
   int m_x;
   int m_y;
+  int m_w;
+  int m_h;
+
 private:
+  template<typename FUNC>
+  void ForSpan(int x, int y, int n, const FUNC& func) const{
+    // Calls func with the color for each pixel in the span, the
+    // offset within the rectangle is advanced per pixel instead of
+    // wrapped.
+    int rx = wrap(x - m_x, m_w);
+    const coord v = (wrap(y - m_y, m_h) + 0.5) / m_h - 0.5;
+    if (m_radial){
+      const coord dy = v + m_center.y / m_h;
+      const coord dy2 = dy * dy;
+      for (int i = 0; i != n; i++){
+        const coord dx = (rx + 0.5 - m_center.x) / m_w - 0.5;
+        func(m_ramp.At(2 * std::sqrt(dx * dx + dy2)));
+        rx = rx + 1 == m_w ? 0 : rx + 1;
+      }
+    }
+    else{
+      const coord rowOffset = 0.5 + m_sin * v;
+      for (int i = 0; i != n; i++){
+        const coord u = (rx + 0.5) / m_w - 0.5;
+        func(m_ramp.At(rowOffset + m_cos * u));
+        rx = rx + 1 == m_w ? 0 : rx + 1;
+      }
+    }
+  }
+
   ColorFromGradient& operator=(const ColorFromGradient&); // Silence warning
 };
 
@@ -112,15 +226,44 @@ struct ColorFromPattern{
     put_pixel_raw(dst, x, y, get_color_modulo_raw(m_bmp, x + m_x, y + m_y));
   }
 
-  void operator()(Bitmap& dst, int x, int y, uchar a) const{
-    // Fixme: Blend or Set should depend on ts_AlphaBlending
-    Color c(strip_alpha(get_color_modulo_raw(m_bmp, x + m_x, y + m_y)), a);
-    put_pixel_raw(dst, x, y, c);
-}
+  void Span(Bitmap& dst, int x, int y, int n) const{
+    // Copies runs of pattern pixels, up to the right edge of the
+    // pattern at a time.
+    if (!clip_span(dst, x, y, n)){
+      return;
+    }
+    uchar* p = span_start(dst, x, y);
+    const uchar* row = PatternRow(y);
+    int px = wrap(x + m_x, m_bmp.m_w);
+    while (n > 0){
+      const int run = std::min(n, m_bmp.m_w - px);
+      std::memcpy(p, row + px * BPP, static_cast<size_t>(run * BPP));
+      p += run * BPP;
+      n -= run;
+      px = 0;
+    }
+  }
+
+  void BlendSpan(uchar* dst, int x, int y, int n, const uchar* alpha) const{
+    // Blends the n pattern pixels from x,y onto the pixels at dst,
+    // using the alpha values instead of the pattern's.
+    const uchar* row = PatternRow(y);
+    int px = wrap(x + m_x, m_bmp.m_w);
+    for (int i = 0; i != n; i++){
+      const uchar* src = row + px * BPP;
+      blend_span_pixel(dst + i * BPP, src[iR], src[iG], src[iB], alpha[i]);
+      px = px + 1 == m_bmp.m_w ? 0 : px + 1;
+    }
+  }
+
   const Bitmap& m_bmp;
   int m_x;
   int m_y;
 private:
+  const uchar* PatternRow(int y) const{
+    return m_bmp.GetRaw() + wrap(y + m_y, m_bmp.m_h) * m_bmp.m_row_stride;
+  }
+
   ColorFromPattern& operator=(const ColorFromPattern&); // Silence warning
 };
 
@@ -213,19 +356,6 @@ void set_pixels_if(Bitmap& bmp,
   }
 }
 
-template<typename SetFunctor, typename BlendFunctor>
-void blend_pixels(Bitmap& bmp,
-  const SetFunctor& setPixFunc,
-  const BlendFunctor& blendFunc)
-{
-  IntSize sz(bmp.GetSize());
-  for (int y = 0; y != sz.h; y++){
-    for (int x = 0; x != sz.w; x++){
-      setPixFunc(bmp, x, y, blendFunc(x,y));
-    }
-  }
-}
-
 // Forwarder which applies an, otherwise in-place function, to a copy of
 // the Bitmap parameter and returns the result.
 template<typename ...Args1, typename ...Args2>
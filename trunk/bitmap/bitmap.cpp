@@ -22,6 +22,7 @@
 #include "bitmap/draw.hh"
 #include "geo/int-rect.hh"
 #include "geo/size.hh"
+#include "util/scratch-arena.hh"
 
 namespace faint{
 
@@ -62,7 +63,8 @@ inline uchar* allocate_bitmap_data(size_t len){
 }
 
 Bitmap::Bitmap()
-  : m_row_stride(0)
+  : m_row_stride(0),
+    m_heap(true)
 {
   m_w = m_h = 0;
   m_data = nullptr;
@@ -72,7 +74,8 @@ Bitmap::Bitmap(const Bitmap& other)
   : m_row_stride(other.m_row_stride),
     m_w(other.m_w),
     m_h(other.m_h),
-    m_data(nullptr)
+    m_data(nullptr),
+    m_heap(true)
 {
   if (other.m_data != nullptr){
     const auto len = data_length(m_row_stride, m_h);
@@ -85,7 +88,8 @@ Bitmap::Bitmap(const IntSize& sz)
   : m_row_stride(0),
     m_w(sz.w),
     m_h(sz.h),
-    m_data(nullptr)
+    m_data(nullptr),
+    m_heap(true)
 {
   assert(m_w > 0);
   assert(m_h > 0);
@@ -99,7 +103,8 @@ Bitmap::Bitmap(const IntSize& sz, const Color& bgColor)
   : m_row_stride(0),
     m_w(sz.w),
     m_h(sz.h),
-    m_data(nullptr)
+    m_data(nullptr),
+    m_heap(true)
 {
   assert(m_w > 0);
   assert(m_h > 0);
@@ -113,7 +118,8 @@ Bitmap::Bitmap(const IntSize& sz, const Paint& bg)
   : m_row_stride(0),
     m_w(sz.w),
     m_h(sz.h),
-    m_data(nullptr)
+    m_data(nullptr),
+    m_heap(true)
 {
   assert(m_w > 0);
   assert(m_h > 0);
@@ -127,7 +133,8 @@ Bitmap::Bitmap(const IntSize& sz, int stride)
   : m_row_stride(stride),
     m_w(sz.w),
     m_h(sz.h),
-    m_data(nullptr)
+    m_data(nullptr),
+    m_heap(true)
 {
   assert(sz.w > 0);
   assert(sz.h > 0);
@@ -138,19 +145,36 @@ Bitmap::Bitmap(const IntSize& sz, int stride)
   memset(m_data, 0, len);
 }
 
+Bitmap::Bitmap(const IntSize& sz, ScratchArena& arena)
+  : m_row_stride(0),
+    m_w(sz.w),
+    m_h(sz.h),
+    m_data(nullptr),
+    m_heap(false)
+{
+  assert(m_w > 0);
+  assert(m_h > 0);
+  m_row_stride = faint_cairo_stride(sz);
+  m_data = arena.AllocateArray<uchar>(data_length(m_row_stride, m_h));
+}
+
 Bitmap::Bitmap(Bitmap&& source)
   : m_row_stride(source.m_row_stride),
     m_w(source.m_w),
     m_h(source.m_h),
-    m_data(source.m_data)
+    m_data(source.m_data),
+    m_heap(source.m_heap)
 {
   source.m_data = nullptr;
   source.m_w = 0;
   source.m_h = 0;
+  source.m_heap = true;
 }
 
 Bitmap::~Bitmap(){
-  delete[] m_data;
+  if (m_heap){
+    delete[] m_data;
+  }
 }
 
 Bitmap& Bitmap::operator=(const Bitmap& other){
@@ -165,6 +189,7 @@ void Bitmap::Swap(Bitmap& other){
   swap(m_w, other.m_w);
   swap(m_h, other.m_h);
   swap(m_data, other.m_data);
+  swap(m_heap, other.m_heap);
 }
 
 Bitmap& Bitmap::operator=(Bitmap&& other){
@@ -207,16 +232,7 @@ bool bitmap_ok(const Bitmap& bmp){
 }
 
 void clear(Bitmap& bmp, const Color& c){
-  uchar* data = bmp.m_data;
-  for (int y = 0; y != bmp.m_h; y++){
-    for (int x = 0; x != bmp.m_w; x++){
-      int dst = y * bmp.m_row_stride + x * BPP;
-      data[dst + iR] = c.r;
-      data[dst + iG] = c.g;
-      data[dst + iB] = c.b;
-      data[dst + iA] = c.a;
-    }
-  }
+  fill_rect_color(bmp, IntRect(IntPoint(0,0), bmp.GetSize()), c);
 }
 
 void clear(Bitmap& bmp, const ColRGB& c){
@@ -22,6 +22,8 @@
 
 namespace faint{
 
+class ScratchArena;
+
 const int BPP = 4;
 const int iR = 2;
 const int iG = 1;
@@ -38,6 +40,10 @@ public:
   Bitmap(const IntSize&, const Color&);
   Bitmap(const IntSize&, const Paint&);
   Bitmap(const IntSize&, int stride);
+
+  // Uses memory from the arena, which must outlive the Bitmap. The
+  // pixels are left uninitialized. Copies of the Bitmap use the heap.
+  Bitmap(const IntSize&, ScratchArena&);
   Bitmap(Bitmap&&);
   ~Bitmap();
   inline uchar* GetRaw(){
@@ -68,6 +74,8 @@ public:
   int m_w;
   int m_h;
   uchar* m_data;
+private:
+  bool m_heap; // False if m_data belongs to a ScratchArena
 };
 
 bool bitmap_ok(const Bitmap&);
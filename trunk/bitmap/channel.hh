@@ -19,30 +19,8 @@
 
 namespace faint{
 
-class Bitmap;
-class Color;
-
 using channel_t = std::vector<unsigned char>;
 
-class Channels{
-  // Red, green, blue and alpha color channels.
-  // Some algorithms operate better on color channels than
-  // a combined array (as in faint::Bitmap).
-public:
-  channel_t r;
-  channel_t g;
-  channel_t b;
-  channel_t a;
-
-  // The row width
-  int w;
-};
-
-Channels separate_into_channels(const Bitmap&);
-Bitmap combine_into_bitmap(const Channels&);
-Color get_color(const Channels&, int index);
-std::vector<Color> get_colors(const Channels&);
-
 } // namespace
 
 #endif
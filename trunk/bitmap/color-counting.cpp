@@ -15,49 +15,182 @@
 
 #include <algorithm>
 #include <cassert>
-#include <unordered_set>
+#include <cstring>
+#include <limits>
 #include "bitmap/bitmap.hh"
 #include "bitmap/color.hh"
 #include "bitmap/color-counting.hh"
+#include "geo/primitive.hh"
+#include "util/parallel.hh"
 
 namespace faint{
 
-static void insert_color_count(color_counts_t& colors, const Color& c){
-  auto it = colors.find(c);
-  if (it != colors.end()){
-    it->second++;
+static const int no_color_limit = std::numeric_limits<int>::max();
+
+static uint32_t pixel_key(const uchar* pixel){
+  uint32_t key;
+  std::memcpy(&key, pixel, BPP);
+  return key;
+}
+
+static uint32_t color_key(const Color& c){
+  uchar pixel[BPP];
+  pixel[iR] = c.r;
+  pixel[iG] = c.g;
+  pixel[iB] = c.b;
+  pixel[iA] = c.a;
+  return pixel_key(pixel);
+}
+
+static size_t slot_for(uint32_t key, size_t capacity){
+  // Multiplicative hashing, using the high bits of the product, so
+  // that colors differing only in one channel are spread out.
+  const uint64_t h = key * UINT64_C(0x9E3779B97F4A7C15);
+  return (h >> 32) & (capacity - 1);
+}
+
+ColorHistogram::ColorHistogram()
+  : m_keys(64),
+    m_counts(64, 0),
+    m_size(0)
+{}
+
+int ColorHistogram::at(const Color& c) const{
+  const size_t i = Find(color_key(c));
+  assert(m_counts[i] != 0);
+  return m_counts[i];
+}
+
+bool ColorHistogram::empty() const{
+  return m_size == 0;
+}
+
+void ColorHistogram::insert(const Color& c, int count){
+  Add(color_key(c), count);
+}
+
+void ColorHistogram::merge(const ColorHistogram& other){
+  for (size_t i = 0; i != other.m_counts.size(); i++){
+    if (other.m_counts[i] != 0){
+      Add(other.m_keys[i], other.m_counts[i]);
+    }
   }
-  else{
-    colors.insert(std::make_pair(c, 1));
+}
+
+int ColorHistogram::size() const{
+  return m_size;
+}
+
+void ColorHistogram::add_row(const uchar* row, int width, int maxColors){
+  int x = 0;
+  while (x != width && m_size <= maxColors){
+    // Count runs of identical pixels with a single lookup.
+    const uint32_t key = pixel_key(row + x * BPP);
+    int run = 1;
+    while (x + run != width && pixel_key(row + (x + run) * BPP) == key){
+      run++;
+    }
+    Add(key, run);
+    x += run;
   }
 }
 
-void add_color_counts(const Bitmap& bmp, color_counts_t& colors){
-  assert(bmp.m_w > 0 && bmp.m_h > 0);
-  for (int y = 0; y != bmp.m_h; y++){
-    for (int x = 0; x != bmp.m_w; ++x){
-      insert_color_count(colors, get_color_raw(bmp, x,y));
+Color ColorHistogram::ColorFromKey(uint32_t key){
+  uchar pixel[BPP];
+  std::memcpy(pixel, &key, BPP);
+  return Color(pixel[iR], pixel[iG], pixel[iB], pixel[iA]);
+}
+
+void ColorHistogram::Add(uint32_t key, int count){
+  const size_t i = Find(key);
+  if (m_counts[i] != 0){
+    m_counts[i] += count;
+    return;
+  }
+
+  m_keys[i] = key;
+  m_counts[i] = count;
+  m_size++;
+  if (to_size_t(m_size) * 2 > m_counts.size()){
+    Grow();
+  }
+}
+
+size_t ColorHistogram::Find(uint32_t key) const{
+  // Linear probing. The table is at most half full, so an empty slot
+  // ends the search.
+  const size_t mask = m_counts.size() - 1;
+  size_t i = slot_for(key, m_counts.size());
+  while (m_counts[i] != 0 && m_keys[i] != key){
+    i = (i + 1) & mask;
+  }
+  return i;
+}
+
+void ColorHistogram::Grow(){
+  std::vector<uint32_t> keys(m_keys.size() * 2);
+  std::vector<int> counts(m_counts.size() * 2, 0);
+  keys.swap(m_keys);
+  counts.swap(m_counts);
+  m_size = 0;
+  for (size_t i = 0; i != counts.size(); i++){
+    if (counts[i] != 0){
+      Add(keys[i], counts[i]);
     }
   }
 }
 
+static void add_rows(const Bitmap& bmp, int y0, int y1, int maxColors,
+  ColorHistogram& colors)
+{
+  for (int y = y0; y != y1 && colors.size() <= maxColors; y++){
+    colors.add_row(bmp.m_data + y * bmp.m_row_stride, bmp.m_w, maxColors);
+  }
+}
+
+ColorHistogram color_histogram(const Bitmap& bmp, int maxColors){
+  // Smaller bitmaps are counted faster than the threads start.
+  const int minPixelsPerBand = 1 << 18;
+  const int numBands = std::min(get_concurrency(),
+    std::max(1, bmp.m_w * bmp.m_h / minPixelsPerBand));
+  const int rowsPerBand = (bmp.m_h + numBands - 1) / numBands;
+
+  return parallel_reduce(bmp.m_h, rowsPerBand, ColorHistogram(),
+    [&](int y0, int y1){
+      ColorHistogram band;
+      add_rows(bmp, y0, y1, maxColors, band);
+      return band;
+    },
+    [&](ColorHistogram colors, const ColorHistogram& band){
+      if (colors.size() <= maxColors){
+        colors.merge(band);
+      }
+      return colors;
+    });
+}
+
+void add_color_counts(const Bitmap& bmp, color_counts_t& colors){
+  assert(bmp.m_w > 0 && bmp.m_h > 0);
+  add_rows(bmp, 0, bmp.m_h, no_color_limit, colors);
+}
+
 Color most_common(const color_counts_t& colors){
   assert(!colors.empty());
-  using count_t = color_counts_t::value_type;
-  auto it = std::max_element(begin(colors), end(colors),
-    [](const count_t& c1, const count_t& c2){return c1.second < c2.second;});
-  assert(it != colors.end());
-  return it->first;
+  Color color;
+  int maxCount = 0;
+  colors.for_each([&](const Color& c, int count){
+    // Ties go to the lesser color, as the order of for_each is
+    // arbitrary.
+    if (count > maxCount || (count == maxCount && c < color)){
+      color = c;
+      maxCount = count;
+    }
+  });
+  return color;
 }
 
 int count_colors(const Bitmap& bmp){
-  std::unordered_set<unsigned int> s;
-  for (int y = 0; y != bmp.m_h; y++){
-    for (int x = 0; x != bmp.m_w; x++){
-      s.insert(to_hash(get_color_raw(bmp, x,y)));
-    }
-  }
-  return resigned(s.size());
+  return color_histogram(bmp, no_color_limit).size();
 }
 
 } // namespace
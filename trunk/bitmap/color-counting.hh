@@ -15,19 +15,74 @@
 
 #ifndef FAINT_COLOR_COUNTING_HH
 #define FAINT_COLOR_COUNTING_HH
-#include <map>
+#include <cstdint>
+#include <vector>
+#include "bitmap/color.hh"
 
 namespace faint{
 
 class Bitmap;
-class Color;
 
-// Maps Colors to a pixel count
-using color_counts_t = std::map<Color, int>;
+class ColorHistogram{
+  // Maps Colors to a pixel count.
+  //
+  // An open-addressing hash table keyed on the 32-bit pixel value, so
+  // that counting does not allocate per color or compare Colors
+  // component by component.
+public:
+  ColorHistogram();
+
+  // Returns the count for the color, which must have been added.
+  int at(const Color&) const;
+
+  bool empty() const;
+
+  // Calls func(const Color&, int count) for each color, in no
+  // particular order.
+  template<typename FUNC>
+  void for_each(const FUNC& func) const{
+    for (size_t i = 0; i != m_counts.size(); i++){
+      if (m_counts[i] != 0){
+        func(ColorFromKey(m_keys[i]), m_counts[i]);
+      }
+    }
+  }
+
+  void insert(const Color&, int count=1);
+
+  // Adds the counts from the other histogram.
+  void merge(const ColorHistogram&);
+
+  // The number of distinct colors
+  int size() const;
+
+  // Adds the pixels of the row to the counts. Stops when the number
+  // of distinct colors exceeds maxColors.
+  void add_row(const uchar* row, int width, int maxColors);
+
+private:
+  static Color ColorFromKey(uint32_t);
+  void Add(uint32_t key, int count);
+  size_t Find(uint32_t key) const;
+  void Grow();
+
+  std::vector<uint32_t> m_keys;
+  std::vector<int> m_counts;
+  int m_size;
+};
+
+using color_counts_t = ColorHistogram;
 
 // Adds the colors from the Bitmap to the passed in color_counts_t
 void add_color_counts(const Bitmap&, color_counts_t&);
 
+// Counts the colors in the Bitmap, giving up when more than maxColors
+// distinct colors are seen. The returned histogram is then incomplete,
+// but its size() exceeds maxColors.
+//
+// Large bitmaps are counted in bands on separate threads.
+ColorHistogram color_histogram(const Bitmap&, int maxColors);
+
 // Returns the most common color. The color_counts_t must not be
 // empty
 Color most_common(const color_counts_t&);
@@ -0,0 +1,121 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <cassert>
+#include <cstring>
+#include "bitmap/bitmap.hh"
+#include "bitmap/compressed-bitmap.hh"
+#include "bitmap/pixel-view.hh"
+#include "geo/int-point.hh"
+
+namespace faint{
+
+// Run header flag for a repeated pixel, otherwise the header is
+// followed by the given count of literal pixels.
+static const uint32_t repeat_flag = 1u << 31;
+
+// Shortest run of equal pixels stored as a repeat-run
+static const int min_repeat = 3;
+
+static int run_length(const uchar* row, int x, int w){
+  const uint32_t v = load_pixel(row + x * BPP);
+  int n = 1;
+  while (x + n != w && load_pixel(row + (x + n) * BPP) == v){
+    n++;
+  }
+  return n;
+}
+
+CompressedBitmap::CompressedBitmap(const Bitmap& bmp)
+  : m_size(bmp.GetSize())
+{
+  for (int y = 0; y != bmp.m_h; y++){
+    const uchar* row = bmp.m_data + y * bmp.m_row_stride;
+    int x = 0;
+    while (x != bmp.m_w){
+      const int repeated = run_length(row, x, bmp.m_w);
+      if (repeated >= min_repeat){
+        m_data.push_back(repeat_flag | static_cast<uint32_t>(repeated));
+        m_data.push_back(load_pixel(row + x * BPP));
+        x += repeated;
+        continue;
+      }
+
+      // Gather literal pixels until the next repeat-run
+      const size_t header = m_data.size();
+      m_data.push_back(0);
+      int literals = 0;
+      while (x != bmp.m_w){
+        const int n = run_length(row, x, bmp.m_w);
+        if (n >= min_repeat){
+          break;
+        }
+        for (int i = 0; i != n; i++){
+          m_data.push_back(load_pixel(row + (x + i) * BPP));
+        }
+        x += n;
+        literals += n;
+      }
+      m_data[header] = static_cast<uint32_t>(literals);
+    }
+  }
+  m_data.shrink_to_fit();
+}
+
+Bitmap CompressedBitmap::Decompress() const{
+  Bitmap bmp(m_size);
+  DecompressOnto(bmp, IntPoint(0, 0));
+  return bmp;
+}
+
+void CompressedBitmap::DecompressOnto(Bitmap& bmp,
+  const IntPoint& topLeft) const
+{
+  assert(topLeft.x >= 0 && topLeft.y >= 0);
+  assert(topLeft.x + m_size.w <= bmp.m_w);
+  assert(topLeft.y + m_size.h <= bmp.m_h);
+
+  size_t i = 0;
+  for (int y = 0; y != m_size.h; y++){
+    uchar* p = bmp.m_data + (topLeft.y + y) * bmp.m_row_stride +
+      topLeft.x * BPP;
+    int x = 0;
+    while (x != m_size.w){
+      const uint32_t header = m_data[i++];
+      const int n = static_cast<int>(header & ~repeat_flag);
+      if ((header & repeat_flag) != 0){
+        const uint32_t v = m_data[i++];
+        for (int j = 0; j != n; j++){
+          store_pixel(p + (x + j) * BPP, v);
+        }
+      }
+      else{
+        std::memcpy(p + x * BPP, &m_data[i], n * sizeof(uint32_t));
+        i += n;
+      }
+      x += n;
+    }
+  }
+}
+
+size_t CompressedBitmap::GetByteCount() const{
+  return m_data.size() * sizeof(uint32_t);
+}
+
+IntSize CompressedBitmap::GetSize() const{
+  return m_size;
+}
+
+} // namespace
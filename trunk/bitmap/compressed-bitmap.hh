@@ -0,0 +1,53 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FAINT_COMPRESSED_BITMAP_HH
+#define FAINT_COMPRESSED_BITMAP_HH
+#include <cstdint>
+#include <vector>
+#include "geo/int-size.hh"
+
+namespace faint{
+
+class Bitmap;
+class IntPoint;
+
+class CompressedBitmap{
+  // Run-length encoded pixel data of a Bitmap, for keeping image
+  // regions around with less memory (e.g. for undo).
+  //
+  // Each row is stored as runs of either a repeated pixel or of
+  // literal pixels, so the size for incompressible data is about
+  // that of the bitmap.
+public:
+  explicit CompressedBitmap(const Bitmap&);
+
+  Bitmap Decompress() const;
+
+  // Writes the pixels to the bitmap with the top left corner at the
+  // given point. The pixels must fit within the bitmap.
+  void DecompressOnto(Bitmap&, const IntPoint& topLeft) const;
+
+  // The number of bytes used for the compressed data
+  size_t GetByteCount() const;
+  IntSize GetSize() const;
+private:
+  IntSize m_size;
+  std::vector<uint32_t> m_data;
+};
+
+} // namespace
+
+#endif
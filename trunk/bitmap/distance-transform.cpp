@@ -0,0 +1,117 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <algorithm>
+#include <limits>
+#include "bitmap/bitmap.hh"
+#include "bitmap/distance-transform.hh"
+#include "geo/primitive.hh"
+
+namespace faint{
+
+static const float infinite_distance = std::numeric_limits<float>::infinity();
+
+class EnvelopeBuffers{
+  // Storage for the lower envelope, reused between rows and columns.
+public:
+  explicit EnvelopeBuffers(int n)
+    : f(to_size_t(n)),
+      v(to_size_t(n)),
+      z(to_size_t(n + 1))
+  {}
+
+  std::vector<float> f; // The input values of the current line
+  std::vector<int> v; // Positions of the parabolas in the envelope
+  std::vector<double> z; // Boundaries between the parabolas
+};
+
+static void distance_1d(float* d, int n, int stride, EnvelopeBuffers& buf){
+  // Replaces the n values in d, separated by stride, with the
+  // squared distance transform of the values.
+  const float* f = buf.f.data();
+  for (int q = 0; q != n; q++){
+    buf.f[to_size_t(q)] = d[q * stride];
+  }
+
+  int* v = buf.v.data();
+  double* z = buf.z.data();
+  int k = -1;
+  for (int q = 0; q != n; q++){
+    if (f[q] == infinite_distance){
+      // Infinite parabolas are never part of the envelope
+      continue;
+    }
+    if (k == -1){
+      k = 0;
+      v[0] = q;
+      z[0] = -std::numeric_limits<double>::infinity();
+      z[1] = std::numeric_limits<double>::infinity();
+      continue;
+    }
+
+    double s = 0;
+    for (;;){
+      const int p = v[k];
+      s = ((f[q] + double(q) * q) - (f[p] + double(p) * p)) / (2.0 * (q - p));
+      if (s > z[k]){
+        break;
+      }
+      k--;
+    }
+    k++;
+    v[k] = q;
+    z[k] = s;
+    z[k + 1] = std::numeric_limits<double>::infinity();
+  }
+
+  if (k == -1){
+    // Nothing to measure from on this line
+    return;
+  }
+
+  k = 0;
+  for (int q = 0; q != n; q++){
+    while (z[k + 1] < q){
+      k++;
+    }
+    const int p = v[k];
+    d[q * stride] = static_cast<float>(double(q - p) * (q - p) + f[p]);
+  }
+}
+
+std::vector<float> squared_distance_to_opaque(const Bitmap& bmp){
+  const int w = bmp.m_w;
+  const int h = bmp.m_h;
+  std::vector<float> d(to_size_t(area(bmp.GetSize())), infinite_distance);
+  for (int y = 0; y != h; y++){
+    const uchar* row = bmp.m_data + y * bmp.m_row_stride;
+    for (int x = 0; x != w; x++){
+      if (row[x * BPP + iA] != 0){
+        d[to_size_t(y * w + x)] = 0.0f;
+      }
+    }
+  }
+
+  EnvelopeBuffers buf(std::max(w, h));
+  for (int x = 0; x != w; x++){
+    distance_1d(d.data() + x, h, w, buf);
+  }
+  for (int y = 0; y != h; y++){
+    distance_1d(d.data() + y * w, w, 1, buf);
+  }
+  return d;
+}
+
+} // namespace
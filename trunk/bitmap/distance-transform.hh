@@ -0,0 +1,34 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FAINT_DISTANCE_TRANSFORM_HH
+#define FAINT_DISTANCE_TRANSFORM_HH
+#include <vector>
+
+namespace faint{
+
+class Bitmap;
+
+// Returns the squared Euclidean distance from each pixel to the
+// closest pixel with alpha above zero, in row order. The distance is
+// infinity for all pixels if no pixel has alpha above zero.
+//
+// Complexity: O(n) for n pixels (the lower envelope of parabolas
+// method by Felzenszwalb and Huttenlocher).
+std::vector<float> squared_distance_to_opaque(const Bitmap&);
+
+} // namespace
+
+#endif
@@ -14,15 +14,19 @@
 // permissions and limitations under the License.
 
 #include <algorithm>
-#include <unordered_set>
+#include <cstring> // memcpy
+#include <functional>
+#include <limits>
 #include <set> // Fixme: Remove if using unordered_set all over.
 #include "bitmap/alpha-map.hh"
 #include "bitmap/auto-crop.hh"
 #include "bitmap/bitmap.hh"
 #include "bitmap/bitmap-templates.hh"
 #include "bitmap/color.hh"
+#include "bitmap/color-counting.hh"
 #include "bitmap/draw.hh"
 #include "bitmap/pattern.hh"
+#include "bitmap/pixel-view.hh"
 #include "geo/axis.hh"
 #include "geo/geo-func.hh"
 #include "geo/geo-list-points.hh"
@@ -36,6 +40,7 @@
 #include "geo/size.hh"
 #include "util/common-fwd.hh" // Fixme: For axis
 #include "util/optional.hh"
+#include "util/scratch-arena.hh"
 
 namespace faint{
 
@@ -121,29 +126,6 @@ using std::swap;
 
 #define EVER ;;
 
-class color_ptr{
-public:
-  // For fetching rgba values from an uchar-pointer
-  // (Which must be at the correct four-byte offset)
-  uchar& r;
-  uchar& g;
-  uchar& b;
-  uchar& a;
-  color_ptr(uchar* p):
-    r(*(p + iR)),
-    g(*(p + iG)),
-    b(*(p + iB)),
-    a(*(p + iA))
-  {}
-  void Set(const Color& c){
-    r = c.r;
-    g = c.g;
-    b = c.b;
-    a = c.a;
-  }
-  color_ptr& operator=(const color_ptr&) = delete;
-};
-
 class const_color_ptr{
 public:
   // For fetching rgba values from an uchar-pointer
@@ -162,13 +144,6 @@ public:
   const_color_ptr& operator=(const const_color_ptr&) = delete;
 };
 
-bool operator==(const color_ptr& c1, const Color& c2){
-  return c1.r == c2.r &&
-    c1.g == c2.g &&
-    c1.b == c2.b &&
-    c1.a == c2.a;
-}
-
 static int int_abs(int v){
   return v < 0 ? -v : v;
 }
@@ -273,9 +248,7 @@ void scanline_f(Bitmap& bmp, int x0, int x1, int y, const Functor& setPixFunc){
   if (x0 > x1){
     swap(x0,x1);
   }
-  for (int x = x0; x <= x1; x++){
-    setPixFunc(bmp, x, y);
-  }
+  setPixFunc.Span(bmp, x0, y, x1 - x0 + 1);
 }
 
 template<typename Functor>
@@ -820,13 +793,17 @@ void fill_polygon_f(Bitmap& bmp, const Functor& setPixFunc,
       continue;
     }
     std::sort(begin(x_vals), end(x_vals));
-    for (int x = minX; x <= maxX; x++){
-      for (size_t j = 0; j != x_vals.size(); j++){
-        if (x < x_vals[j]){
-          if ((x_vals.size() - j) % 2 != 0) {
-            setPixFunc(bmp, x + 1, y); // Fixme: Why + 1? (Added to fill the insides of polygon edge in gradient panel)
-          }
-          break;
+
+    // Pixel x + 1 is set for each x in [minX, maxX] with an odd number
+    // of x_vals greater than x, i.e. for the x in [x_vals[j - 1],
+    // x_vals[j]) where x_vals.size() - j is odd.
+    // Fixme: Why + 1? (Added to fill the insides of polygon edge in gradient panel)
+    for (size_t j = 0; j != x_vals.size(); j++){
+      if ((x_vals.size() - j) % 2 != 0){
+        const int first = std::max(minX, j == 0 ? minX : x_vals[j - 1]);
+        const int last = std::min(maxX, x_vals[j] - 1);
+        if (first <= last){
+          setPixFunc.Span(bmp, first + 1, y, last - first + 1);
         }
       }
     }
@@ -841,9 +818,7 @@ void fill_rect_f(Bitmap& bmp, const Functor& setPixFunc, const IntRect& r){
   const int y1 = r.Bottom();
 
   for (int y = y0; y <= y1; y++){
-    for (int x = x0; x <= x1; x++){
-      setPixFunc(bmp, x, y);
-    }
+    setPixFunc.Span(bmp, x0, y, x1 - x0 + 1);
   }
 }
 
@@ -859,40 +834,6 @@ void fill_triangle_f(Bitmap& bmp,
   draw_polygon_f(bmp, setPixFunc, v, {1, LineStyle::SOLID});
 }
 
-static Bitmap flip_horizontal(const Bitmap& src){
-  Bitmap dst(src);
-  uchar* pDst = dst.m_data;
-  uchar* pSrc = src.m_data;
-  for (int y = 0; y != src.m_h; y++){
-    for (int x = 0 ; x != src.m_w; x++){
-      int iSrc = y * src.m_row_stride + x * BPP;
-      int iDst = y * dst.m_row_stride + (dst.m_w - 1) * BPP - x * BPP;
-      pDst[ iDst + iR ] = pSrc[iSrc + iR ];
-      pDst[ iDst + iG ] = pSrc[iSrc + iG ];
-      pDst[ iDst + iB ] = pSrc[iSrc + iB ];
-      pDst[ iDst + iA ] = pSrc[iSrc + iA ];
-    }
-  }
-  return dst;
-}
-
-static Bitmap flip_vertical(const Bitmap& src){
-  Bitmap dst(src);
-  uchar* pDst = dst.m_data;
-  uchar* pSrc = src.m_data;
-  for (int y = 0; y != src.m_h; y++){
-    for (int x = 0 ; x != src.m_w; x++){
-      int iSrc = y * src.m_row_stride + x * BPP;
-      int iDst = (dst.m_h - y - 1)* dst.m_row_stride + x * BPP;
-      pDst[ iDst + iR ] = pSrc[iSrc + iR ];
-      pDst[ iDst + iG ] = pSrc[iSrc + iG ];
-      pDst[ iDst + iB ] = pSrc[iSrc + iB ];
-      pDst[ iDst + iA ] = pSrc[iSrc + iA ];
-    }
-  }
-  return dst;
-}
-
 struct IsColor{
   IsColor(const Bitmap& bmp, const Color& c)
     : m_bmp(bmp),
@@ -971,23 +912,16 @@ void blend(const Offsat<Bitmap>& src, DstBmp dst){
   const int xMax = std::min(dstSz.w - x0, src->m_w);
   const int yMax = std::min(dstSz.h - y0, src->m_h);
 
-  const int srcStride = src->GetStride();
-  const int dstStride = dst.GetStride();
-  const uchar* srcData = src->GetRaw();
-  uchar* dstData = dst.GetRaw();
+  using F = BitmapFormat;
+  const auto srcView = pixel_view(src.Get());
+  const auto dstView = pixel_view(dst.Get());
   for (int y = yMin; y != yMax; y++){
-    for (int x = xMin; x != xMax; x++){
-      int srcPos = y * srcStride + x * BPP;
-      int dstPos = (y + y0) * dstStride + (x + x0) * BPP;
-      float alpha = srcData[srcPos + iA];
-      dstData[dstPos + iR] = static_cast<uchar>((srcData[srcPos + iR] * alpha +
-        dstData[dstPos + iR] * (255 - alpha)) / 255);
-      dstData[dstPos + iG] = static_cast<uchar>((srcData[srcPos + iG] * alpha +
-        dstData[dstPos + iG] * (255 - alpha)) / 255);
-      dstData[dstPos + iB] = static_cast<uchar>((srcData[srcPos + iB] * alpha +
-        dstData[dstPos + iB] * (255 - alpha)) / 255);
-      dstData[dstPos + iA] =
-        std::max(srcData[srcPos + iA], dstData[dstPos + iA]);
+    const uchar* s = srcView.At(xMin, y);
+    uchar* d = dstView.At(xMin + x0, y + y0);
+    for (int i = 0; i != (xMax - xMin) * BPP; i += BPP){
+      const uchar alpha = s[i + F::iA];
+      blend_color_channels<F, F>(s + i, d + i, alpha);
+      d[i + F::iA] = std::max(alpha, d[i + F::iA]);
     }
   }
 }
@@ -1008,90 +942,98 @@ void blend_masked(const Offsat<Bitmap>& src, DstBmp dst,
   const int xMax = std::min(dstSz.w - x0, src->m_w);
   const int yMax = std::min(dstSz.h - y0, src->m_h);
 
-  int srcStride = src->GetStride();
-  int dstStride = dst.GetStride();
-  const uchar* srcData = src->GetRaw();
-  uchar* dstData = dst.GetRaw();
-
+  using F = BitmapFormat;
+  const uint32_t mask = F::Pack(maskColor);
+  const auto srcView = pixel_view(src.Get());
+  const auto dstView = pixel_view(dst.Get());
   for (int y = yMin; y != yMax; y++){
-    for (int x = xMin; x != xMax; x++){
-      int srcPos = y * srcStride + x * BPP;
-       if (srcData[srcPos + iA] == 0 ||
-         (srcData[ srcPos + iA ] == maskColor.a &&
-           srcData[ srcPos + iR ] == maskColor.r &&
-           srcData[ srcPos + iG ] == maskColor.g &&
-           srcData[ srcPos + iB ] == maskColor.b)) {
-         continue;
-       }
-
-      int dstPos = (y + y0) * dstStride + (x + x0) * BPP;
-      uchar alpha = srcData[srcPos + iA];
-      dstData[dstPos + iR] = static_cast<uchar>((srcData[srcPos + iR] * alpha +
-         dstData[dstPos + iR] * (255 - alpha)) / 255);
-      dstData[dstPos + iG] = static_cast<uchar>((srcData[srcPos + iG] * alpha +
-         dstData[dstPos + iG] * (255 - alpha)) / 255);
-      dstData[dstPos + iB] = static_cast<uchar>((srcData[srcPos + iB] * alpha +
-         dstData[dstPos + iB] * (255 - alpha)) / 255);
+    const uchar* s = srcView.At(xMin, y);
+    uchar* d = dstView.At(xMin + x0, y + y0);
+    for (int i = 0; i != (xMax - xMin) * BPP; i += BPP){
+      const uchar alpha = s[i + F::iA];
+      if (alpha != 0 && load_pixel(s + i) != mask){
+        blend_color_channels<F, F>(s + i, d + i, alpha);
+      }
     }
   }
 }
 
-static void blend_pattern(const Offsat<AlphaMapRef>& inAlphaMap, DstBmp dst,
-  const Pattern& p)
+static void visit_alpha_spans(const Offsat<AlphaMapRef>& offsatAlphaMap,
+  const DstBmp& dst,
+  const std::function<void(uchar* dst, int x, int y, int n,
+    const uchar* alpha)>& func)
+{
+  // Calls func for the row spans of the allocated tiles in the alpha
+  // map which are within dst, with x, y in alpha map coordinates and
+  // dst pointing at the corresponding pixel. The alpha is zero
+  // elsewhere, so the rest of dst is unaffected by blending.
+  const AlphaMapRef& alphaMap(offsatAlphaMap.Get());
+  const IntPoint topLeft(offsatAlphaMap.Offset());
+  const IntRect dstRect(-topLeft, dst.GetSize());
+  const int stride = dst.GetStride();
+  uchar* dstData = dst.GetRaw();
+
+  alphaMap.VisitTiles(
+    [&](const IntRect& tileRect, const uchar* values, int valueStride){
+      const IntRect r(intersection(tileRect, dstRect));
+      if (empty(r)){
+        return;
+      }
+      const uchar* alpha = values + (r.y - tileRect.y) * valueStride +
+        (r.x - tileRect.x);
+      for (int y = r.y; y != r.y + r.h; y++){
+        func(dstData + (y + topLeft.y) * stride + (r.x + topLeft.x) * BPP,
+          r.x, y, r.w, alpha);
+        alpha += valueStride;
+      }
+    });
+}
+
+template<typename Functor>
+static void blend_span_f(const Offsat<AlphaMapRef>& offsatAlphaMap,
+  DstBmp dst,
+  const Functor& source)
 {
-  const AlphaMapRef& alphaMap = inAlphaMap.Get();
-  auto blendFunc = [&](int x, int y){return alphaMap.Get(x,y);};
+  // Blends the source colors onto dst a row at a time, with the alpha
+  // from the alpha map. The source is evaluated at alpha map
+  // coordinates.
+  visit_alpha_spans(offsatAlphaMap, dst,
+    [&](uchar* dstPx, int x, int y, int n, const uchar* alpha){
+      source.BlendSpan(dstPx, x, y, n, alpha);
+    });
+}
 
-  Bitmap strokeMap(alphaMap.GetSize()); // Fixme: Costly allocation
-  blend_pixels(strokeMap, ColorFromPattern(p), blendFunc);
-  blend(offsat(strokeMap, inAlphaMap.Offset()), dst);
+static void blend_pattern(const Offsat<AlphaMapRef>& alphaMap, DstBmp dst,
+  const Pattern& p)
+{
+  blend_span_f(alphaMap, dst, ColorFromPattern(p));
 }
 
-static void blend_gradient(const Offsat<AlphaMapRef>& offsatAlphaMap,
+static void blend_gradient(const Offsat<AlphaMapRef>& alphaMap,
   DstBmp dst,
   const Gradient& g)
 {
-  const AlphaMapRef& alphaMap = offsatAlphaMap.Get();
-  alphaMap.BoundingRect().Visit(
+  alphaMap.Get().BoundingRect().Visit(
     [&](const IntRect& r){
-      Bitmap strokeMap(alphaMap.GetSize()); // Fixme: Costly allocation
-      blend_pixels(strokeMap, ColorFromGradient(g, r),
-        [&](int x, int y){
-          return alphaMap.Get(x,y);});
-      blend(offsat(strokeMap, offsatAlphaMap.Offset()), dst);
+      blend_span_f(alphaMap, dst, ColorFromGradient(g, r));
     });
 }
 
 static void blend_color(const Offsat<AlphaMapRef>& offsatAlphaMap, DstBmp dst,
   const Color& c)
 {
-  const AlphaMapRef& alphaMap(offsatAlphaMap.Get());
-  const IntPoint topLeft(offsatAlphaMap.Offset());
-
-  const int xMin = std::max(0, -topLeft.x);
-  const int yMin = std::max(0, -topLeft.y);
-  IntSize srcSz(alphaMap.GetSize());
-  IntSize dstSz(dst.GetSize());
-  const int xMax = std::min(dstSz.w - topLeft.x, srcSz.w);
-  const int yMax = std::min(dstSz.h - topLeft.y, srcSz.h);
-
-  const int stride = dst.GetStride();
-  uchar* dstData = dst.GetRaw();
-
-  for (int y = yMin; y != yMax; y++){
-    for (int x = xMin; x != xMax; x++){
-      int dstPos = (y + topLeft.y) * stride + (x + topLeft.x) * BPP;
-      uchar alpha = alphaMap.Get(x,y);
-      dstData[dstPos + iR] = static_cast<uchar>((c.r * alpha +
-          dstData[dstPos + iR] * (255 - alpha)) / 255);
-      dstData[dstPos + iG] = static_cast<uchar>((c.g * alpha +
-          dstData[dstPos + iG] * (255 - alpha)) / 255);
-      dstData[dstPos + iB] = static_cast<uchar>((c.b * alpha +
-          dstData[dstPos + iB] * (255 - alpha)) / 255);
-      dstData[dstPos + iA] = static_cast<uchar>((c.a * alpha +
-          dstData[dstPos + iA] * (255 - alpha)) / 255);
-    }
-  }
+  visit_alpha_spans(offsatAlphaMap, dst,
+    [&](uchar* dstPx, int, int, int n, const uchar* alpha){
+      using F = BitmapFormat;
+      uchar src[BPP];
+      store_pixel(src, F::Pack(c));
+      for (int i = 0; i != n; i++){
+        uchar* px = dstPx + i * BPP;
+        const uchar a = alpha[i];
+        blend_color_channels<F, F>(src, px, a);
+        px[F::iA] = static_cast<uchar>((c.a * a + px[F::iA] * (255 - a)) / 255);
+      }
+    });
 }
 
 void blend(const Offsat<AlphaMapRef>& alphaMap, DstBmp dst, const Paint& paint){
@@ -1670,6 +1612,10 @@ void fill_polygon(Bitmap& bmp, const std::vector<IntPoint>& points,
 }
 
 void fill_rect(Bitmap& bmp, const IntRect& r, const Paint& paint){
+  if (paint.IsColor()){
+    fill_rect_color(bmp, r, paint.GetColor());
+    return;
+  }
   DISPATCH(fill_rect_f, paint,
     ColorFromColor(paint.GetColor()),
     ColorFromPattern(paint.GetPattern()),
@@ -1678,11 +1624,29 @@ void fill_rect(Bitmap& bmp, const IntRect& r, const Paint& paint){
 }
 
 void fill_rect_color(Bitmap& bmp, const IntRect& r, const Color& c){
-  fill_rect_f(bmp, ColorFromColor(c), r);
+  const IntRect clipped(intersection(r, rect_from_size(bmp.GetSize())));
+  if (empty(clipped)){
+    return;
+  }
+
+  const uint32_t px = BitmapFormat::Pack(c);
+  uchar* first = bmp.m_data + clipped.y * bmp.m_row_stride + clipped.x * BPP;
+  if (clipped.GetSize() == bmp.GetSize() && bmp.m_row_stride == bmp.m_w * BPP){
+    // Without row padding, the full bitmap is a single span
+    fill_pixels(first, to_size_t(bmp.m_w) * to_size_t(bmp.m_h), px);
+    return;
+  }
+
+  // Fill the first row, and copy it to the others
+  fill_pixels(first, to_size_t(clipped.w), px);
+  const size_t rowBytes = to_size_t(clipped.w * BPP);
+  for (int y = 1; y < clipped.h; y++){
+    memcpy(first + y * bmp.m_row_stride, first, rowBytes);
+  }
 }
 
 void fill_rect_rgb(Bitmap& bmp, const IntRect& r, const ColRGB& c){
-  fill_rect_f(bmp, ColorFromColor(Color(c,255)), r);
+  fill_rect_color(bmp, r, Color(c, 255));
 }
 
 void fill_triangle(Bitmap& bmp, const IntPoint& p0,
@@ -1705,17 +1669,7 @@ void fill_triangle_color(Bitmap& bmp,
   fill_triangle_f(bmp, ColorFromColor(c), p0, p1, p2);
 }
 
-Bitmap flip(const Bitmap& bmp, const along& axis){
-  return axis.Get() == Axis::HORIZONTAL ?
-    flip_horizontal(bmp) :
-    flip_vertical(bmp);
-}
-
-Bitmap flip(const Bitmap& bmp, const across& axis){
-  return axis.Get() == Axis::HORIZONTAL ?
-    flip_vertical(bmp) :
-    flip_horizontal(bmp);
-}
+// Note: flip is implemented in flip-rotate.cpp
 
 void flood_fill_color(Bitmap& bmp, const IntPoint& pos,
   const Color& fillColor)
@@ -1928,21 +1882,13 @@ void flood_fill(Bitmap& bmp, const IntPoint& pos, const Paint& paint){
 }
 
 std::vector<Color> get_palette(const Bitmap& bmp){
-  // Using a set of Color with custom hasher to unsigned int
-  // was a lot slower than just storing unsigned int, at least in
-  // VS2013.
-  std::unordered_set<unsigned int> hashed;
-  for (int y = 0; y != bmp.m_h; y++){
-    for (int x = 0; x != bmp.m_w; x++){
-      hashed.insert(to_hash(get_color_raw(bmp, x, y)));
-    }
-  }
-
   std::vector<Color> colors;
-  colors.reserve(hashed.size());
-  for (auto value : hashed){
-    colors.push_back(color_from_hash(value));
-  }
+  const ColorHistogram histogram(color_histogram(bmp,
+    std::numeric_limits<int>::max()));
+  colors.reserve(to_size_t(histogram.size()));
+  histogram.for_each([&](const Color& c, int){
+    colors.push_back(c);
+  });
   return colors;
 }
 
@@ -1983,14 +1929,14 @@ void rect(Bitmap& bmp, const IntRect& inRect,
 void replace_color_color(Bitmap& bmp, const OldColor& in_oldColor,
   const NewColor& in_newColor)
 {
-  const Color& oldColor(in_oldColor.Get());
-  const Color& newColor(in_newColor.Get());
+  const uint32_t oldColor = BitmapFormat::Pack(in_oldColor.Get());
+  const uint32_t newColor = BitmapFormat::Pack(in_newColor.Get());
+  const auto view = pixel_view(bmp);
   for (int y = 0; y != bmp.m_h; y++){
-    uchar* row = bmp.m_data + y * bmp.m_row_stride;
+    uchar* row = view.Row(y);
     for (int x = 0; x != bmp.m_w * BPP; x += BPP){
-      color_ptr current(row + x);
-      if (current == oldColor){
-        current.Set(newColor);
+      if (load_pixel(row + x) == oldColor){
+        store_pixel(row + x, newColor);
       }
     }
   }
@@ -2040,24 +1986,8 @@ void replace_color(Bitmap& bmp, const OldColor& oldColor, const Paint& paint){
     });
 }
 
-// Note: rotate is implemented in rotate.cpp
-
-Bitmap rotate_90cw(const Bitmap& src){
-  Bitmap dst(transposed(src.GetSize()));
-  uchar* pDst = dst.m_data;
-  uchar* pSrc = src.m_data;
-  for (int y = 0; y != src.m_h; y++){
-    for (int x = 0 ; x != src.m_w; x++){
-      int iSrc = y * src.m_row_stride + x * BPP;
-      int iDst = x * dst.m_row_stride + (dst.m_w - y - 1) * BPP;
-      pDst[ iDst + iR ] = pSrc[iSrc + iR ];
-      pDst[ iDst + iG ] = pSrc[iSrc + iG ];
-      pDst[ iDst + iB ] = pSrc[iSrc + iB ];
-      pDst[ iDst + iA ] = pSrc[iSrc + iA ];
-    }
-  }
-  return dst;
-}
+// Note: rotate is implemented in rotate.cpp, the 90 and 180 degree
+// rotations in flip-rotate.cpp
 
 Bitmap scale(const Bitmap& bmp, const Scale& scale, ScaleQuality quality){
   switch (quality){
@@ -2070,14 +2000,23 @@ Bitmap scale(const Bitmap& bmp, const Scale& scale, ScaleQuality quality){
   return Bitmap();
 }
 
-Bitmap scale_bilinear(const Bitmap& src, const Scale& scale){
-  IntSize newSize(constrained(truncated(floated(src.GetSize()) * abs(scale)),
-      min_t(1), min_t(1)));
-  if (newSize == src.GetSize()){
-    return Bitmap(src);
+static void copy_subbitmap(const Bitmap& orig, const IntRect& r, Bitmap& dst){
+  const size_t rowBytes = to_size_t(r.w * BPP);
+  for (int y = 0; y != r.h; y++){
+    memcpy(dst.m_data + y * dst.m_row_stride,
+      orig.m_data + (y + r.y) * orig.m_row_stride + r.x * BPP, rowBytes);
   }
+}
 
-  Bitmap dst(newSize);
+static IntSize scale_bilinear_size(const Bitmap& src, const Scale& scale){
+  return constrained(truncated(floated(src.GetSize()) * abs(scale)),
+    min_t(1), min_t(1));
+}
+
+static void scale_bilinear_onto(const Bitmap& src, const Scale& scale,
+  Bitmap& dst)
+{
+  const IntSize newSize(dst.GetSize());
   const coord x_ratio = floated(src.m_w - 1) / floated(newSize.w);
   const coord y_ratio = floated(src.m_h - 1) / floated(newSize.h);
   const uchar* data = src.m_data;
@@ -2124,19 +2063,41 @@ Bitmap scale_bilinear(const Bitmap& src, const Scale& scale){
   }
 
   if (scale.x < 0){
-    dst = flip_horizontal(dst);
+    flip_in_place(dst, along(Axis::HORIZONTAL));
   }
   if (scale.y < 0) {
-    dst = flip_vertical(dst);
+    flip_in_place(dst, along(Axis::VERTICAL));
+  }
+}
+
+Bitmap scale_bilinear(const Bitmap& src, const Scale& scale){
+  const IntSize newSize(scale_bilinear_size(src, scale));
+  if (newSize == src.GetSize()){
+    return Bitmap(src);
   }
+
+  Bitmap dst(newSize);
+  scale_bilinear_onto(src, scale, dst);
   return dst;
 }
 
-Bitmap scale_nearest(const Bitmap& src, int scale){
-  const int w2 = src.m_w * scale;
-  const int h2 = src.m_h * scale;
+Bitmap scale_bilinear(const Bitmap& src, const Scale& scale,
+  ScratchArena& arena)
+{
+  const IntSize newSize(scale_bilinear_size(src, scale));
+  Bitmap dst(newSize, arena);
+  if (newSize == src.GetSize()){
+    copy_subbitmap(src, rect_from_size(newSize), dst);
+  }
+  else{
+    scale_bilinear_onto(src, scale, dst);
+  }
+  return dst;
+}
 
-  Bitmap scaled(IntSize(w2, h2));
+static void scale_nearest_onto(const Bitmap& src, Bitmap& scaled){
+  const int w2 = scaled.m_w;
+  const int h2 = scaled.m_h;
   int x_ratio = (src.m_w << 16) / scaled.m_w + 1;
   int y_ratio = (src.m_h << 16) / scaled.m_h + 1;
   int x2, y2 ;
@@ -2157,34 +2118,24 @@ Bitmap scale_nearest(const Bitmap& src, int scale){
       *(rDst + 3) = *(rSrc + 3);
     }
   }
-  return scaled;
 }
 
-Bitmap scale_nearest(const Bitmap& src, const Scale& scale){
-  const int w2 = static_cast<int>(src.m_w * scale.x);
-  const int h2 = static_cast<int>(src.m_h * scale.y);
-
-  Bitmap scaled(IntSize(w2, h2));
-  int x_ratio = (src.m_w << 16) / scaled.m_w + 1;
-  int y_ratio = (src.m_h << 16) / scaled.m_h + 1;
-  int x2, y2 ;
-  uchar* p_dst = scaled.m_data;
-  const uchar* p_src = src.m_data;
-
-  for (int i = 0; i< h2; i++){
-    for (int j = 0; j < w2; j++){
-      x2 = ((j*x_ratio)>>16);
-      y2 = ((i*y_ratio)>>16);
+Bitmap scale_nearest(const Bitmap& src, int scale){
+  Bitmap scaled(IntSize(src.m_w * scale, src.m_h * scale));
+  scale_nearest_onto(src, scaled);
+  return scaled;
+}
 
-      uchar* rDst = p_dst + i * (scaled.m_row_stride) + j * BPP;
-      const uchar* rSrc = p_src + y2 * (src.m_row_stride) + x2 * BPP;
+Bitmap scale_nearest(const Bitmap& src, int scale, ScratchArena& arena){
+  Bitmap scaled(IntSize(src.m_w * scale, src.m_h * scale), arena);
+  scale_nearest_onto(src, scaled);
+  return scaled;
+}
 
-      *(rDst + 0) = *rSrc;
-      *(rDst + 1) = *(rSrc + 1);
-      *(rDst + 2) = *(rSrc + 2);
-      *(rDst + 3) = *(rSrc + 3);
-    }
-  }
+Bitmap scale_nearest(const Bitmap& src, const Scale& scale){
+  Bitmap scaled(IntSize(static_cast<int>(src.m_w * scale.x),
+    static_cast<int>(src.m_h * scale.y)));
+  scale_nearest_onto(src, scaled);
   return scaled;
 }
 
@@ -2246,44 +2197,46 @@ Bitmap scaled_subbitmap(const Bitmap& src, const Scale& scale,
 }
 
 void set_alpha(Bitmap& bmp, uchar a){
-  uchar* data = bmp.GetRaw();
-  const int stride = bmp.GetStride();
-  IntSize sz(bmp.GetSize());
+  using F = BitmapFormat;
+  const auto view = pixel_view(bmp);
+  const IntSize sz(view.GetSize());
   for (int y = 0; y != sz.h; y++){
-    for (int x = 0; x != sz.w; x++){
-      int i = y * stride + x * BPP;
-      data[i + iA] = a;
+    uchar* row = view.Row(y);
+    for (int x = 0; x != sz.w * BPP; x += BPP){
+      row[x + F::iA] = a;
     }
   }
 }
 
 Bitmap subbitmap(const Bitmap& orig, const IntRect& r){
-  int origStride = orig.m_row_stride;
-  const uchar* origData = orig.m_data;
-
   Bitmap bmp(r.GetSize());
-  uchar* data = bmp.GetRaw();
-  int destStride = bmp.m_row_stride;
+  copy_subbitmap(orig, r, bmp);
+  return bmp;
+}
 
-  for (int y = 0; y != r.h; y++){
-    for (int x = 0; x != r.w; x++){
-      int dstPos = y * destStride + x * BPP;
-      int srcPos = (y + r.y) * origStride + (x + r.x) * BPP;
-      data[ dstPos ] = origData[ srcPos ];
-      data[ dstPos + 1 ] = origData[ srcPos + 1 ];
-      data[ dstPos + 2 ] = origData[ srcPos + 2 ];
-      data[ dstPos + 3 ] = origData[ srcPos + 3 ];
-    }
-  }
+Bitmap subbitmap(const Bitmap& orig, const IntRect& r, ScratchArena& arena){
+  Bitmap bmp(r.GetSize(), arena);
+  copy_subbitmap(orig, r, bmp);
   return bmp;
 }
 
 void vertical_scanline(Bitmap& bmp, int x, const Color& c){
-  draw_line(bmp, {{x, 0}, {x, bmp.m_h}}, solid_1px(c));
+  if (x < 0 || x >= bmp.m_w){
+    return;
+  }
+  const uint32_t px = BitmapFormat::Pack(c);
+  uchar* p = bmp.m_data + x * BPP;
+  for (int y = 0; y != bmp.m_h; y++, p += bmp.m_row_stride){
+    store_pixel(p, px);
+  }
 }
 
 void horizontal_scanline(Bitmap& bmp, int y, const Color& c){
-  draw_line(bmp, {{0, y}, {bmp.m_w, y}}, solid_1px(c));
+  if (y < 0 || y >= bmp.m_h){
+    return;
+  }
+  fill_pixels(bmp.m_data + y * bmp.m_row_stride, to_size_t(bmp.m_w),
+    BitmapFormat::Pack(c));
 }
 
 } // namespace faint
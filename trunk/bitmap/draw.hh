@@ -34,6 +34,7 @@ class IntRect;
 class IntSize;
 class Interval;
 class Scale;
+class ScratchArena;
 template<typename T> class Offsat;
 
 using NewColor = Order<Color>::New;
@@ -133,6 +134,8 @@ void fill_triangle_color(Bitmap&, const IntPoint&, const IntPoint&,
   const IntPoint&, const Color&);
 Bitmap flip(const Bitmap&, const along&);
 Bitmap flip(const Bitmap&, const across&);
+void flip_in_place(Bitmap&, const along&);
+void flip_in_place(Bitmap&, const across&);
 void flood_fill_color(Bitmap&, const IntPoint&, const Color& fillColor);
 void flood_fill(Bitmap&, const IntPoint&, const Paint&);
 std::vector<Color> get_palette(const Bitmap&);
@@ -153,17 +156,23 @@ Bitmap rotate_nearest(const Bitmap&, const Angle&, const Color& bg);
 Bitmap rotate_bilinear(const Bitmap&, const Angle&, const Paint& bg);
 Bitmap rotate_bilinear(const Bitmap&, const Angle&);
 Bitmap rotate_90cw(const Bitmap&);
+Bitmap rotate_90ccw(const Bitmap&);
+Bitmap rotate_180(const Bitmap&);
 IntSize rotate_scale_bilinear_size(const IntSize& oldSize,
   const Angle&, const Scale&);
 Bitmap rotate_scale_bilinear(const Bitmap&, const Angle&, const Scale&,
   const Paint& bg);
 Bitmap scale(const Bitmap&, const Scale&, ScaleQuality);
 Bitmap scale_bilinear(const Bitmap&, const Scale&);
+Bitmap scale_bilinear(const Bitmap&, const Scale&, ScratchArena&);
 Bitmap scale_nearest(const Bitmap&, int scale);
+Bitmap scale_nearest(const Bitmap&, int scale, ScratchArena&);
 Bitmap scale_nearest(const Bitmap&, const Scale&);
 Bitmap scaled_subbitmap(const Bitmap&, const Scale&, const IntRect&);
 void set_alpha(Bitmap&, uchar);
 Bitmap subbitmap(const Bitmap&, const IntRect&);
+Bitmap subbitmap(const Bitmap&, const IntRect&, ScratchArena&);
+Bitmap transposed(const Bitmap&);
 void vertical_scanline(Bitmap&, int x, const Color&);
 void horizontal_scanline(Bitmap&, int y, const Color&);
 
@@ -15,10 +15,15 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include "bitmap/bitmap-templates.hh"
 #include "bitmap/color.hh"
+#include "bitmap/distance-transform.hh"
+#include "bitmap/draw.hh"
 #include "bitmap/filter.hh"
 #include "bitmap/gaussian-blur.hh"
+#include "bitmap/pinch-whirl.hh"
+#include "bitmap/pixel-view.hh"
 #include "geo/angle.hh"
 #include "geo/padding.hh"
 #include "geo/point.hh"
@@ -40,152 +45,155 @@ public:
 
 class FilterStroke : public Filter{
 public:
-  void Apply(Bitmap& bmp) const override{
-    // Fixme: Allocation, handle OOM
-    Bitmap bg(bmp.GetSize(), color_transparent_white);
-    for (int y = 1; y < bmp.m_h - 1; y++){
-      for (int x = 1; x < bmp.m_w - 1; x++){
-        Color current = get_color_raw(bmp, x, y);
-        Color right(get_color_raw(bmp, x + 1, y));
-        if (current.a == 0 && right.a != 0){
-          fill_ellipse_color(bg,
-            IntRect(IntPoint(x - 3, y - 3), IntSize(7,7)),
-            Color(0,0,0));
-        }
-        else if (current.a != 0 && right.a == 0){
-          fill_ellipse_color(bg,
-            IntRect(IntPoint(x - 3 + 1, y - 3), IntSize(7,7)),
-            Color(0,0,0));
-        }
+  explicit FilterStroke(coord width)
+    : m_width(width)
+  {}
 
-        Color down(get_color_raw(bmp, x, y + 1));
-        if (current.a == 0 && down.a != 0){
-          fill_ellipse_color(bg,
-            IntRect(IntPoint(x - 3, y - 3), IntSize(7,7)),
-            Color(0,0,0));
-        }
-        if (current.a != 0 && down.a == 0){
-          fill_ellipse_color(bg,
-            IntRect(IntPoint(x - 3, y - 3 + 1), IntSize(7,7)),
-            Color(0,0,0));
-        }
-      }
-    }
-    blit_masked(at_top_left(bmp), onto(bg), color_transparent_white);
-    bmp = bg;
+  void Apply(Bitmap& bmp) const override{
+    bmp = with_stroke(bmp, m_width, Color(0,0,0));
   }
 
   Padding GetPadding() const override{
-    return Padding::All(5);
+    return Padding::All(ceiled(m_width) + 1);
   }
-};
 
-static void increase_alpha(Bitmap& bmp, int x, int y, int d){
-  Color c = get_color_raw(bmp, x, y);
-  c.a = static_cast<uchar>(std::min(static_cast<int>(c.a) + d, 255));
-  put_pixel_raw(bmp, x, y, c);
-}
+private:
+  coord m_width;
+};
 
 class FilterShadow : public Filter{
 public:
-  int m_dist;
-  FilterShadow(){
-    m_dist = 9;
-  }
-  void Apply(Bitmap& bmp) const override{
-    // Fixme: Allocation, handle OOM
-    Bitmap bg(bmp.GetSize(), color_transparent_black);
-    const int c1 = 20;
-    const int c2 = 15;
-    const int c3 = 10;
-    const int c4 = 5;
-    for (int y = 0; y < bmp.m_h - m_dist - 5; y++){
-      for (int x = 0; x < bmp.m_w - m_dist - 5; x++){
-        if (get_color_raw(bmp, x, y).a != 0){
-          int x2 = x + m_dist;
-          int y2 = y + m_dist;
-          increase_alpha(bg, x2 + 1, y2, c4);
-          increase_alpha(bg, x2 + 2, y2, c3);
-          increase_alpha(bg, x2 + 3, y2, c4);
-
-          increase_alpha(bg, x2, y2 + 1, c4);
-          increase_alpha(bg, x2 + 1, y2 + 1, c3);
-          increase_alpha(bg, x2 + 2, y2 + 1, c2);
-          increase_alpha(bg, x2 + 3, y2 + 1, c3);
-          increase_alpha(bg, x2 + 4, y2 + 1, c4);
-
-          increase_alpha(bg, x2, y2 + 2, c3);
-          increase_alpha(bg, x2 + 1, y2 + 2, c2);
-          increase_alpha(bg, x2 + 2, y2 + 2, c1);
-          increase_alpha(bg, x2 + 3, y2 + 2, c2);
-          increase_alpha(bg, x2 + 4, y2 + 2, c3);
-
-          increase_alpha(bg, x2, y2 + 3, c4);
-          increase_alpha(bg, x2 + 1, y2 + 3, c3);
-          increase_alpha(bg, x2 + 2, y2 + 3, c2);
-          increase_alpha(bg, x2 + 3, y2 + 3, c3);
-          increase_alpha(bg, x2 + 4, y2 + 3, c4);
-
-          increase_alpha(bg, x2 + 1, y2 + 4, c4);
-          increase_alpha(bg, x2 + 2, y2 + 4, c3);
-          increase_alpha(bg, x2 + 3, y2 + 4, c4);
-        }
-      }
-    }
+  FilterShadow(int distance, coord softness)
+    : m_distance(distance),
+      m_softness(softness)
+  {}
 
-    blit_masked(at_top_left(bmp), onto(bg), color_transparent_white);
-    bmp = bg;
+  void Apply(Bitmap& bmp) const override{
+    bmp = with_shadow(bmp, m_distance, m_softness, Color(0,0,0,200));
   }
 
   Padding GetPadding() const override{
-    return Padding::Right(6 + m_dist) + Padding::Bottom(6 + m_dist);
+    const int extent = m_distance + ceiled(3 * m_softness) + 1;
+    return Padding::Right(extent) + Padding::Bottom(extent);
   }
+
+private:
+  int m_distance;
+  coord m_softness;
 };
 
+Bitmap with_stroke(const Bitmap& src, coord width, const Color& color){
+  // Fixme: Allocation, handle OOM
+  Bitmap dst(src.GetSize(), Color(color.r, color.g, color.b, 0));
+  const std::vector<float> d(squared_distance_to_opaque(src));
+
+  // The stroke edge is width + 0.5 from the center of the closest
+  // opaque pixel. Pixels the edge passes through are partially
+  // covered, which anti-aliases the edge.
+  const coord outer = width + 1.0;
+  const coord outerSq = outer * outer;
+  for (int y = 0; y != dst.m_h; y++){
+    uchar* row = dst.m_data + y * dst.m_row_stride;
+    const float* dRow = d.data() + y * dst.m_w;
+    for (int x = 0; x != dst.m_w; x++){
+      if (dRow[x] < outerSq){
+        const coord coverage = std::min(outer - std::sqrt(dRow[x]), 1.0);
+        row[x * BPP + iA] = static_cast<uchar>(color.a * coverage + 0.5);
+      }
+    }
+  }
+  blend(at_top_left(src), onto(dst));
+  return dst;
+}
+
+Bitmap with_shadow(const Bitmap& src, int distance, coord softness,
+  const Color& color)
+{
+  // Fixme: Allocation, handle OOM
+  const IntSize size(src.GetSize());
+  channel_t alpha(to_size_t(area(size)), 0);
+  for (int y = distance; y < size.h; y++){
+    const uchar* row = src.m_data + (y - distance) * src.m_row_stride;
+    unsigned char* dst = alpha.data() + y * size.w;
+    for (int x = distance; x < size.w; x++){
+      dst[x] = static_cast<unsigned char>(
+        (row[(x - distance) * BPP + iA] * color.a + 127) / 255);
+    }
+  }
+  gaussian_blur_fast(alpha, size, softness);
+
+  Bitmap dst(size);
+  for (int y = 0; y != size.h; y++){
+    uchar* row = dst.m_data + y * dst.m_row_stride;
+    const unsigned char* a = alpha.data() + y * size.w;
+    for (int x = 0; x != size.w; x++){
+      uchar* p = row + x * BPP;
+      p[iR] = color.r;
+      p[iG] = color.g;
+      p[iB] = color.b;
+      p[iA] = a[x];
+    }
+  }
+  blend(at_top_left(src), onto(dst));
+  return dst;
+}
+
+static uchar clip_rgb(coord value){
+  return static_cast<uchar>(std::min(255.0, std::max(0.0, value)));
+}
+
 Bitmap brightness_and_contrast(const Bitmap& src, const brightness_contrast_t& v){
-  double scaledBrightness = v.brightness * 255.0;
+  const double scaledBrightness = v.brightness * 255.0;
   Bitmap dst(src.GetSize());
 
-  for (int y = 0; y != src.m_h; y++){
-    for (int x = 0; x != src.m_w; x++){
-      const auto c = get_color_raw(src, x, y);
-      const auto c2 =
-        color_from_double(c.r * v.contrast + scaledBrightness,
-          c.g * v.contrast + scaledBrightness,
-          c.b * v.contrast + scaledBrightness,
-          c.a);
-      put_pixel_raw(dst, x, y, c2);
+  using F = BitmapFormat;
+  const auto srcView = pixel_view(src);
+  const auto dstView = pixel_view(dst);
+  const IntSize sz(src.GetSize());
+  for (int y = 0; y != sz.h; y++){
+    const uchar* s = srcView.Row(y);
+    uchar* d = dstView.Row(y);
+    for (int x = 0; x != sz.w * BPP; x += BPP){
+      d[x + F::iR] = clip_rgb(s[x + F::iR] * v.contrast + scaledBrightness);
+      d[x + F::iG] = clip_rgb(s[x + F::iG] * v.contrast + scaledBrightness);
+      d[x + F::iB] = clip_rgb(s[x + F::iB] * v.contrast + scaledBrightness);
+      d[x + F::iA] = s[x + F::iA];
     }
   }
   return dst;
 }
 
 void desaturate_simple(Bitmap& bmp){
-  uchar* data = bmp.m_data;
-  for (int y = 0; y != bmp.m_h; y++){
-    for (int x = 0; x != bmp.m_w; x++){
-      int dst = y * bmp.m_row_stride + x * BPP;
-      uchar gray = static_cast<uchar>((data[dst + iR] +
-          data[dst + iG] +
-          data[dst + iB]) / 3);
-      data[dst + iR] = gray;
-      data[dst + iG] = gray;
-      data[dst + iB] = gray;
+  using F = BitmapFormat;
+  const auto view = pixel_view(bmp);
+  const IntSize sz(view.GetSize());
+  for (int y = 0; y != sz.h; y++){
+    uchar* row = view.Row(y);
+    for (int x = 0; x != sz.w * BPP; x += BPP){
+      uchar* px = row + x;
+      const uchar gray = static_cast<uchar>(
+        (px[F::iR] + px[F::iG] + px[F::iB]) / 3);
+      px[F::iR] = gray;
+      px[F::iG] = gray;
+      px[F::iB] = gray;
     }
   }
 }
 
 void desaturate_weighted(Bitmap& bmp){
-  uchar* data = bmp.m_data;
-  for (int y = 0; y != bmp.m_h; y++){
-    for (int x = 0; x != bmp.m_w; x++){
-      int dst = y * bmp.m_row_stride + x * BPP;
-      uchar gray = static_cast<uchar>(0.3 * data[dst + iR] +
-          0.59 * data[dst + iG] +
-          0.11 * data[dst + iB]);
-      data[dst + iR] = gray;
-      data[dst + iG] = gray;
-      data[dst + iB] = gray;
+  using F = BitmapFormat;
+  const auto view = pixel_view(bmp);
+  const IntSize sz(view.GetSize());
+  for (int y = 0; y != sz.h; y++){
+    uchar* row = view.Row(y);
+    for (int x = 0; x != sz.w * BPP; x += BPP){
+      uchar* px = row + x;
+      const uchar gray = static_cast<uchar>(0.3 * px[F::iR] +
+        0.59 * px[F::iG] +
+        0.11 * px[F::iB]);
+      px[F::iR] = gray;
+      px[F::iG] = gray;
+      px[F::iB] = gray;
     }
   }
 }
@@ -229,17 +237,20 @@ void pixelize(Bitmap& bmp, const pixelize_range_t& width){
 void sepia(Bitmap& bmp, int intensity){
   // Modified from:
   // https://groups.google.com/forum/#!topic/comp.lang.java.programmer/nSCnLECxGdA
-  int depth = 20;
-  const IntSize sz = bmp.GetSize();
+  const int depth = 20;
+  using F = BitmapFormat;
+  const auto view = pixel_view(bmp);
+  const IntSize sz = view.GetSize();
 
   for (int y = 0; y != sz.h; y++){
-    for (int x = 0; x != sz.w; x++){
-      Color c = get_color_raw(bmp, x, y);
-      const int gray = (c.r + c.g + c.b) / 3;
-      const int r = std::min(gray + depth * 2, 255);
-      const int g = std::min(gray + depth, 255);
-      const int b = std::max(gray - intensity, 0);
-      put_pixel_raw(bmp, x, y, color_from_ints(r,g,b, c.a));
+    uchar* row = view.Row(y);
+    for (int x = 0; x != sz.w * BPP; x += BPP){
+      uchar* px = row + x;
+      const int gray = (px[F::iR] + px[F::iG] + px[F::iB]) / 3;
+      px[F::iR] = static_cast<uchar>(std::min(gray + depth * 2, 255));
+      px[F::iG] = static_cast<uchar>(std::min(gray + depth, 255));
+      px[F::iB] = static_cast<uchar>(
+        std::min(std::max(gray - intensity, 0), 255));
     }
   }
 }
@@ -256,84 +267,118 @@ void threshold(Bitmap& bmp, const threshold_range_t& range, const Paint& in, con
     });
 }
 
-std::vector<int> threshold_histogram(const Bitmap& bmp){
-  std::vector<int> v(766, 0);
-  for (int y = 0; y != bmp.m_h; y++){
-    for (int x = 0; x != bmp.m_w; x++){
-      Color c(get_color_raw(bmp, x, y));
-      v[c.r + c.g + c.b] += 1;
+template<typename F, typename Func>
+static std::vector<int> histogram(const ConstPixelView<F>& view, size_t bins,
+  const Func& binOf)
+{
+  std::vector<int> v(bins, 0);
+  const IntSize sz(view.GetSize());
+  for (int y = 0; y != sz.h; y++){
+    const uchar* row = view.Row(y);
+    for (int x = 0; x != sz.w * BPP; x += BPP){
+      v[binOf(row + x)] += 1;
     }
   }
   return v;
 }
 
+std::vector<int> threshold_histogram(const Bitmap& bmp){
+  using F = BitmapFormat;
+  return histogram(pixel_view(bmp), 766,
+    [](const uchar* px){
+      return px[F::iR] + px[F::iG] + px[F::iB];
+    });
+}
+
+static uchar subtract(uchar lhs, uchar rhs){
+  return static_cast<uchar>(lhs > rhs ? lhs - rhs : 0);
+}
+
 Bitmap subtract(const Bitmap& lhs, const Bitmap& rhs){
   assert(lhs.GetSize() == rhs.GetSize());
   Bitmap dst(lhs.GetSize());
+  const auto l = pixel_view(lhs);
+  const auto r = pixel_view(rhs);
+  const auto d = pixel_view(dst);
   for (int y = 0; y != lhs.m_h; y++){
-    for (int x = 0; x != lhs.m_w; x++){
-      put_pixel_raw(dst, x, y,
-        subtract(get_color_raw(lhs, x, y), get_color_raw(rhs, x, y)));
+    const uchar* lRow = l.Row(y);
+    const uchar* rRow = r.Row(y);
+    uchar* dRow = d.Row(y);
+    for (int i = 0; i != lhs.m_w * BPP; i++){
+      dRow[i] = subtract(lRow[i], rRow[i]);
     }
   }
   return dst;
 }
 
-Bitmap add(const Bitmap& lhs, const Bitmap& rhs){
-  assert(lhs.GetSize() == rhs.GetSize());
-  Bitmap dst(lhs.GetSize());
-  for (int y = 0; y != lhs.m_h; y++){
-    for (int x = 0; x != lhs.m_w; x++){
-      put_pixel_raw(dst, x, y,
-        add(get_color_raw(lhs, x, y), get_color_raw(rhs, x, y)));
+static uchar sharpened(uchar src, uchar blurred, const unsharp_mask_t& p){
+  const int diff = static_cast<int>(src) - static_cast<int>(blurred);
+  if (std::abs(diff) < p.threshold){
+    return src;
+  }
+  const int value = rounded(src + p.amount * diff);
+  return static_cast<uchar>(std::max(0, std::min(value, 255)));
+}
+
+static void sharpen_rows(const Bitmap& src, const Bitmap& blurred, int y0,
+  const unsharp_mask_t& p, Bitmap& dst)
+{
+  // Combines the source with the blurred rows starting at y0, so that
+  // the difference is never stored.
+  for (int y = 0; y != blurred.m_h; y++){
+    const uchar* s = src.m_data + (y0 + y) * src.m_row_stride;
+    const uchar* b = blurred.m_data + y * blurred.m_row_stride;
+    uchar* d = dst.m_data + (y0 + y) * dst.m_row_stride;
+    for (int x = 0; x != src.m_w * BPP; x += BPP){
+      d[x + iR] = sharpened(s[x + iR], b[x + iR], p);
+      d[x + iG] = sharpened(s[x + iG], b[x + iG], p);
+      d[x + iB] = sharpened(s[x + iB], b[x + iB], p);
+      d[x + iA] = s[x + iA];
     }
   }
+}
+
+Bitmap unsharp_mask(const Bitmap& src, const unsharp_mask_t& p){
+  // Fixme: Allocation, handle OOM
+  Bitmap dst(src.GetSize());
+  const int bandHeight = 64;
+  gaussian_blur_fast_bands(src, p.sigma, bandHeight,
+    [&](const Bitmap& blurred, int y0){
+      sharpen_rows(src, blurred, y0, p, dst);
+    });
   return dst;
 }
 
 Bitmap unsharp_mask_fast(const Bitmap& bmp, double blurSigma){
-  Bitmap blurred = gaussian_blur_fast(bmp, blurSigma);
-  Bitmap usm = subtract(bmp, blurred);
-  return add(bmp, usm);
+  return unsharp_mask(bmp, unsharp_mask_t(blurSigma));
 }
 
 Bitmap unsharp_mask_exact(const Bitmap& bmp, double blurSigma){
-  Bitmap blurred = gaussian_blur_exact(bmp, blurSigma);
-  Bitmap usm = subtract(bmp, blurred);
-  return add(bmp, usm);
+  Bitmap dst(bmp.GetSize());
+  sharpen_rows(bmp, gaussian_blur_exact(bmp, blurSigma), 0,
+    unsharp_mask_t(blurSigma), dst);
+  return dst;
 }
 
-std::vector<int> red_histogram(Bitmap& bmp){
-  std::vector<int> v(256,0);
-  for (int y = 0; y != bmp.m_h; y++){
-    for (int x = 0; x != bmp.m_w; x++){
-      Color c(get_color_raw(bmp, x, y));
-      v[c.r] += 1;
-    }
-  }
-  return v;
+std::vector<int> red_histogram(const Bitmap& bmp){
+  return histogram(pixel_view(bmp), 256,
+    [](const uchar* px){
+      return px[BitmapFormat::iR];
+    });
 }
 
-std::vector<int> green_histogram(Bitmap& bmp){
-  std::vector<int> v(256,0);
-  for (int y = 0; y != bmp.m_h; y++){
-    for (int x = 0; x != bmp.m_w; x++){
-      Color c(get_color_raw(bmp, x, y));
-      v[c.g] += 1;
-    }
-  }
-  return v;
+std::vector<int> green_histogram(const Bitmap& bmp){
+  return histogram(pixel_view(bmp), 256,
+    [](const uchar* px){
+      return px[BitmapFormat::iG];
+    });
 }
 
-std::vector<int> blue_histogram(Bitmap& bmp){
-  std::vector<int> v(256,0);
-  for (int y = 0; y != bmp.m_h; y++){
-    for (int x = 0; x != bmp.m_w; x++){
-      Color c(get_color_raw(bmp, x, y));
-      v[c.b] += 1;
-    }
-  }
-  return v;
+std::vector<int> blue_histogram(const Bitmap& bmp){
+  return histogram(pixel_view(bmp), 256,
+    [](const uchar* px){
+      return px[BitmapFormat::iB];
+    });
 }
 
 Filter* get_invert_filter(){
@@ -341,11 +386,19 @@ Filter* get_invert_filter(){
 }
 
 Filter* get_stroke_filter(){
-  return new FilterStroke();
+  return get_stroke_filter(3.0);
+}
+
+Filter* get_stroke_filter(coord width){
+  return new FilterStroke(width);
 }
 
 Filter* get_shadow_filter(){
-  return new FilterShadow();
+  return get_shadow_filter(11, 1.0);
+}
+
+Filter* get_shadow_filter(int distance, coord softness){
+  return new FilterShadow(distance, softness);
 }
 
 void pixelize_5(Bitmap& bmp){
@@ -358,21 +411,20 @@ Filter* get_pixelize_filter(){
 }
 
 void invert(Bitmap& bmp){
-  for (int y = 0; y != bmp.m_h; y++){
-    uchar* data = bmp.m_data + y * bmp.m_row_stride;
-    for (int x = 0; x != bmp.m_w * BPP; x += BPP){
-      uchar* pos = data + x;
-      *(pos + iR) = static_cast<uchar>(255 - *(pos + iR));
-      *(pos + iG) = static_cast<uchar>(255 - *(pos + iG));
-      *(pos + iB) = static_cast<uchar>(255 - *(pos + iB));
+  using F = BitmapFormat;
+  const auto view = pixel_view(bmp);
+  // 255 - c is c with all bits flipped, so whole pixels can be
+  // inverted with one xor, keeping the alpha.
+  const uint32_t colorBits = F::Pack(255, 255, 255, 0);
+  const IntSize sz(view.GetSize());
+  for (int y = 0; y != sz.h; y++){
+    uchar* row = view.Row(y);
+    for (int x = 0; x != sz.w * BPP; x += BPP){
+      store_pixel(row + x, load_pixel(row + x) ^ colorBits);
     }
   }
 }
 
-static uchar clip_rgb(coord value){
-  return static_cast<uchar>(std::min(255.0, std::max(0.0, value)));
-}
-
 void color_balance(Bitmap& bmp,
   const color_range_t& r,
   const color_range_t& g,
@@ -396,52 +448,21 @@ void color_balance(Bitmap& bmp,
   double Xb = (U-L) / (Bb-Ab);
   double Yb = L - Ab*((U-L)/ (Bb-Ab));
 
+  using F = BitmapFormat;
+  const auto view = pixel_view(bmp);
   for (int y = 0; y != bmp.m_h; y++){
-    uchar* row = bmp.m_data + y * bmp.m_row_stride;
+    uchar* row = view.Row(y);
     for (int x = 0; x != bmp.m_w * BPP; x += BPP){
       uchar* pos = row + x;
-      *(pos + iR) = clip_rgb(*(pos + iR) * Xr + Yr);
-      *(pos + iG) = clip_rgb(*(pos + iG) * Xg + Yg);
-      *(pos + iB) = clip_rgb(*(pos + iB) * Xb + Yb);
+      pos[F::iR] = clip_rgb(pos[F::iR] * Xr + Yr);
+      pos[F::iG] = clip_rgb(pos[F::iG] * Xg + Yg);
+      pos[F::iB] = clip_rgb(pos[F::iB] * Xb + Yb);
     }
   }
 }
 
-template<typename T>
-T sq(T v){
-  return v*v;
-}
-
-static IntPoint whirled(const Point& p, const Point& c, coord r,
-  const Angle& whirl)
-{
-  const Angle angle = whirl * sq(1.0 - r);
-  coord sina = sin(angle);
-  coord cosa = cos(angle);
-  return IntPoint(truncated(cosa * p.x - sina * p.y + c.x),
-    truncated(sina * p.x + cosa * p.y + c.y));
-}
-
 void filter_pinch_whirl(Bitmap& bmp, coord pinch, const Angle& whirl){
-  Bitmap bmpOld(bmp);
-  Point c((bmp.m_w - 1) / 2.0, (bmp.m_h - 1) / 2.0);
-  coord r2 = sq(bmp.m_w / 2.0);
-
-  for (int y = 0; y != bmp.m_h; y++){
-    for (int x = 0; x != bmp.m_w; x++){
-      Point delta(x - c.x, y - c.y);
-      coord d = sq(delta.x) + sq(delta.y);
-
-      if (d < r2){
-        coord dist = sqrt(d / 1.0) / (bmp.m_w / 2.0);
-        delta *= pow(sin(pi/2*dist), pinch);
-        IntPoint p2 = whirled(delta, c, dist, whirl);
-        if (p2.x > 0 && p2.y > 0 && p2.x < bmp.m_w && p2.y < bmp.m_h){
-          put_pixel_raw(bmp, x, y, get_color(bmpOld, p2));
-        }
-      }
-    }
-  }
+  bmp = pinch_whirl_field(bmp.GetSize(), pinch, whirl)->Apply(bmp);
 }
 
 void filter_pinch_whirl_forward(Bitmap& bmp){
@@ -50,14 +50,54 @@ void pixelize(Bitmap&, const pixelize_range_t&);
 
 void sepia(Bitmap&, int intensity);
 Bitmap subtract(const Bitmap& lhs, const Bitmap& rhs);
+
+class unsharp_mask_t{
+  // Parameters for unsharp_mask.
+public:
+  explicit unsharp_mask_t(double sigma, double amount=1.0, int threshold=0)
+    : sigma(sigma), amount(amount), threshold(threshold)
+  {}
+
+  // The sigma of the gaussian blur which is subtracted
+  double sigma;
+
+  // The factor for the difference from the blurred image
+  double amount;
+
+  // The least difference from the blurred image for a color channel
+  // to be sharpened, to avoid sharpening noise
+  int threshold;
+};
+
+// Sharpens the color channels by adding the difference from a
+// blurred copy. Computes the blur and the result a band at a time,
+// without storing the blurred image or the difference.
+// Alpha values are copied unmodified from the source image.
+Bitmap unsharp_mask(const Bitmap&, const unsharp_mask_t&);
+
+// Unsharp mask with an amount of 1 and no threshold, using
+// gaussian_blur_fast or gaussian_blur_exact.
 Bitmap unsharp_mask_fast(const Bitmap&, double blurSigma);
 Bitmap unsharp_mask_exact(const Bitmap&, double blurSigma);
 
 Filter* get_shadow_filter();
+Filter* get_shadow_filter(int distance, coord softness);
 Filter* get_invert_filter();
 Filter* get_pinch_whirl_filter();
 Filter* get_pixelize_filter();
 Filter* get_stroke_filter();
+Filter* get_stroke_filter(coord width);
+
+// Returns the bitmap drawn over a stroke of the color, reaching width
+// pixels outside the pixels with alpha above zero.
+// Complexity: O(n) for n pixels (unaffected by the width).
+Bitmap with_stroke(const Bitmap&, coord width, const Color&);
+
+// Returns the bitmap drawn over its shadow in the color, offset
+// distance pixels right and down, blurred with softness as sigma.
+// Complexity: O(n) for n pixels (unaffected by distance and softness).
+Bitmap with_shadow(const Bitmap&, int distance, coord softness,
+  const Color&);
 void invert(Bitmap&);
 
 using color_range_t = StaticBoundedInterval<0,255>;
@@ -67,6 +107,9 @@ void color_balance(Bitmap&,
   const color_range_t& g,
   const color_range_t& b);
 
+// Pinches and whirls the bitmap around its center, within a circle
+// with the diameter of the bitmap width. The displacement field is
+// reused while the size and parameters are unchanged.
 void filter_pinch_whirl(Bitmap& bmp, coord pinch, const Angle& whirl);
 
 using threshold_range_t = StaticBoundedInterval<0,765>;
@@ -75,9 +118,9 @@ void threshold(Bitmap&, const threshold_range_t&,
 
 std::vector<int> threshold_histogram(const Bitmap&);
 
-std::vector<int> red_histogram(Bitmap&);
-std::vector<int> green_histogram(Bitmap&);
-std::vector<int> blue_histogram(Bitmap&);
+std::vector<int> red_histogram(const Bitmap&);
+std::vector<int> green_histogram(const Bitmap&);
+std::vector<int> blue_histogram(const Bitmap&);
 
 } // namespace
 
@@ -0,0 +1,176 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include "bitmap/bitmap.hh"
+#include "bitmap/draw.hh"
+#include "bitmap/pixel-view.hh"
+#include "geo/axis.hh"
+#include "geo/int-size.hh"
+#include "util/parallel.hh"
+
+namespace faint{
+
+// Pixels per side of the blocks for the transposing kernels. A row
+// of a block is a 64 byte cache line.
+static const int block_size = 16;
+
+template<bool REVERSE_X, bool REVERSE_Y>
+static Bitmap transposing_copy(const Bitmap& src){
+  // Copies the source pixel x,y to y,x in the destination, mirrored
+  // horizontally and/or vertically after transposing. The copy is done
+  // in square blocks, so that both the source rows and destination
+  // rows of a block stay in cache.
+  Bitmap dst(transposed(src.GetSize()));
+  const int w = src.m_w;
+  const int h = src.m_h;
+  const int numBlockRows = (h + block_size - 1) / block_size;
+
+  parallel_for(numBlockRows, 1, [&](int firstBlockRow, int endBlockRow){
+    for (int by = firstBlockRow; by != endBlockRow; by++){
+      const int y0 = by * block_size;
+      const int y1 = std::min(y0 + block_size, h);
+      for (int x0 = 0; x0 < w; x0 += block_size){
+        const int x1 = std::min(x0 + block_size, w);
+        for (int x = x0; x != x1; x++){
+          const int dy = REVERSE_Y ? w - 1 - x : x;
+          uchar* dstRow = dst.m_data + dy * dst.m_row_stride;
+          const uchar* srcColumn = src.m_data + x * BPP;
+          for (int y = y0; y != y1; y++){
+            const int dx = REVERSE_X ? h - 1 - y : y;
+            store_pixel(dstRow + dx * BPP,
+              load_pixel(srcColumn + y * src.m_row_stride));
+          }
+        }
+      }
+    }
+  });
+  return dst;
+}
+
+static void reverse_row(uchar* row, int w){
+  uchar* left = row;
+  uchar* right = row + (w - 1) * BPP;
+  for (; left < right; left += BPP, right -= BPP){
+    const uint32_t v = load_pixel(left);
+    store_pixel(left, load_pixel(right));
+    store_pixel(right, v);
+  }
+}
+
+static void reversed_row_copy(const uchar* src, uchar* dst, int w){
+  const uchar* srcPixel = src + (w - 1) * BPP;
+  for (int x = 0; x != w; x++, srcPixel -= BPP){
+    store_pixel(dst + x * BPP, load_pixel(srcPixel));
+  }
+}
+
+static Bitmap flip_horizontal(const Bitmap& src){
+  Bitmap dst(src.GetSize());
+  for (int y = 0; y != src.m_h; y++){
+    reversed_row_copy(src.m_data + y * src.m_row_stride,
+      dst.m_data + y * dst.m_row_stride, src.m_w);
+  }
+  return dst;
+}
+
+static Bitmap flip_vertical(const Bitmap& src){
+  Bitmap dst(src.GetSize());
+  const size_t rowBytes = static_cast<size_t>(src.m_w * BPP);
+  for (int y = 0; y != src.m_h; y++){
+    std::memcpy(dst.m_data + (src.m_h - 1 - y) * dst.m_row_stride,
+      src.m_data + y * src.m_row_stride, rowBytes);
+  }
+  return dst;
+}
+
+static void flip_horizontal_in_place(Bitmap& bmp){
+  for (int y = 0; y != bmp.m_h; y++){
+    reverse_row(bmp.m_data + y * bmp.m_row_stride, bmp.m_w);
+  }
+}
+
+static void flip_vertical_in_place(Bitmap& bmp){
+  const int rowBytes = bmp.m_w * BPP;
+  for (int y = 0; y < bmp.m_h / 2; y++){
+    uchar* top = bmp.m_data + y * bmp.m_row_stride;
+    uchar* bottom = bmp.m_data + (bmp.m_h - 1 - y) * bmp.m_row_stride;
+
+    // Swap the rows in chunks via a small buffer, so that the copying
+    // is done with memcpy instead of byte-wise
+    uchar buffer[block_size * block_size * BPP];
+    for (int x = 0; x < rowBytes; x += static_cast<int>(sizeof(buffer))){
+      const size_t n = std::min(sizeof(buffer), size_t(rowBytes - x));
+      std::memcpy(buffer, top + x, n);
+      std::memcpy(top + x, bottom + x, n);
+      std::memcpy(bottom + x, buffer, n);
+    }
+  }
+}
+
+Bitmap flip(const Bitmap& bmp, const along& axis){
+  return axis.Get() == Axis::HORIZONTAL ?
+    flip_horizontal(bmp) :
+    flip_vertical(bmp);
+}
+
+Bitmap flip(const Bitmap& bmp, const across& axis){
+  return axis.Get() == Axis::HORIZONTAL ?
+    flip_vertical(bmp) :
+    flip_horizontal(bmp);
+}
+
+void flip_in_place(Bitmap& bmp, const along& axis){
+  if (axis.Get() == Axis::HORIZONTAL){
+    flip_horizontal_in_place(bmp);
+  }
+  else{
+    flip_vertical_in_place(bmp);
+  }
+}
+
+void flip_in_place(Bitmap& bmp, const across& axis){
+  if (axis.Get() == Axis::HORIZONTAL){
+    flip_vertical_in_place(bmp);
+  }
+  else{
+    flip_horizontal_in_place(bmp);
+  }
+}
+
+Bitmap rotate_90cw(const Bitmap& src){
+  return transposing_copy<true, false>(src);
+}
+
+Bitmap rotate_90ccw(const Bitmap& src){
+  return transposing_copy<false, true>(src);
+}
+
+Bitmap rotate_180(const Bitmap& src){
+  Bitmap dst(src.GetSize());
+  for (int y = 0; y != src.m_h; y++){
+    reversed_row_copy(src.m_data + y * src.m_row_stride,
+      dst.m_data + (src.m_h - 1 - y) * dst.m_row_stride, src.m_w);
+  }
+  return dst;
+}
+
+Bitmap transposed(const Bitmap& src){
+  return transposing_copy<false, false>(src);
+}
+
+} // namespace
@@ -14,11 +14,15 @@
 // permissions and limitations under the License.
 
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <vector>
 #include "geo/primitive.hh"
 #include "bitmap/channel.hh"
 #include "bitmap/gaussian-blur.hh"
+#include "bitmap/planar-image.hh"
+#include "util/parallel.hh"
+#include "util/scratch-arena.hh"
 
 namespace faint{
 
@@ -46,94 +50,230 @@ static std::vector<int> boxes_for_gauss(double sigma, int n){
   return sizes;
 }
 
-static void box_blur_H(channel_t& scl, channel_t& tcl, const IntSize& size, int r){
-  auto iarr = 1.0 / (r+r+1);
-  for(int i = 0; i != size.h; i++){
-    auto ti = i*size.w;
-    auto li = ti;
-    auto ri = ti+r;
-    auto fv = scl[to_size_t(ti)];
-    auto lv = scl[to_size_t(ti+size.w-1)];
-    auto val = (r+1)*fv;
-
-    for(int j=0; j<r; j++){
-      val += scl[to_size_t(ti+j)];
-    }
-    for(int j=0; j<=r; j++){
-      val += scl[to_size_t(ri++)] - fv;
-      tcl[to_size_t(ti++)] = static_cast<unsigned char>(rounded(val*iarr));
-    }
-    for(int j=r+1; j<size.w-r; j++){
-      val += scl[to_size_t(ri++)] - scl[to_size_t(li++)];
-      tcl[to_size_t(ti++)] = static_cast<unsigned char>(rounded(val*iarr));
-    }
-    for(int j = size.w - r; j != size.w; j++){
-      val += lv- scl[to_size_t(li++)];
-      tcl[to_size_t(ti++)] = static_cast<unsigned char>(rounded(val*iarr));
-    }
+static void box_blur_line(const uchar* src, uchar* dst, int n, int stride,
+  int r)
+{
+  // Box blurs n values separated by stride, extending the edge values
+  // beyond the ends.
+  const int last = n - 1;
+  auto at = [&](int i){
+    return static_cast<int>(src[std::max(0, std::min(i, last)) * stride]);
+  };
+
+  const int width = 2 * r + 1;
+  int val = (r + 1) * at(0);
+  for (int j = 0; j != r; j++){
+    val += at(j);
+  }
+  for (int i = 0; i != n; i++){
+    val += at(i + r) - at(i - r - 1);
+    dst[i * stride] = static_cast<uchar>((val + width / 2) / width);
   }
 }
 
-static void box_blur_T(channel_t& scl, channel_t& tcl, const IntSize& size, int r){
-  auto iarr = 1.0 / (r+r+1); // Fixme: ?
-  for(int i=0; i != size.w; i++){
-    auto ti = i;
-    auto li = ti;
-    auto ri = ti + r * size.w;
-    auto fv = scl[to_size_t(ti)];
-    auto lv = scl[to_size_t(ti+size.w * (size.h - 1))];
-    auto val = (r + 1) * fv;
-    for(int j = 0; j != r; j++){
-      val += scl[to_size_t(ti + j * size.w)];
-    }
+static std::vector<int> box_radii(double sigma){
+  std::vector<int> radii;
+  for (int box : boxes_for_gauss(sigma, 3)){
+    radii.push_back(std::max(0, (box - 1) / 2));
+  }
+  return radii;
+}
 
-    for(int j = 0; j <=r; j++){
-      val += scl[to_size_t(ri)] - fv;
-      tcl[to_size_t(ti)] = static_cast<unsigned char>(rounded(val*iarr));
-      ri += size.w;
-      ti += size.w;
-    }
+class BoxBlurScratch{
+  // Buffers for blurring a plane in place
+public:
+  BoxBlurScratch(const IntSize& size, int maxRadius, ScratchArena& arena)
+    : line(arena.AllocateArray<uchar>(to_size_t(size.w))),
+      rows(arena.AllocateArray<uchar>(
+        to_size_t(size.w * std::min(maxRadius + 1, size.h)))),
+      sums(arena.AllocateArray<int>(to_size_t(size.w)))
+  {}
 
-    for(int j = r + 1; j != size.h - r; j++){
-      val += scl[to_size_t(ri)] - scl[to_size_t(li)];
-      tcl[to_size_t(ti)] = static_cast<unsigned char>(rounded(val*iarr));
-      li += size.w; 
-      ri += size.w; 
-      ti+=size.w;
+  // A copy of the row being blurred horizontally
+  uchar* line;
+
+  // The original values of the most recently blurred rows, as a ring
+  // of radius + 1 rows
+  uchar* rows;
+
+  // The vertical window sums
+  int* sums;
+};
+
+static void box_blur_vertical(const Plane& plane, int r,
+  const BoxBlurScratch& scratch)
+{
+  // Box blurs the plane vertically in place, row by row. The
+  // original values of the rows which have been overwritten, but are
+  // still within the window, are kept in a ring of r + 1 rows.
+  const int w = plane.GetSize().w;
+  const int last = plane.GetSize().h - 1;
+  const int width = 2 * r + 1;
+  int next = 0; // The first row not yet overwritten
+
+  auto source = [&](int y) -> const uchar*{
+    y = std::max(0, std::min(y, last));
+    return y < next ?
+      scratch.rows + (y % (r + 1)) * w :
+      plane.Row(y);
+  };
+
+  int* sums = scratch.sums;
+  std::fill(sums, sums + w, 0);
+  for (int j = -r - 1; j != r; j++){
+    const uchar* values = source(j);
+    for (int k = 0; k != w; k++){
+      sums[k] += values[k];
     }
+  }
 
-    for(int j = size.h - r; j != size.h; j++){
-      val += lv - scl[to_size_t(li)];
-      tcl[to_size_t(ti)] = static_cast<unsigned char>(rounded(val*iarr));
-      li += size.w;
-      ti += size.w;
+  for (int i = 0; i <= last; i++){
+    // The removed row can be the ring row which the current row is
+    // saved to, and the added row can be the current row, so each
+    // value is read before it is overwritten.
+    const uchar* added = source(i + r);
+    const uchar* removed = source(i - r - 1);
+    uchar* saved = scratch.rows + (i % (r + 1)) * w;
+    uchar* out = plane.Row(i);
+    for (int k = 0; k != w; k++){
+      const int sum = sums[k] + added[k] - removed[k];
+      sums[k] = sum;
+      saved[k] = out[k];
+      out[k] = static_cast<uchar>((sum + width / 2) / width);
     }
+    next = i + 1;
   }
 }
 
-static void box_blur(channel_t& scl, channel_t& tcl, const IntSize& size, int r){
-  tcl = scl;
-  box_blur_H(tcl, scl, size, r);
-  box_blur_T(scl, tcl, size, r);
+static void box_blur_plane(const Plane& plane, int r,
+  const BoxBlurScratch& scratch)
+{
+  const IntSize size(plane.GetSize());
+  for (int y = 0; y != size.h; y++){
+    uchar* row = plane.Row(y);
+    std::copy(row, row + size.w, scratch.line);
+    box_blur_line(scratch.line, row, size.w, 1, r);
+  }
+  box_blur_vertical(plane, r, scratch);
 }
 
-static void faux_gauss_blur(channel_t& scl, channel_t& tcl, const IntSize& size,
-  const std::vector<int>& boxes)
+static void faux_gauss_blur(const Plane& plane,
+  const std::vector<int>& radii,
+  const BoxBlurScratch& scratch)
 {
-  box_blur(scl, tcl, size, (boxes[0] - 1) / 2);
-  box_blur(tcl, scl, size, (boxes[1] - 1) / 2);
-  box_blur(scl, tcl, size, (boxes[2] - 1) / 2);
+  if (area(plane.GetSize()) == 0){
+    return;
+  }
+  for (int r : radii){
+    box_blur_plane(plane, r, scratch);
+  }
 }
 
-Bitmap gaussian_blur_fast(const Bitmap& bmp, double r){
-  auto ch = separate_into_channels(bmp);
-  auto ch2 = ch;
-  const auto boxes = boxes_for_gauss(r, 3);
-  faux_gauss_blur(ch.r, ch2.r, bmp.GetSize(), boxes);
-  faux_gauss_blur(ch.g, ch2.g, bmp.GetSize(), boxes);
-  faux_gauss_blur(ch.b, ch2.b, bmp.GetSize(), boxes);
-  faux_gauss_blur(ch.a, ch2.a, bmp.GetSize(), boxes);
-  return combine_into_bitmap(ch2);
+class BlurArena{
+  // The frame arena while painting, rewound when the blur is done, so
+  // that the blurs in a paint reuse the same memory. Otherwise an
+  // arena for the blur.
+public:
+  BlurArena()
+    : m_frame(frame_arena()),
+      m_rewind(m_frame)
+  {}
+
+  ScratchArena& Get(){
+    return m_frame == nullptr ? m_local : *m_frame;
+  }
+
+  BlurArena(const BlurArena&) = delete;
+  BlurArena& operator=(const BlurArena&) = delete;
+private:
+  ScratchArena* m_frame;
+  ScratchArena m_local;
+  ScratchArenaRewind m_rewind;
+};
+
+Bitmap gaussian_blur_fast(const Bitmap& bmp, double sigma){
+  // The channels are blurred in place as planes, so that, besides the
+  // source and the result, only one copy of the image is held.
+  const IntSize size(bmp.GetSize());
+  const auto radii = box_radii(sigma);
+  const int maxRadius = *std::max_element(begin(radii), end(radii));
+
+  BlurArena blurArena;
+  ScratchArena& arena = blurArena.Get();
+  const PlanarImage planes(size, arena);
+  deinterleave(bmp, 0, planes);
+
+  std::vector<BoxBlurScratch> scratch;
+  for (int ch = 0; ch != BPP; ch++){
+    scratch.emplace_back(size, maxRadius, arena);
+  }
+  parallel_for(BPP, 1, [&](int begin, int end){
+    for (int ch = begin; ch != end; ch++){
+      faux_gauss_blur(planes.Channel(ch), radii, scratch[to_size_t(ch)]);
+    }
+  });
+
+  Bitmap dst(size);
+  interleave(planes, dst, 0);
+  return dst;
+}
+
+void gaussian_blur_fast(channel_t& ch, const IntSize& size, double sigma){
+  // The widest box is about 2 * sigma + 3, and must not exceed the
+  // channel.
+  const double maxSigma = (std::min(size.w, size.h) - 3) / 2.0;
+  sigma = std::min(sigma, maxSigma);
+  if (sigma < 0.5){
+    return;
+  }
+  const auto radii = box_radii(sigma);
+  BlurArena arena;
+  const BoxBlurScratch scratch(size,
+    *std::max_element(begin(radii), end(radii)), arena.Get());
+  faux_gauss_blur(Plane(ch.data(), size, size.w), radii, scratch);
+}
+
+void gaussian_blur_fast_bands(const Bitmap& src, double sigma, int bandHeight,
+  const blurred_band_sink_t& sink)
+{
+  assert(bandHeight > 0);
+  const auto radii = box_radii(sigma);
+  const int maxRadius = *std::max_element(begin(radii), end(radii));
+
+  // The number of rows above and below a band which affect it
+  int reach = 0;
+  for (int r : radii){
+    reach += r;
+  }
+
+  BlurArena blurArena;
+  ScratchArena& arena = blurArena.Get();
+  for (int y0 = 0; y0 < src.m_h; y0 += bandHeight){
+    const int y1 = std::min(y0 + bandHeight, src.m_h);
+    const int e0 = std::max(0, y0 - reach);
+    const int e1 = std::min(src.m_h, y1 + reach);
+
+    // Blur the band and the rows within reach of it. Rows beyond the
+    // reach of the band, which are wrong unless at the edge of the
+    // bitmap, do not affect the band.
+    const ScratchArenaRewind rewind(&arena);
+    const IntSize size(src.m_w, e1 - e0);
+    const PlanarImage planes(size, arena);
+    deinterleave(src, e0, planes);
+    std::vector<BoxBlurScratch> scratch;
+    for (int ch = 0; ch != BPP; ch++){
+      scratch.emplace_back(size, maxRadius, arena);
+    }
+    parallel_for(BPP, 1, [&](int begin, int end){
+      for (int ch = begin; ch != end; ch++){
+        faux_gauss_blur(planes.Channel(ch), radii, scratch[to_size_t(ch)]);
+      }
+    });
+
+    Bitmap band(IntSize(src.m_w, y1 - y0));
+    interleave(planes, y0 - e0, y1 - e0, band, 0);
+    sink(band, y0);
+  }
 }
 
 } // namespace
@@ -15,7 +15,9 @@
 
 #ifndef FAINT_GAUSSIAN_BLUR_HH
 #define FAINT_GAUSSIAN_BLUR_HH
+#include <functional>
 #include "bitmap/bitmap.hh"
+#include "bitmap/channel.hh"
 
 namespace faint {
 
@@ -28,6 +30,22 @@ Bitmap gaussian_blur_exact(const Bitmap&, double sigma);
 // Complexity: O(n) for n-pixels (unaffected by sigma).
 Bitmap gaussian_blur_fast(const Bitmap&, double sigma);
 
+// Approximate gaussian blur of a single channel with the given size,
+// in place. The sigma is limited so that the boxes fit within the
+// channel.
+void gaussian_blur_fast(channel_t&, const IntSize&, double sigma);
+
+// Receives a band of the blurred bitmap, and the y-coordinate of the
+// top row of the band.
+using blurred_band_sink_t = std::function<void(const Bitmap&, int)>;
+
+// Blurs the bitmap like gaussian_blur_fast, one band of rows at a
+// time from the top, passing the bands to the sink. Requires memory
+// for a band (and the rows the blur reaches) rather than for the
+// entire bitmap.
+void gaussian_blur_fast_bands(const Bitmap&, double sigma, int bandHeight,
+  const blurred_band_sink_t&);
+
 } // namespace
 
 #endif
@@ -13,6 +13,7 @@
 // implied. See the License for the specific language governing
 // permissions and limitations under the License.
 
+#include <algorithm>
 #include <tuple>
 #include "bitmap/gradient.hh"
 #include "util/either.hh"
@@ -255,17 +256,62 @@ bool RadialGradient::operator>(const RadialGradient& other) const{
   return tupeled(*this) > tupeled(other);
 }
 
+static Color interpolate(const ColorStop& s0, const ColorStop& s1,
+  double offset)
+{
+  const double t = (offset - s0.GetOffset()) /
+    (s1.GetOffset() - s0.GetOffset());
+  const Color c0 = s0.GetColor();
+  const Color c1 = s1.GetColor();
+  auto channel = [t](uchar v0, uchar v1){
+    return v0 + (v1 - v0) * t;
+  };
+  return color_from_double(channel(c0.r, c1.r), channel(c0.g, c1.g),
+    channel(c0.b, c1.b), channel(c0.a, c1.a));
+}
+
+ColorRamp::ColorRamp(const color_stops_t& unsortedStops)
+  : m_colors(static_cast<size_t>(num_entries), color_transparent_black)
+{
+  if (unsortedStops.empty()){
+    return;
+  }
+
+  color_stops_t stops(unsortedStops);
+  std::stable_sort(begin(stops), end(stops),
+    [](const ColorStop& lhs, const ColorStop& rhs){
+      return lhs.GetOffset() < rhs.GetOffset();
+    });
+
+  // Offsets before the first or after the last stop get the color of
+  // that stop, offsets between stops are interpolated.
+  size_t next = 0;
+  for (int i = 0; i != num_entries; i++){
+    const double offset = i / double(num_entries - 1);
+    while (next != stops.size() && stops[next].GetOffset() <= offset){
+      next++;
+    }
+    m_colors[static_cast<size_t>(i)] =
+      next == 0 ? stops.front().GetColor() :
+      next == stops.size() ? stops.back().GetColor() :
+      interpolate(stops[next - 1], stops[next], offset);
+  }
+}
+
 class Gradient::GradientImpl{
 public:
   GradientImpl(const LinearGradient& linear)
-    : gradient(linear)
+    : gradient(linear),
+      ramp(std::make_shared<ColorRamp>(linear.GetStops()))
   {}
 
   GradientImpl(const RadialGradient& radial)
-    : gradient(radial)
+    : gradient(radial),
+      ramp(std::make_shared<ColorRamp>(radial.GetStops()))
   {}
 
   Either<LinearGradient, RadialGradient> gradient;
+  std::shared_ptr<const ColorRamp> ramp;
 };
 
 Gradient::Gradient(const LinearGradient& linear)
@@ -285,6 +331,10 @@ Gradient::~Gradient(){
   // GradientImpl won't compile.
 }
 
+const ColorRamp& Gradient::GetRamp() const{
+  return *m_impl->ramp;
+}
+
 color_stops_t Gradient::GetStops() const{
   return m_impl->gradient.Visit(
     [](const LinearGradient& g){
@@ -98,6 +98,26 @@ private:
   color_stops_t m_stops;
 };
 
+class ColorRamp{
+  // The colors of a gradient at evenly spaced offsets in [0, 1], for
+  // looking up colors without searching the color stops.
+public:
+  explicit ColorRamp(const color_stops_t&);
+
+  // Returns the color at the offset, which is clamped to [0, 1].
+  const Color& At(double offset) const{
+    const double pos = offset * (num_entries - 1) + 0.5;
+    const int i = !(pos > 0.0) ? 0 :
+      pos >= num_entries - 1 ? num_entries - 1 :
+      static_cast<int>(pos);
+    return m_colors[static_cast<size_t>(i)];
+  }
+
+  static const int num_entries = 1024;
+private:
+  std::vector<Color> m_colors;
+};
+
 class Gradient{
 public:
   explicit Gradient(const LinearGradient&);
@@ -106,6 +126,9 @@ public:
   ~Gradient();
   const LinearGradient& GetLinear() const;
   const RadialGradient& GetRadial() const;
+
+  // The color ramp for the stops, shared by copies of the Gradient.
+  const ColorRamp& GetRamp() const;
   color_stops_t GetStops() const;
   bool IsLinear() const;
   bool IsRadial() const;
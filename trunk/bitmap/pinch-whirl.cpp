@@ -0,0 +1,201 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include "bitmap/bitmap.hh"
+#include "bitmap/pinch-whirl.hh"
+#include "geo/geo-func.hh"
+#include "geo/point.hh"
+#include "util/math-constants.hh"
+#include "util/parallel.hh"
+
+namespace faint{
+
+// Rows per parallel work item
+static const int rows_per_job = 16;
+
+// The largest area for which pinch_whirl_field keeps the field
+static const int max_cached_area = 1024 * 1024;
+
+class RadialTable{
+  // The source offset factors for the pinch and whirl, for distances
+  // from the center in [0, 1].
+public:
+  RadialTable(int n, coord pinch, const Angle& whirl)
+    : m_cos(to_size_t(n + 1)),
+      m_sin(to_size_t(n + 1)),
+      m_n(n)
+  {
+    // Limit the scale so that pinching out by a negative amount gives
+    // distant (unused) source positions instead of infinities.
+    const coord maxScale = 1e6;
+    for (int i = 0; i <= n; i++){
+      const coord dist = i / static_cast<coord>(n);
+      const coord scale = std::min(std::pow(std::sin(math::pi / 2 * dist),
+        pinch), maxScale);
+      const Angle angle = whirl * ((1.0 - dist) * (1.0 - dist));
+      m_cos[to_size_t(i)] = scale * cos(angle);
+      m_sin[to_size_t(i)] = scale * sin(angle);
+    }
+  }
+
+  void Get(coord dist, coord& c, coord& s) const{
+    // Linear interpolation between the tabulated distances
+    const coord pos = std::min(dist, 1.0) * m_n;
+    const int i = std::min(static_cast<int>(pos), m_n - 1);
+    const coord t = pos - i;
+    const size_t i0 = to_size_t(i);
+    c = m_cos[i0] + (m_cos[i0 + 1] - m_cos[i0]) * t;
+    s = m_sin[i0] + (m_sin[i0 + 1] - m_sin[i0]) * t;
+  }
+
+private:
+  std::vector<coord> m_cos;
+  std::vector<coord> m_sin;
+  int m_n;
+};
+
+static int upper_rows(const IntSize& size){
+  return (size.h + 1) / 2;
+}
+
+PinchWhirlField::PinchWhirlField(const IntSize& size, coord pinch,
+  const Angle& whirl)
+  : m_pinch(pinch),
+    m_size(size),
+    m_whirl(whirl),
+    m_dx(to_size_t(size.w * upper_rows(size))),
+    m_dy(m_dx.size())
+{
+  const coord radius = size.w / 2.0;
+  if (radius <= 0){
+    return;
+  }
+
+  // A few entries per pixel of radius make the interpolation error
+  // negligible.
+  const RadialTable table(std::max(16, ceiled(radius) * 4), pinch, whirl);
+  const Point c((size.w - 1) / 2.0, (size.h - 1) / 2.0);
+  const coord r2 = radius * radius;
+  const float notMoved = std::numeric_limits<float>::quiet_NaN();
+
+  parallel_for(upper_rows(size), rows_per_job, [&](int y0, int y1){
+    for (int y = y0; y != y1; y++){
+      const coord dy = y - c.y;
+      float* rowX = m_dx.data() + y * size.w;
+      float* rowY = m_dy.data() + y * size.w;
+      for (int x = 0; x != size.w; x++){
+        const coord dx = x - c.x;
+        const coord d2 = dx * dx + dy * dy;
+        if (d2 >= r2){
+          rowX[x] = rowY[x] = notMoved;
+          continue;
+        }
+        coord cosa, sina;
+        table.Get(std::sqrt(d2) / radius, cosa, sina);
+        rowX[x] = static_cast<float>(cosa * dx - sina * dy);
+        rowY[x] = static_cast<float>(sina * dx + cosa * dy);
+      }
+    }
+  });
+}
+
+static void put_bilinear(const Bitmap& src, coord sx, coord sy, uchar* dst){
+  const int x0 = std::min(static_cast<int>(sx), src.m_w - 2);
+  const int y0 = std::min(static_cast<int>(sy), src.m_h - 2);
+  const coord fx = sx - x0;
+  const coord fy = sy - y0;
+  const uchar* p00 = src.m_data + y0 * src.m_row_stride + x0 * BPP;
+  const uchar* p10 = p00 + BPP;
+  const uchar* p01 = p00 + src.m_row_stride;
+  const uchar* p11 = p01 + BPP;
+  for (int i = 0; i != BPP; i++){
+    const coord top = p00[i] + (p10[i] - p00[i]) * fx;
+    const coord bottom = p01[i] + (p11[i] - p01[i]) * fx;
+    dst[i] = static_cast<uchar>(top + (bottom - top) * fy + 0.5);
+  }
+}
+
+Bitmap PinchWhirlField::Apply(const Bitmap& src) const{
+  assert(src.GetSize() == m_size);
+  Bitmap dst(src);
+  if (src.m_w < 2 || src.m_h < 2){
+    return dst;
+  }
+
+  const Point c((m_size.w - 1) / 2.0, (m_size.h - 1) / 2.0);
+  const coord maxX = src.m_w - 1;
+  const coord maxY = src.m_h - 1;
+  const int upper = upper_rows(m_size);
+
+  parallel_for(src.m_h, rows_per_job, [&](int y0, int y1){
+    for (int y = y0; y != y1; y++){
+      // The lower rows are the upper rows rotated half a turn
+      const bool mirrored = y >= upper;
+      const int fieldY = mirrored ? src.m_h - 1 - y : y;
+      const float* rowX = m_dx.data() + fieldY * m_size.w;
+      const float* rowY = m_dy.data() + fieldY * m_size.w;
+      uchar* out = dst.m_data + y * dst.m_row_stride;
+      for (int x = 0; x != src.m_w; x++){
+        const int fieldX = mirrored ? src.m_w - 1 - x : x;
+        const float dx = rowX[fieldX];
+        if (std::isnan(dx)){
+          continue;
+        }
+        const float dy = rowY[fieldX];
+        const coord sx = c.x + (mirrored ? -dx : dx);
+        const coord sy = c.y + (mirrored ? -dy : dy);
+        if (0 <= sx && sx <= maxX && 0 <= sy && sy <= maxY){
+          put_bilinear(src, sx, sy, out + x * BPP);
+        }
+      }
+    }
+  });
+  return dst;
+}
+
+bool PinchWhirlField::Matches(const IntSize& size, coord pinch,
+  const Angle& whirl) const
+{
+  return size == m_size && pinch == m_pinch && whirl == m_whirl;
+}
+
+std::shared_ptr<const PinchWhirlField> pinch_whirl_field(const IntSize& size,
+  coord pinch,
+  const Angle& whirl)
+{
+  static std::mutex mutex;
+  static std::shared_ptr<const PinchWhirlField> last;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (last != nullptr && last->Matches(size, pinch, whirl)){
+      return last;
+    }
+  }
+
+  auto field = std::make_shared<const PinchWhirlField>(size, pinch, whirl);
+  if (area(size) <= max_cached_area){
+    std::lock_guard<std::mutex> lock(mutex);
+    last = field;
+  }
+  return field;
+}
+
+} // namespace
@@ -0,0 +1,64 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FAINT_PINCH_WHIRL_HH
+#define FAINT_PINCH_WHIRL_HH
+#include <memory>
+#include <vector>
+#include "geo/angle.hh"
+#include "geo/int-size.hh"
+
+namespace faint{
+
+class Bitmap;
+
+class PinchWhirlField{
+  // The position each pixel is sampled from when pinching and
+  // whirling a bitmap of a certain size.
+  //
+  // The mapping only depends on the distance from the center, so the
+  // radial functions are tabulated once, and since it is symmetric
+  // through the center, only the upper half is stored.
+public:
+  PinchWhirlField(const IntSize&, coord pinch, const Angle& whirl);
+
+  // Returns the pinched and whirled bitmap, which must have the
+  // size of the field. The source is sampled bilinearly.
+  Bitmap Apply(const Bitmap&) const;
+
+  bool Matches(const IntSize&, coord pinch, const Angle& whirl) const;
+
+private:
+  coord m_pinch;
+  IntSize m_size;
+  Angle m_whirl;
+
+  // Source offsets from the center for the upper rows. Pixels which
+  // are not moved have NaN offsets.
+  std::vector<float> m_dx;
+  std::vector<float> m_dy;
+};
+
+// Returns the field for the parameters, reusing the most recently
+// returned field when the parameters match, e.g. when the preview is
+// recomputed for the same size. Only fields for small sizes are kept,
+// so that a field for a large image is not held after use.
+std::shared_ptr<const PinchWhirlField> pinch_whirl_field(const IntSize&,
+  coord pinch,
+  const Angle& whirl);
+
+} // namespace
+
+#endif
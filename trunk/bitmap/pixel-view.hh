@@ -0,0 +1,186 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+#ifndef FAINT_PIXEL_VIEW_HH
+#define FAINT_PIXEL_VIEW_HH
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include "bitmap/bitmap.hh"
+#include "bitmap/color.hh"
+
+namespace faint{
+
+template<int R, int G, int B, int A, bool PREMULTIPLIED=false>
+class PixelFormat{
+  // Compile-time layout of a 32-bit pixel: the byte offset of each
+  // channel, and whether the colors are premultiplied by the alpha.
+public:
+  static_assert(((1 << R) | (1 << G) | (1 << B) | (1 << A)) == 0xf,
+    "Channel offsets must be a permutation of 0-3");
+
+  static constexpr int iR = R;
+  static constexpr int iG = G;
+  static constexpr int iB = B;
+  static constexpr int iA = A;
+  static constexpr bool premultiplied = PREMULTIPLIED;
+
+  static uint32_t Pack(uchar r, uchar g, uchar b, uchar a){
+    uchar px[BPP];
+    px[R] = r;
+    px[G] = g;
+    px[B] = b;
+    px[A] = a;
+    uint32_t v;
+    std::memcpy(&v, px, BPP);
+    return v;
+  }
+
+  static uint32_t Pack(const Color& c){
+    return Pack(c.r, c.g, c.b, c.a);
+  }
+
+  static Color Unpack(const uchar* px){
+    return Color(px[R], px[G], px[B], px[A]);
+  }
+};
+
+// The layout of faint::Bitmap
+using BitmapFormat = PixelFormat<iR, iG, iB, iA>;
+
+inline uint32_t load_pixel(const uchar* px){
+  uint32_t v;
+  std::memcpy(&v, px, BPP);
+  return v;
+}
+
+inline void store_pixel(uchar* px, uint32_t v){
+  std::memcpy(px, &v, BPP);
+}
+
+// Sets the n consecutive pixels starting at px to the packed value.
+inline void fill_pixels(uchar* px, size_t n, uint32_t v){
+  if (n == 0){
+    return;
+  }
+  const size_t total = n * BPP;
+  const uchar byte = static_cast<uchar>(v & 0xff);
+  if (v == byte * 0x01010101u){
+    // E.g. opaque white or transparent black
+    std::memset(px, byte, total);
+    return;
+  }
+
+  // Store a few pixels, then double the filled part with memcpy,
+  // which uses wide stores for the long runs.
+  const size_t head = std::min(n, size_t(16));
+  for (size_t i = 0; i != head; i++){
+    store_pixel(px + i * BPP, v);
+  }
+  size_t filled = head * BPP;
+  while (filled < total){
+    const size_t count = std::min(filled, total - filled);
+    std::memcpy(px + filled, px, count);
+    filled += count;
+  }
+}
+
+template<typename FORMAT, typename T>
+class BasicPixelView{
+  // Row-wise access to a buffer of 32-bit pixels with the channel
+  // layout of FORMAT. T is uchar for a writable view and const uchar
+  // for a read-only view.
+  //
+  // The view does not own the pixels. Inner loops should step a
+  // pointer from Row(y) by BPP, with the channel offsets from FORMAT,
+  // rather than calling At or Get per pixel.
+public:
+  using format = FORMAT;
+
+  BasicPixelView(T* data, const IntSize& size, int stride)
+    : m_data(data),
+      m_size(size),
+      m_stride(stride)
+  {}
+
+  IntSize GetSize() const{
+    return m_size;
+  }
+
+  T* Row(int y) const{
+    return m_data + y * m_stride;
+  }
+
+  T* At(int x, int y) const{
+    return Row(y) + x * BPP;
+  }
+
+  uint32_t Get(int x, int y) const{
+    return load_pixel(At(x, y));
+  }
+
+  void Set(int x, int y, uint32_t v) const{
+    store_pixel(At(x, y), v);
+  }
+
+private:
+  T* m_data;
+  IntSize m_size;
+  int m_stride;
+};
+
+template<typename FORMAT>
+using PixelView = BasicPixelView<FORMAT, uchar>;
+
+template<typename FORMAT>
+using ConstPixelView = BasicPixelView<FORMAT, const uchar>;
+
+inline PixelView<BitmapFormat> pixel_view(Bitmap& bmp){
+  return PixelView<BitmapFormat>(bmp.m_data, bmp.GetSize(), bmp.m_row_stride);
+}
+
+inline ConstPixelView<BitmapFormat> pixel_view(const Bitmap& bmp){
+  return ConstPixelView<BitmapFormat>(bmp.m_data, bmp.GetSize(),
+    bmp.m_row_stride);
+}
+
+template<typename SRC, typename DST>
+inline void blend_color_channels(const uchar* src, uchar* dst, uchar alpha){
+  // Blends the colors of the src pixel onto the dst pixel with the
+  // given alpha (normally the alpha of src). The alpha channel of dst
+  // is left for the caller, as the blend functions treat it
+  // differently.
+  static_assert(!DST::premultiplied, "Premultiplied destination");
+  if (SRC::premultiplied){
+    const int inverse = 255 - alpha;
+    dst[DST::iR] = static_cast<uchar>(src[SRC::iR] +
+      dst[DST::iR] * inverse / 255);
+    dst[DST::iG] = static_cast<uchar>(src[SRC::iG] +
+      dst[DST::iG] * inverse / 255);
+    dst[DST::iB] = static_cast<uchar>(src[SRC::iB] +
+      dst[DST::iB] * inverse / 255);
+  }
+  else{
+    dst[DST::iR] = static_cast<uchar>((src[SRC::iR] * alpha +
+      dst[DST::iR] * (255 - alpha)) / 255);
+    dst[DST::iG] = static_cast<uchar>((src[SRC::iG] * alpha +
+      dst[DST::iG] * (255 - alpha)) / 255);
+    dst[DST::iB] = static_cast<uchar>((src[SRC::iB] * alpha +
+      dst[DST::iB] * (255 - alpha)) / 255);
+  }
+}
+
+} // namespace
+
+#endif
@@ -0,0 +1,101 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+#include <cassert>
+#include "bitmap/planar-image.hh"
+#include "bitmap/pixel-view.hh"
+#include "util/scratch-arena.hh"
+
+namespace faint{
+
+static int plane_stride(int w){
+  const int alignment = static_cast<int>(scratch_alignment);
+  return (w + alignment - 1) / alignment * alignment;
+}
+
+PlanarImage::PlanarImage(const IntSize& size, ScratchArena& arena)
+  : m_data(nullptr),
+    m_size(size),
+    m_stride(plane_stride(size.w))
+{
+  m_data = arena.AllocateArray<uchar>(to_size_t(BPP * m_stride * size.h));
+}
+
+Plane PlanarImage::Channel(int offset) const{
+  assert(0 <= offset && offset < BPP);
+  return Plane(m_data + offset * m_stride * m_size.h, m_size, m_stride);
+}
+
+IntSize PlanarImage::GetSize() const{
+  return m_size;
+}
+
+void deinterleave(const Bitmap& bmp, int y0, const PlanarImage& planes){
+  const IntSize size(planes.GetSize());
+  assert(size.w == bmp.m_w && y0 + size.h <= bmp.m_h);
+
+  using F = BitmapFormat;
+  const auto view = pixel_view(bmp);
+  const Plane r(planes.Channel(F::iR));
+  const Plane g(planes.Channel(F::iG));
+  const Plane b(planes.Channel(F::iB));
+  const Plane a(planes.Channel(F::iA));
+  for (int y = 0; y != size.h; y++){
+    const uchar* px = view.Row(y0 + y);
+    uchar* rRow = r.Row(y);
+    uchar* gRow = g.Row(y);
+    uchar* bRow = b.Row(y);
+    uchar* aRow = a.Row(y);
+    for (int x = 0; x != size.w; x++, px += BPP){
+      rRow[x] = px[F::iR];
+      gRow[x] = px[F::iG];
+      bRow[x] = px[F::iB];
+      aRow[x] = px[F::iA];
+    }
+  }
+}
+
+void interleave(const PlanarImage& planes, Bitmap& bmp, int y0){
+  interleave(planes, 0, planes.GetSize().h, bmp, y0);
+}
+
+void interleave(const PlanarImage& planes, int first, int last, Bitmap& bmp,
+  int y0)
+{
+  const IntSize size(planes.GetSize());
+  assert(0 <= first && first <= last && last <= size.h);
+  assert(size.w == bmp.m_w && y0 + last - first <= bmp.m_h);
+
+  using F = BitmapFormat;
+  const auto view = pixel_view(bmp);
+  const Plane r(planes.Channel(F::iR));
+  const Plane g(planes.Channel(F::iG));
+  const Plane b(planes.Channel(F::iB));
+  const Plane a(planes.Channel(F::iA));
+  for (int y = first; y != last; y++){
+    uchar* px = view.Row(y0 + y - first);
+    const uchar* rRow = r.Row(y);
+    const uchar* gRow = g.Row(y);
+    const uchar* bRow = b.Row(y);
+    const uchar* aRow = a.Row(y);
+    for (int x = 0; x != size.w; x++, px += BPP){
+      px[F::iR] = rRow[x];
+      px[F::iG] = gRow[x];
+      px[F::iB] = bRow[x];
+      px[F::iA] = aRow[x];
+    }
+  }
+}
+
+} // namespace
@@ -0,0 +1,89 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+#ifndef FAINT_PLANAR_IMAGE_HH
+#define FAINT_PLANAR_IMAGE_HH
+#include "bitmap/bitmap.hh"
+#include "geo/int-size.hh"
+
+namespace faint{
+
+class ScratchArena;
+
+class Plane{
+  // One 8-bit channel of an image, with the rows stride bytes apart.
+  // Does not own the values.
+public:
+  Plane(uchar* data, const IntSize& size, int stride)
+    : m_data(data),
+      m_size(size),
+      m_stride(stride)
+  {}
+
+  uchar* Row(int y) const{
+    return m_data + y * m_stride;
+  }
+
+  IntSize GetSize() const{
+    return m_size;
+  }
+
+  int GetStride() const{
+    return m_stride;
+  }
+
+private:
+  uchar* m_data;
+  IntSize m_size;
+  int m_stride;
+};
+
+class PlanarImage{
+  // An image stored as separate red, green, blue and alpha planes,
+  // for algorithms which work on one channel at a time. Every row of
+  // every plane starts at an aligned address.
+  //
+  // The planes are allocated from a ScratchArena, and are valid until
+  // the arena is reset.
+public:
+  PlanarImage(const IntSize&, ScratchArena&);
+
+  // The plane for the channel at the given offset within a Bitmap
+  // pixel, i.e. iR, iG, iB or iA.
+  Plane Channel(int offset) const;
+
+  IntSize GetSize() const;
+private:
+  uchar* m_data;
+  IntSize m_size;
+  int m_stride;
+};
+
+// Copies the rows of the bitmap starting at y0 into the planes, as
+// many rows as the planes are high. Converting a bitmap a band of
+// rows at a time, with planes for a single band, avoids holding a
+// planar copy of the entire bitmap.
+void deinterleave(const Bitmap&, int y0, const PlanarImage&);
+
+// Copies the planes into the rows of the bitmap starting at y0.
+void interleave(const PlanarImage&, Bitmap&, int y0);
+
+// Copies the plane rows from first up to (but excluding) last into
+// the rows of the bitmap starting at y0, e.g. to leave out rows which
+// were only needed as input for a band.
+void interleave(const PlanarImage&, int first, int last, Bitmap&, int y0);
+
+} // namespace
+
+#endif
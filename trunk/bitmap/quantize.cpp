@@ -42,14 +42,18 @@
  -  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *====================================================================*/
 #include <algorithm>
+#include <atomic>
 #include <cassert>
-#include <cstring> // memcpy
+#include <memory>
+#include <thread>
+#include <vector>
 #include "bitmap/alpha-map.hh"
 #include "bitmap/bitmap.hh"
 #include "bitmap/color.hh"
 #include "bitmap/color-counting.hh"
 #include "bitmap/draw.hh"
 #include "bitmap/quantize.hh"
+#include "util/parallel.hh"
 
 namespace faint{
 
@@ -128,13 +132,16 @@ public:
     }
   }
 
+  IndexTables(const IndexTables&) = delete;
+  IndexTables& operator=(const IndexTables&) = delete;
+
   ~IndexTables(){
     delete[] this->red;
     delete[] this->green;
     delete[] this->blue;
   }
 
-  int GetIndex(const Color& c){
+  int GetIndex(const Color& c) const{
     return static_cast<int>(red[c.r] | green[c.g] | blue[c.b]);
   }
 
@@ -278,6 +285,41 @@ static int pixels_per_cell(int numPixels, int numColors, int reservedColors){
   }
 }
 
+static int min_band_rows(const Bitmap& bmp){
+  // Below this many pixels per band, splitting costs more than it
+  // saves.
+  const int minPixelsPerBand = 1 << 16;
+  return std::max(1, minPixelsPerBand / std::max(1, bmp.m_w));
+}
+
+static std::vector<int> count_samples(const Bitmap& bmp,
+  const IndexTables& tables,
+  int numCells)
+{
+  // Counts the pixels per cell at the lowest level of the octree,
+  // with a separate count per band of rows.
+  const int bandRows = std::max(min_band_rows(bmp),
+    (bmp.m_h + get_concurrency() - 1) / get_concurrency());
+
+  return parallel_reduce(bmp.m_h, bandRows,
+    std::vector<int>(to_size_t(numCells), 0),
+    [&](int y0, int y1){
+      std::vector<int> counts(to_size_t(numCells), 0);
+      for (int y = y0; y != y1; y++){
+        for (int x = 0; x != bmp.m_w; x++){
+          counts[to_size_t(tables.GetIndex(get_color_raw(bmp, x, y)))]++;
+        }
+      }
+      return counts;
+    },
+    [](std::vector<int> total, const std::vector<int>& counts){
+      for (size_t i = 0; i != total.size(); i++){
+        total[i] += counts[i];
+      }
+      return total;
+    });
+}
+
 static Octree* generate_octree(const Bitmap& bmp,
   int requestedNumColors,
   int reservedColors,
@@ -306,12 +348,10 @@ static Octree* generate_octree(const Bitmap& bmp,
   // Accumulate the centers of each cluster at level CQ_NLEVELS
   ColorNode*** colorNode_aa = tree->colorNode_aa;
   ColorNode** cqca = colorNode_aa[CQ_NLEVELS];
-  for (int y = 0; y < sz.h; y++){
-    for (int x = 0; x != sz.w; x++){
-      int octIndex = tables.GetIndex(get_color_raw(bmp, x, y));
-      ColorNode* cell = cqca[octIndex];
-      cell->numSamples++;
-    }
+  const int numCells = 1 << (3 * CQ_NLEVELS);
+  const std::vector<int> samples(count_samples(bmp, tables, numCells));
+  for (int i = 0; i != numCells; i++){
+    cqca[i]->numSamples = samples[to_size_t(i)];
   }
 
   const float thresholdFactor[] = {0.01f, 0.01f, 1.0f, 1.0f, 1.0f, 1.0f};
@@ -405,200 +445,261 @@ static Octree* generate_octree(const Bitmap& bmp,
   return tree;
 }
 
-static void get_rgb_line(const Bitmap& bmp, int y, uchar* r, uchar* g, uchar* b){
-  for (int x = 0; x != bmp.m_w; x++){
-    Color rgb = get_color_raw(bmp, x, y);
-    r[x] = rgb.r;
-    g[x] = rgb.g;
-    b[x] = rgb.b;
+class OctreeLookup{
+  // The leaf of the octree for each cell at the lowest level, i.e.
+  // for each value of IndexTables::GetIndex. For the default depth of
+  // five levels this is a table of the 32K RGB555 colors, which
+  // replaces walking the tree for each pixel.
+public:
+  explicit OctreeLookup(const Octree& tree)
+    : m_tables(tree.CQ_NLEVELS)
+  {
+    const int numCells = 1 << (3 * tree.CQ_NLEVELS);
+    m_index.reserve(to_size_t(numCells));
+    m_center.reserve(to_size_t(numCells));
+    for (int i = 0; i != numCells; i++){
+      const ColorNode& node = tree.findNode(i);
+      assert(node.index < 256);
+      m_index.push_back(static_cast<uchar>(node.index));
+      m_center.push_back(node.center);
+    }
+  }
+
+  int Cell(const Color& c) const{
+    return m_tables.GetIndex(c);
+  }
+
+  const ColRGB& Center(int cell) const{
+    return m_center[to_size_t(cell)];
+  }
+
+  uchar Index(int cell) const{
+    return m_index[to_size_t(cell)];
+  }
+
+private:
+  IndexTables m_tables;
+  std::vector<uchar> m_index;
+  std::vector<ColRGB> m_center;
+};
+
+class DitherRow{
+  // The colors of a row scaled by 64, with the error diffused from
+  // the pixels above and to the left.
+public:
+  explicit DitherRow(int width)
+    : r(to_size_t(width)),
+      g(to_size_t(width)),
+      b(to_size_t(width))
+  {}
+
+  void Load(const Bitmap& bmp, int y){
+    for (int x = 0; x != bmp.m_w; x++){
+      const Color c = get_color_raw(bmp, x, y);
+      r[to_size_t(x)] = 64 * static_cast<int>(c.r);
+      g[to_size_t(x)] = 64 * static_cast<int>(c.g);
+      b[to_size_t(x)] = 64 * static_cast<int>(c.b);
+    }
+  }
+
+  Color Get(int x) const{
+    return color_from_ints(r[to_size_t(x)] / 64,
+      g[to_size_t(x)] / 64,
+      b[to_size_t(x)] / 64);
+  }
+
+  std::vector<int> r;
+  std::vector<int> g;
+  std::vector<int> b;
+};
+
+static void diffuse(int dif, int& right, int& below, int& belowRight){
+  // Distributes 3/8 of the error to the right, 3/8 below and 1/4
+  // diagonally.
+  if (dif > 0){
+    right = std::min(16383, right + 3 * dif);
+    below = std::min(16383, below + 3 * dif);
+    belowRight = std::min(16383, belowRight + 2 * dif);
+  }
+  else if (dif < 0){
+    right = std::max(0, right + 3 * dif);
+    below = std::max(0, below + 3 * dif);
+    belowRight = std::max(0, belowRight + 2 * dif);
   }
 }
 
 static MappedColors apply_dithered_quantization(const Bitmap& bmp,
-  const Octree& tree)
+  const Octree& tree,
+  const OctreeLookup& lookup)
 {
-  uchar* r8 = new uchar[bmp.m_w];
-  uchar* g8 = new uchar[bmp.m_w];
-  uchar* b8 = new uchar[bmp.m_w];
-  int* r1 = new int[bmp.m_w];
-  int* g1 = new int[bmp.m_w];
-  int* b1 = new int[bmp.m_w];
-  int* r2 = new int[bmp.m_w];
-  int* g2 = new int[bmp.m_w];
-  int* b2 = new int[bmp.m_w];
-
-  // Start by priming buf2; line 1 is above line 2
-  get_rgb_line(bmp, 0, r8, g8, b8);
-  for (int x = 0; x != bmp.m_w; x++){
-    r2[x] = 64 * static_cast<int>(r8[x]);
-    g2[x] = 64 * static_cast<int>(g8[x]);
-    b2[x] = 64 * static_cast<int>(b8[x]);
+  // Rows are claimed in order by up to numLanes threads. The last
+  // error diffused to pixel x comes from pixel x + 1 in the row
+  // above, so a row can proceed to x once the row above has finished
+  // x + 1. The rows in progress each trail the row above, giving the
+  // same result as a single thread. A row is only claimed after the
+  // claiming thread finished its previous row, so the row above is
+  // always either done or in progress.
+  //
+  // A serpentine scan would prevent this overlap, as each row would
+  // need the entire row above, so all rows are scanned left to right.
+  const int w = bmp.m_w;
+  const int h = bmp.m_h;
+  const int numLanes = std::min(std::min(get_concurrency(), h),
+    std::max(1, area(bmp.GetSize()) / (1 << 16)));
+
+  // At most numLanes consecutive rows are in progress, so row y can
+  // use buffer y % (numLanes + 1), while its own and the next row's
+  // buffers are not in use by any other row.
+  const int numBuffers = numLanes + 1;
+  std::vector<DitherRow> rows(to_size_t(numBuffers), DitherRow(w));
+  rows[0].Load(bmp, 0);
+
+  // The number of pixels finished in each row, published in steps
+  std::unique_ptr<std::atomic<int>[]> finished(new std::atomic<int>[h]);
+  for (int y = 0; y != h; y++){
+    finished[y].store(0);
   }
 
   AlphaMap dst(bmp.GetSize());
-  IndexTables tables(tree.CQ_NLEVELS);
-  for (int y = 0; y < bmp.m_h - 1; y++) {
-    // Swap data 2 --> 1, and read in new line 2
-    memcpy(r1, r2, to_size_t(4 * bmp.m_w));
-    memcpy(g1, g2, to_size_t(4 * bmp.m_w));
-    memcpy(b1, b2, to_size_t(4 * bmp.m_w));
-    get_rgb_line(bmp, y + 1, r8, g8, b8);
-    for (int x = 0; x != bmp.m_w; x++) {
-      r2[x] = 64 * static_cast<int>(r8[x]);
-      g2[x] = 64 * static_cast<int>(g8[x]);
-      b2[x] = 64 * static_cast<int>(b8[x]);
-    }
 
-    for (int x = 0; x != bmp.m_w - 1; x++) {
-      Color color = color_from_ints(r1[x] / 64,
-        g1[x] / 64,
-        b1[x] / 64);
-      int octIndex = tables.GetIndex(color);
-      const ColorNode& node = tree.findNode(octIndex);
-      assert(node.index < 256);
-      dst.Set(x,y, static_cast<uchar>(node.index));
-
-      int dif = r1[x] / 8 - 8 * static_cast<int>(node.center.r);
-      if (dif != 0) {
-        int val1 = r1[x + 1] + 3 * dif;
-        int val2 = r2[x] + 3 * dif;
-        int val3 = r2[x + 1] + 2 * dif;
-        if (dif > 0) {
-          r1[x + 1] = std::min(16383, val1);
-          r2[x] = std::min(16383, val2);
-          r2[x + 1] = std::min(16383, val3);
-        }
-        else if (dif < 0) {
-          r1[x + 1] = std::max(0, val1);
-          r2[x] = std::max(0, val2);
-          r2[x + 1] = std::max(0, val3);
-        }
-      }
+  auto dither_row = [&](int y){
+    DitherRow& cur = rows[to_size_t(y % numBuffers)];
+    DitherRow* next = y + 1 < h ?
+      &rows[to_size_t((y + 1) % numBuffers)] : nullptr;
+    if (next != nullptr){
+      next->Load(bmp, y + 1);
+    }
 
-      dif = g1[x] / 8 - 8 * static_cast<int>(node.center.g);
-      if (dif != 0) {
-        int val1 = g1[x + 1] + 3 * dif;
-        int val2 = g2[x] + 3 * dif;
-        int val3 = g2[x + 1] + 2 * dif;
-        if (dif > 0) {
-          g1[x + 1] = std::min(16383, val1);
-          g2[x] = std::min(16383, val2);
-          g2[x + 1] = std::min(16383, val3);
-        }
-        else if (dif < 0) {
-          g1[x + 1] = std::max(0, val1);
-          g2[x] = std::max(0, val2);
-          g2[x + 1] = std::max(0, val3);
+    int available = y == 0 ? w : 0;
+    auto wait_for_above = [&](int x){
+      const int needed = std::min(x + 2, w);
+      while (available < needed){
+        available = finished[y - 1].load(std::memory_order_acquire);
+        if (available < needed){
+          std::this_thread::yield();
         }
       }
-
-      dif = b1[x] / 8 - 8 * static_cast<int>(node.center.b);
-      if (dif != 0) {
-        int val1 = b1[x + 1] + 3 * dif;
-        int val2 = b2[x] + 3 * dif;
-        int val3 = b2[x + 1] + 2 * dif;
-        if (dif > 0) {
-          b1[x + 1] = std::min(16383, val1);
-          b2[x] = std::min(16383, val2);
-          b2[x + 1] = std::min(16383, val3);
-        }
-        else if (dif < 0) {
-          b1[x + 1] = std::max(0, val1);
-          b2[x] = std::max(0, val2);
-          b2[x + 1] = std::max(0, val3);
-        }
+    };
+
+    const int lastDiffused = next == nullptr ? 0 : w - 1;
+    for (int x = 0; x != lastDiffused; x++){
+      wait_for_above(x);
+      const int cell = lookup.Cell(cur.Get(x));
+      dst.Set(x, y, lookup.Index(cell));
+
+      const ColRGB& center = lookup.Center(cell);
+      const size_t i = to_size_t(x);
+      diffuse(cur.r[i] / 8 - 8 * static_cast<int>(center.r),
+        cur.r[i + 1], next->r[i], next->r[i + 1]);
+      diffuse(cur.g[i] / 8 - 8 * static_cast<int>(center.g),
+        cur.g[i + 1], next->g[i], next->g[i + 1]);
+      diffuse(cur.b[i] / 8 - 8 * static_cast<int>(center.b),
+        cur.b[i + 1], next->b[i], next->b[i + 1]);
+
+      if ((x + 1) % 64 == 0){
+        finished[y].store(x + 1, std::memory_order_release);
       }
     }
 
-    // Last pixel in row, no downward propagation
-    int octIndex = tables.GetIndex(color_from_ints(r1[bmp.m_w-1]/64,
-        g1[bmp.m_w-1]/64,
-        b1[bmp.m_w-1]/64));
-    const ColorNode& cell = tree.findNode(octIndex);
-    dst.Set(bmp.m_w - 1,y, static_cast<uchar>(cell.index));
-  }
-
-  // Last row of pixels, no leftward propagation
-  for (int x = 0; x != bmp.m_w; x++) {
+    // The last pixel in each row, and the entire last row, are not
+    // diffused.
+    for (int x = lastDiffused; x != w; x++){
+      wait_for_above(x);
+      dst.Set(x, y, lookup.Index(lookup.Cell(cur.Get(x))));
+    }
+    finished[y].store(w, std::memory_order_release);
+  };
 
-    int octIndex = tables.GetIndex(color_from_ints(r2[x]/64,
-        g2[x]/64,
-        b2[x]/64));
-    const ColorNode& node = tree.findNode(octIndex);
-    dst.Set(x,bmp.m_h - 1 , static_cast<uchar>(node.index));
-  }
-  delete[] r8;
-  delete[] g8;
-  delete[] b8;
-  delete[] r1;
-  delete[] g1;
-  delete[] b1;
-  delete[] r2;
-  delete[] g2;
-  delete[] b2;
+  std::atomic<int> nextRow(0);
+  parallel_for(numLanes, 1, [&](int, int){
+    for (int y = nextRow++; y < h; y = nextRow++){
+      dither_row(y);
+    }
+  });
   return std::make_pair(dst, tree.colorMap);
 }
 
 // Based on octreeQuantizePixels
-static MappedColors apply_quantization(const Bitmap& bmp, const Octree& tree){
-  // Traverse the tree from the root, looking for lowest cube that is a leaf,
-  // and set destination pixel to its color table index value.
-  const IntSize sz(bmp.GetSize());
-
-  // Canonical index tables (again?)
-  IndexTables tables(tree.CQ_NLEVELS);
-  AlphaMap dst(sz);
-  for (int y = 0; y < sz.h; y++) {
-    for (int x = 0; x != sz.w; x++) {
-      Color color = get_color_raw(bmp, x, y);
-      int octIndex = tables.GetIndex(color);
-      const ColorNode& cell = tree.findNode(octIndex);
-      assert(cell.index < 256);
-      dst.Set(x,y, static_cast<uchar>(cell.index));
+static MappedColors apply_quantization(const Bitmap& bmp,
+  const Octree& tree,
+  const OctreeLookup& lookup)
+{
+  // Set each destination pixel to the color table index of the
+  // lowest leaf cube containing it.
+  AlphaMap dst(bmp.GetSize());
+  parallel_for(bmp.m_h, parallel_grain(bmp.m_h, min_band_rows(bmp)),
+    [&](int y0, int y1){
+    for (int y = y0; y != y1; y++){
+      for (int x = 0; x != bmp.m_w; x++){
+        dst.Set(x, y, lookup.Index(lookup.Cell(get_color_raw(bmp, x, y))));
+      }
     }
-  }
-  ColorList map = tree.colorMap;
-  return std::make_pair(dst, map);
+  });
+  return std::make_pair(dst, tree.colorMap);
 }
 
-static MappedColors simply_index_it(const Bitmap& bmp){
-  color_counts_t colorCounts;
-  add_color_counts(bmp, colorCounts);
+static MappedColors simply_index_it(const Bitmap& bmp,
+  const ColorHistogram& colors)
+{
+  // Index the colors in ascending order of to_hash, so that the
+  // palette does not depend on the histogram order.
+  std::vector<unsigned int> hashes;
+  hashes.reserve(to_size_t(colors.size()));
+  colors.for_each([&](const Color& c, int){
+    hashes.push_back(to_hash(c));
+  });
+  std::sort(begin(hashes), end(hashes));
 
   ColorList indexToColor;
-  std::map<Color, uchar> colorToIndex;
-  for (auto item : colorCounts){
-    const Color& c = item.first;
-    colorToIndex[c] = static_cast<uchar>(indexToColor.GetNumColors());
-    indexToColor.AddColor(c);
+  for (auto h : hashes){
+    indexToColor.AddColor(color_from_hash(h));
   }
 
+  auto index_of = [&](unsigned int h){
+    auto it = std::lower_bound(begin(hashes), end(hashes), h);
+    assert(it != end(hashes) && *it == h);
+    return static_cast<uchar>(it - begin(hashes));
+  };
+
   const IntSize sz(bmp.GetSize());
   AlphaMap indexes(sz);
   for (int y = 0; y != sz.h; y++){
+    // Neighbouring pixels often match, reuse the previous index then.
+    unsigned int lastHash = to_hash(get_color_raw(bmp, 0, y));
+    uchar lastIndex = index_of(lastHash);
     for (int x = 0; x != sz.w; x++){
-      indexes.Set(x,y, colorToIndex[get_color_raw(bmp,x,y)]);
+      const unsigned int h = to_hash(get_color_raw(bmp, x, y));
+      if (h != lastHash){
+        lastHash = h;
+        lastIndex = index_of(h);
+      }
+      indexes.Set(x,y, lastIndex);
     }
   }
   return std::make_pair(indexes, indexToColor);
 }
 
 MappedColors quantized(const Bitmap& bmp, Dithering dithering, OctTreeDepth d){
-  if (count_colors(bmp) <= 256){
-    return simply_index_it(bmp);
+  // Counting stops at 257 colors, since then the octree is needed
+  // anyway.
+  const ColorHistogram colors(color_histogram(bmp, 256));
+  if (colors.size() <= 256){
+    return simply_index_it(bmp, colors);
   }
 
   const int CQ_NLEVELS = static_cast<int>(d);
 
   const int reserved = 64; // To allow level 2 remainder CTEs
-  Octree* tree = generate_octree(bmp, 256, reserved, CQ_NLEVELS);
+  std::unique_ptr<Octree> tree(generate_octree(bmp, 256, reserved,
+    CQ_NLEVELS));
+  const OctreeLookup lookup(*tree);
 
   const bool useDithering = (dithering == Dithering::ON) &&
     (bmp.m_w >= 250 || bmp.m_h >= 250);
 
   return useDithering ?
-    apply_dithered_quantization(bmp, *tree) :
-    apply_quantization(bmp, *tree);
+    apply_dithered_quantization(bmp, *tree, lookup) :
+    apply_quantization(bmp, *tree, lookup);
 }
 
 Bitmap quantized_bmp(const Bitmap& bmp, Dithering dithering, OctTreeDepth d){
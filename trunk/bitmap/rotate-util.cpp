@@ -13,10 +13,16 @@
 // implied. See the License for the specific language governing
 // permissions and limitations under the License.
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
 #include "bitmap/bitmap.hh"
 #include "bitmap/color.hh"
+#include "bitmap/pixel-view.hh"
 #include "bitmap/rotate-util.hh"
 #include "geo/angle.hh"
+#include "util/parallel.hh"
 
 // The rotation code is adapted from this example for Windows GDI by
 // Yves Maurer: http://www.codeguru.com/cpp/g-m/gdi/article.php/c3693
@@ -92,56 +98,210 @@ RotationAdjustment get_rotation_adjustment(const Angle& angle,
 }
 
 
+// Fixed point 32.32 representation of 1.0 for stepping the source
+// coordinates along destination rows.
+static const double fixed_one = 4294967296.0;
+
+class InverseRotation{
+  // Maps destination pixels to source pixels for rotate_nearest.
+  //
+  // U and V give the same double values as the per-pixel evaluation
+  // rotate_nearest used before stepping was introduced (with the
+  // upper-left corner pivot the pivot terms are all zero), so that
+  // the truncated source pixel is the same.
+public:
+  InverseRotation(const Angle& angle, const IntPoint& offset,
+    const IntSize& srcSize)
+    : ca(cos(angle)),
+      sa(sin(angle)),
+      divisor(ca * ca + sa * sa),
+      offset(offset),
+      srcSize(srcSize)
+  {}
+
+  double U(int x, double saY) const{
+    return (ca * (static_cast<double>(x) + offset.x) + saY) / divisor;
+  }
+
+  double V(int x, double caY) const{
+    return -(static_cast<double>(x) + offset.x) * sa + caY;
+  }
+
+  bool Inside(double u, double v) const{
+    const int srcX = static_cast<int>(u);
+    const int srcY = static_cast<int>(v);
+    return srcX >= 0 && srcY >= 0 && srcX < srcSize.w && srcY < srcSize.h;
+  }
+
+  const coord ca;
+  const coord sa;
+  const coord divisor;
+  const IntPoint offset;
+  const IntSize srcSize;
+};
+
+static bool within(double value, double low, double high){
+  return low < value && value < high;
+}
+
+static void narrow_to(double low, double high, double c, double k,
+  double& lo, double& hi)
+{
+  // Narrows [lo, hi] to the x where low < c + k * x < high
+  if (k == 0.0){
+    if (!within(c, low, high)){
+      lo = 1.0;
+      hi = 0.0;
+    }
+    return;
+  }
+
+  const double a = (low - c) / k;
+  const double b = (high - c) / k;
+  lo = std::max(lo, std::min(a, b));
+  hi = std::min(hi, std::max(a, b));
+}
+
+static std::pair<int, int> inside_range(const InverseRotation& r,
+  int y, int w)
+{
+  // Returns the destination pixels [xStart, xEnd) on row y which map
+  // inside the source.
+  //
+  // The source coordinates are monotonic along a row, also when
+  // evaluated in floating point, so the pixels inside the source form
+  // a single span. The span is estimated from the line equations with
+  // some margin and then adjusted with the exact mapping.
+  const double Y = static_cast<double>(y) + r.offset.y;
+  const double saY = r.sa * Y;
+  const double caY = r.ca * Y;
+  auto inside = [&](int x){
+    return r.Inside(r.U(x, saY), r.V(x, caY));
+  };
+
+  double lo = 0.0;
+  double hi = w;
+  narrow_to(-1.0, r.srcSize.w, (r.ca * r.offset.x + saY) / r.divisor,
+    r.ca / r.divisor, lo, hi);
+  narrow_to(-1.0, r.srcSize.h, -r.offset.x * r.sa + caY, -r.sa, lo, hi);
+
+  int xStart = w;
+  int xEnd = w;
+  if (lo <= hi){
+    xStart = static_cast<int>(std::max(0.0, std::floor(lo) - 2.0));
+    xEnd = static_cast<int>(std::min(static_cast<double>(w), std::ceil(hi) + 2.0));
+    while (xStart < xEnd && !inside(xStart)){
+      xStart++;
+    }
+    while (xEnd > xStart && !inside(xEnd - 1)){
+      xEnd--;
+    }
+  }
+
+  if (xStart == xEnd){
+    // The estimate missed, which can happen for nearly axis-aligned
+    // angles where the line equations are ill-conditioned.
+    xStart = 0;
+    while (xStart != w && !inside(xStart)){
+      xStart++;
+    }
+    if (xStart == w){
+      return {w, w};
+    }
+    xEnd = xStart + 1;
+  }
+
+  while (xStart > 0 && inside(xStart - 1)){
+    xStart--;
+  }
+  while (xEnd < w && inside(xEnd)){
+    xEnd++;
+  }
+  return {xStart, xEnd};
+}
+
+static int64_t to_fixed(double v){
+  return static_cast<int64_t>(std::floor(v * fixed_one + 0.5));
+}
+
+static void rotate_row(const InverseRotation& r, const Bitmap& src,
+  uchar* dstRow, int y, int xStart, int xEnd)
+{
+  // Copies the source pixels for the destination pixels [xStart,
+  // xEnd) on row y, which must all map inside the source.
+  //
+  // The source coordinates are stepped in 32.32 fixed point, offset by
+  // one so that they stay positive. Where a stepped coordinate is too
+  // close to a pixel boundary for the accumulated error, the pixel is
+  // instead mapped with the exact evaluation.
+  if (xStart == xEnd){
+    return;
+  }
+  const double Y = static_cast<double>(y) + r.offset.y;
+  const double saY = r.sa * Y;
+  const double caY = r.ca * Y;
+
+  int64_t u = to_fixed(r.U(xStart, saY) + 1.0);
+  int64_t v = to_fixed(r.V(xStart, caY) + 1.0);
+  const int64_t du = to_fixed(r.ca / r.divisor);
+  const int64_t dv = to_fixed(-r.sa);
+
+  // Bound for the rounding errors of the stepping and of the exact
+  // evaluation, in fixed point units.
+  const double magnitude = std::fabs(Y) + std::fabs(r.offset.x) + xEnd + 2.0;
+  const uint32_t tolerance = static_cast<uint32_t>(xEnd - xStart + 16 +
+    magnitude);
+  auto near_boundary = [tolerance](int64_t fixed){
+    return static_cast<uint32_t>(fixed) + tolerance < 2 * tolerance;
+  };
+
+  const int maxX = src.m_w - 1;
+  const int maxY = src.m_h - 1;
+  for (int x = xStart; x != xEnd; x++, u += du, v += dv){
+    int srcX, srcY;
+    if (near_boundary(u) || near_boundary(v)){
+      srcX = static_cast<int>(r.U(x, saY));
+      srcY = static_cast<int>(r.V(x, caY));
+    }
+    else{
+      // A coordinate in (-1, 0) truncates to zero
+      srcX = std::min(std::max(static_cast<int>(u >> 32) - 1, 0), maxX);
+      srcY = std::min(std::max(static_cast<int>(v >> 32) - 1, 0), maxY);
+    }
+    store_pixel(dstRow + x * BPP,
+      load_pixel(src.m_data + srcY * src.m_row_stride + srcX * BPP));
+  }
+}
+
 Bitmap rotate_nearest(const Bitmap& bmp,
   const Angle& angle,
   const Color& bgColor)
 {
-  // Use the upper-left corner as pivot
-  double CtX = 0;
-  double CtY = 0;
-
-  // Find the corners to initialize the destination width and height
-
+  // Rotates around the upper-left corner. Each destination pixel gets
+  // the source pixel its truncated inverse-rotated coordinate falls
+  // in, or the background color outside the source.
   RotationAdjustment adj = get_rotation_adjustment(angle,
     bmp.GetSize());
 
-  Bitmap bmpDst(adj.size, bgColor);
-  uchar* dstRow = bmpDst.m_data;
-
-  const uchar* src = bmp.m_data;
-  coord ca = cos(angle);
-  coord sa = sin(angle);
-  coord divisor = ca*ca + sa*sa;
-
-  // Iterate over the destination bitmap
-  for (int stepY = 0; stepY != bmpDst.m_h; stepY++){
-    for (int stepX = 0; stepX != bmpDst.m_w; stepX++){
-      // Calculate the source coordinate
-      int orgX = static_cast<int>((ca * (((double) stepX + adj.offset.x) +
-            CtX * (ca - 1)) +
-          sa * (((double) stepY + adj.offset.y) +
-            CtY * (sa - 1))) / divisor);
-
-      int orgY = static_cast<int>(CtY + (CtX - ((double) stepX + adj.offset.x)) *
-        sa + ca *(((double) stepY + adj.offset.y) - CtY + (CtY - CtX) * sa));
-
-      if (orgX >= 0 && orgY >= 0 && orgX < bmp.m_w && orgY < bmp.m_h){
-        // Inside source - copy the bits
-        dstRow[stepX * BPP + iR] = src[orgX * BPP + orgY * bmp.m_row_stride + iR];
-        dstRow[stepX * BPP + iG] = src[orgX * BPP + orgY * bmp.m_row_stride + iG];
-        dstRow[stepX * BPP + iB] = src[orgX * BPP + orgY * bmp.m_row_stride + iB];
-        dstRow[stepX * BPP + iA] = src[orgX * BPP + orgY * bmp.m_row_stride + iA];
-      }
-      else {
-        // Outside source - set the color to bg color
-        dstRow[stepX * BPP + iR] = bgColor.r;
-        dstRow[stepX * BPP + iG] = bgColor.g;
-        dstRow[stepX * BPP + iB] = bgColor.b;
-        dstRow[stepX * BPP + iA] = bgColor.a;
+  Bitmap bmpDst(adj.size);
+  const InverseRotation r(angle, adj.offset, bmp.GetSize());
+  const uint32_t bg = BitmapFormat::Pack(bgColor);
+  const int w = bmpDst.m_w;
+
+  parallel_for(bmpDst.m_h, parallel_grain(bmpDst.m_h, 16),
+    [&](int firstRow, int endRow){
+      for (int y = firstRow; y != endRow; y++){
+        uchar* dstRow = bmpDst.m_data + y * bmpDst.m_row_stride;
+        const auto span = inside_range(r, y, w);
+        if (bg != 0){
+          // The bitmap is zero-initialized
+          fill_pixels(dstRow, to_size_t(span.first), bg);
+          fill_pixels(dstRow + span.second * BPP, to_size_t(w - span.second),
+            bg);
+        }
+        rotate_row(r, bmp, dstRow, y, span.first, span.second);
       }
-    }
-    dstRow += bmpDst.m_row_stride;
-  }
+    });
 
   return bmpDst;
 }
@@ -266,6 +266,29 @@ def build_faint(platform, cmdline):
         lambda bo: join_path(bo.project_root, "util", "msw_warn.hh"))
 
 
+def build_batch(platform, cmdline):
+    target = faint_info.target_batch
+    def precompile_steps(bo):
+        bo.create_build_info = False
+
+    def batch_source_files(platform, bo):
+        folder = join_path(bo.project_root, target.source_folder)
+        return [join_path(folder, f) for f in list_cpp(folder)]
+
+    return build(
+        "Batch",
+        platform,
+        cmdline,
+        target.objs_folder_prefix,
+        target.executable,
+        precompile_steps,
+        batch_source_files,
+        lambda platform, test: [],
+        test_extra_objs,
+        "console",
+        lambda bo: join_path(bo.project_root, "util", "msw_warn.hh"))
+
+
 def build_benchmarks(platform, cmdline):
     target = faint_info.target_benchmark
     def precompile_steps(bo):
@@ -292,6 +315,13 @@ def build_benchmarks(platform, cmdline):
 def build_unit_tests(platform, cmdline):
     target = faint_info.target_unit_test
 
+    def unit_test_source_files(platform, bo):
+        # The batch functions are not part of Faint, but are tested
+        # with the unit tests.
+        return (test_source_files(platform, bo, target.source_folder) +
+                [join_path(bo.project_root, "batch", "batch.cpp"),
+                 join_path(bo.project_root, "batch", "batch-python.cpp")])
+
     def precompile_steps(bo):
         tests_root = join_path(bo.project_root, target.source_folder)
         test_root = join_path(bo.project_root, "tests")
@@ -306,7 +336,7 @@ def build_unit_tests(platform, cmdline):
         target.objs_folder_prefix,
         target.executable,
         precompile_steps,
-        lambda platform, bo: test_source_files(platform, bo, target.source_folder),
+        unit_test_source_files,
         lambda platform, test: [],
         test_extra_objs,
         "console",
@@ -372,6 +402,7 @@ if __name__ == '__main__':
     opts, args = cmdline
 
     exit_on_error(build_faint, (platform, cmdline), blank_line=False)
+    exit_on_error(build_batch, (platform, cmdline))
 
     if opts.debug:
         print("Fixme: Not building tests in debug.")
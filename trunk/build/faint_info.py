@@ -110,6 +110,12 @@ class target_faint:
     executable = "faint"
 
 
+class target_batch:
+    objs_folder_prefix = "objs-batch"
+    source_folder = "batch"
+    executable = "faint-batch"
+
+
 class target_image_test:
     objs_folder_prefix = "objs-image-test"
     source_folder = "tests/image-tests"
@@ -18,9 +18,11 @@
 #include "commands/command.hh"
 #include "geo/geo-func.hh"
 #include "geo/int-point.hh"
+#include "geo/int-rect.hh"
 #include "rendering/faint-dc.hh"
 #include "text/utf8-string.hh"
 #include "util/default-settings.hh"
+#include "util/optional.hh"
 
 namespace faint{
 
@@ -39,6 +41,10 @@ public:
   utf8_string Name() const override{
     return "Blit Bitmap";
   }
+
+  Optional<IntRect> RasterBounds() const override{
+    return option(IntRect(m_pos, m_bmp.GetSize()));
+  }
 private:
   Bitmap m_bmp;
   IntPoint m_pos;
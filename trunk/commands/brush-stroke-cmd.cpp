@@ -0,0 +1,77 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <memory>
+#include "bitmap/alpha-map.hh"
+#include "commands/brush-stroke-cmd.hh"
+#include "commands/command.hh"
+#include "geo/geo-func.hh"
+#include "geo/int-point.hh"
+#include "geo/int-rect.hh"
+#include "rendering/faint-dc.hh"
+#include "rendering/filter-class.hh"
+#include "text/utf8-string.hh"
+#include "util/optional.hh"
+#include "util/setting-util.hh"
+#include "util/settings.hh"
+
+namespace faint{
+
+class BrushCommand : public Command{
+public:
+  BrushCommand(const UpperLeft& topLeft,
+    const AlphaMap& alphaMap,
+    const UpperLeft& first,
+    const Settings& settings)
+    : Command(CommandType::RASTER),
+      m_settings(settings),
+      m_alphaMap(alphaMap),
+      m_first(first.Get()),
+      m_topLeft(topLeft.Get())
+  {
+    finalize_swap_colors_erase_bg(m_settings);
+  }
+
+  utf8_string Name() const override{
+    return "Brush Stroke";
+  }
+
+  void Do(CommandContext& context) override{
+    context.GetDC().Blend(m_alphaMap, m_topLeft, m_first, m_settings);
+  }
+
+  Optional<IntRect> RasterBounds() const override{
+    // A filter (e.g. a shadow) draws outside the alpha map
+    const IntRect r(m_topLeft, m_alphaMap.GetSize());
+    std::unique_ptr<Filter> f(get_filter(m_settings));
+    return option(f == nullptr ? r : padded(r, f->GetPadding()));
+  }
+
+private:
+  Settings m_settings;
+  AlphaMap m_alphaMap;
+  IntPoint m_first;
+  IntPoint m_topLeft;
+};
+
+Command* brush_stroke_command(const UpperLeft& topLeft,
+  const AlphaMap& alphaMap,
+  const UpperLeft& first,
+  const Settings& settings)
+{
+  return new BrushCommand(topLeft, alphaMap, first, settings);
+}
+
+} // namespace
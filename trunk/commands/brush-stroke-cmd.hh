@@ -0,0 +1,35 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FAINT_BRUSH_STROKE_CMD_HH
+#define FAINT_BRUSH_STROKE_CMD_HH
+#include "bitmap/alpha-map.hh"
+
+namespace faint{
+
+class Command;
+class Settings;
+
+// Command for blending the alpha map with the paint from the settings
+// (and its filter, if any) at topLeft. The first point of the stroke
+// anchors object aligned paints.
+Command* brush_stroke_command(const UpperLeft& topLeft,
+  const AlphaMap&,
+  const UpperLeft& first,
+  const Settings&);
+
+} // namespace
+
+#endif
@@ -15,7 +15,9 @@
 
 #include <cassert>
 #include "commands/command.hh"
+#include "geo/int-rect.hh"
 #include "geo/point.hh"
+#include "util/optional.hh"
 
 namespace faint{
 
@@ -70,6 +72,10 @@ bool Command::ModifiesState() const{
   return true;
 }
 
+Optional<IntRect> Command::RasterBounds() const{
+  return no_option();
+}
+
 Point Command::Translate(const Point& p) const{
   return p;
 }
@@ -20,6 +20,7 @@
 #include "util/index.hh"
 #include "util/objects.hh"
 #include "util/pending.hh"
+#include "util/template-fwd.hh"
 
 namespace faint{
 
@@ -28,6 +29,7 @@ class Command;
 class FaintDC;
 class Image;
 class IntPoint;
+class IntRect;
 class IntSize;
 class Object;
 class Point;
@@ -104,6 +106,13 @@ public:
   // flag the image has dirty - but should still support undo/redo.
   virtual bool ModifiesState() const;
   virtual utf8_string Name() const = 0;
+
+  // The rectangle modified by the raster steps of the command, if
+  // known. Allows undoing the command by restoring the pixels of the
+  // rectangle instead of reapplying all earlier commands. Must not be
+  // set by commands that change the image size.
+  virtual Optional<IntRect> RasterBounds() const;
+
   // Commands that change the image size (e.g. cropping, scaling) can
   // translate a point, expressed in image coordinates, relative to
   // the transformation.
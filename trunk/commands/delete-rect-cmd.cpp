@@ -54,6 +54,10 @@ public:
       "Delete rectangle";
   }
 
+  Optional<IntRect> RasterBounds() const override{
+    return option(m_rect);
+  }
+
   bool Same(const IntRect& rect, const Paint& bg) const{
     return m_rect == rect && m_bg == bg;
   }
@@ -15,9 +15,11 @@
 
 #include "commands/command.hh"
 #include "commands/draw-object-cmd.hh"
+#include "geo/int-rect.hh"
 #include "objects/object.hh"
 #include "text/formatting.hh"
 #include "util/image.hh"
+#include "util/object-util.hh"
 
 namespace faint{
 
@@ -49,6 +51,10 @@ public:
   utf8_string Name() const override{
     return space_sep("Draw ", m_object->GetType());
   }
+
+  Optional<IntRect> RasterBounds() const override{
+    return option(get_drawn_rect(m_object));
+  }
 private:
   bool m_delete;
   Object* m_object;
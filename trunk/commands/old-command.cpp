@@ -15,6 +15,7 @@
 
 #include "commands/command.hh"
 #include "commands/old-command.hh"
+#include "commands/raster-delta.hh"
 
 namespace faint{
 
@@ -50,10 +51,16 @@ OldCommand OldCommand::CloseGroup(const utf8_string& name){
 }
 
 bool OldCommand::Merge(OldCommand& candidate){
-  return type == UndoType::NORMAL_COMMAND &&
+  const bool merged = type == UndoType::NORMAL_COMMAND &&
     candidate.type == UndoType::NORMAL_COMMAND &&
     command->Merge(candidate.command,
     targetFrame == candidate.targetFrame);
+
+  if (merged){
+    // The delta does not cover the changes of the merged command
+    delta.reset();
+  }
+  return merged;
 }
 
 } // namespace
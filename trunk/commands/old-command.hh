@@ -15,6 +15,7 @@
 
 #ifndef FAINT_OLD_COMMAND_HH
 #define FAINT_OLD_COMMAND_HH
+#include <memory>
 #include "text/utf8-string.hh"
 #include "util/optional.hh"
 
@@ -22,6 +23,7 @@ namespace faint{
 
 class Command;
 class Image;
+class RasterDelta;
 
 enum class UndoType{
   // An OldCommand can be an actual command or the start or end of a
@@ -57,6 +59,9 @@ public:
   Image* targetFrame;
   UndoType type;
   Optional<utf8_string> name;
+
+  // The pixels modified by the command, if available for undo.
+  std::shared_ptr<const RasterDelta> delta;
 private:
   explicit OldCommand(UndoType);
 };
@@ -15,10 +15,14 @@
 
 #include "bitmap/bitmap.hh"
 #include "bitmap/color.hh"
+#include "bitmap/draw.hh"
 #include "commands/command.hh"
 #include "commands/put-pixel-cmd.hh"
 #include "geo/int-point.hh"
+#include "geo/int-rect.hh"
+#include "geo/offsat.hh"
 #include "text/utf8-string.hh"
+#include "util/optional.hh"
 
 namespace faint{
 
@@ -37,13 +41,136 @@ public:
   utf8_string Name() const override{
     return "Set Pixel";
   }
+
+  Optional<IntRect> RasterBounds() const override{
+    return option(IntRect(m_pos, IntSize(1, 1)));
+  }
 private:
   Color m_color;
   IntPoint m_pos;
 };
 
+static IntRect span_rect(const PixelSpan& span){
+  return IntRect(span.pos, IntSize(span.length, 1));
+}
+
+static IntRect bounding_rect(const std::vector<PixelValue>& pixels){
+  if (pixels.empty()){
+    return IntRect::EmptyRect();
+  }
+  IntPoint minPos(pixels.front().pos);
+  IntPoint maxPos(minPos);
+  for (const PixelValue& px : pixels){
+    minPos = min_coords(minPos, px.pos);
+    maxPos = max_coords(maxPos, px.pos);
+  }
+  return IntRect(minPos, maxPos);
+}
+
+static IntRect bounding_rect(const std::vector<PixelSpan>& spans){
+  IntRect r(IntRect::EmptyRect());
+  for (const PixelSpan& span : spans){
+    r = empty(r) ? span_rect(span) : union_of(r, span_rect(span));
+  }
+  return r;
+}
+
+class PutPixelsCommand : public Command {
+public:
+  explicit PutPixelsCommand(const std::vector<PixelValue>& pixels)
+    : Command(CommandType::RASTER),
+      m_bounds(bounding_rect(pixels)),
+      m_pixels(pixels)
+  {}
+
+  void Do(CommandContext& context) override{
+    Bitmap& bmp = context.GetRawBitmap();
+    for (const PixelValue& px : m_pixels){
+      put_pixel_raw(bmp, px.pos.x, px.pos.y, px.color);
+    }
+  }
+
+  utf8_string Name() const override{
+    return "Set Pixels";
+  }
+
+  Optional<IntRect> RasterBounds() const override{
+    return option(m_bounds);
+  }
+private:
+  IntRect m_bounds;
+  std::vector<PixelValue> m_pixels;
+};
+
+class FillSpansCommand : public Command {
+public:
+  FillSpansCommand(const std::vector<PixelSpan>& spans, const Color& color)
+    : Command(CommandType::RASTER),
+      m_bounds(bounding_rect(spans)),
+      m_color(color),
+      m_spans(spans)
+  {}
+
+  void Do(CommandContext& context) override{
+    Bitmap& bmp = context.GetRawBitmap();
+    for (const PixelSpan& span : m_spans){
+      fill_rect_color(bmp, span_rect(span), m_color);
+    }
+  }
+
+  utf8_string Name() const override{
+    return "Fill Spans";
+  }
+
+  Optional<IntRect> RasterBounds() const override{
+    return option(m_bounds);
+  }
+private:
+  IntRect m_bounds;
+  Color m_color;
+  std::vector<PixelSpan> m_spans;
+};
+
+class PutBitmapCommand : public Command {
+public:
+  PutBitmapCommand(const IntPoint& pos, const Bitmap& bmp)
+    : Command(CommandType::RASTER),
+      m_bmp(bmp),
+      m_pos(pos)
+  {}
+
+  void Do(CommandContext& context) override{
+    blit(offsat(m_bmp, m_pos), onto(context.GetRawBitmap()));
+  }
+
+  utf8_string Name() const override{
+    return "Set Pixels";
+  }
+
+  Optional<IntRect> RasterBounds() const override{
+    return option(IntRect(m_pos, m_bmp.GetSize()));
+  }
+private:
+  Bitmap m_bmp;
+  IntPoint m_pos;
+};
+
 Command* put_pixel_command(const IntPoint& pos, const Color& color){
   return new PutPixelCommand(pos, color);
 }
 
+Command* put_pixels_command(const std::vector<PixelValue>& pixels){
+  return new PutPixelsCommand(pixels);
+}
+
+Command* fill_spans_command(const std::vector<PixelSpan>& spans,
+  const Color& color)
+{
+  return new FillSpansCommand(spans, color);
+}
+
+Command* put_bitmap_command(const IntPoint& pos, const Bitmap& bmp){
+  return new PutBitmapCommand(pos, bmp);
+}
+
 } // namespace
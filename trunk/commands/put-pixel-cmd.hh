@@ -15,15 +15,43 @@
 
 #ifndef FAINT_PUT_PIXEL_CMD_HH
 #define FAINT_PUT_PIXEL_CMD_HH
+#include <vector>
+#include "bitmap/color.hh"
+#include "geo/int-point.hh"
 
 namespace faint{
 
+class Bitmap;
 class Command;
-class IntPoint;
-class Color;
+
+class PixelValue{
+  // A pixel position and the color to set it to.
+public:
+  IntPoint pos;
+  Color color;
+};
+
+class PixelSpan{
+  // A horizontal run of pixels, starting at pos and extending
+  // length pixels to the right.
+public:
+  IntPoint pos;
+  int length = 0;
+};
 
 Command* put_pixel_command(const IntPoint&, const Color&);
 
+// Sets all the pixels with a single command, which is far cheaper
+// than a command per pixel, both to apply and to undo.
+Command* put_pixels_command(const std::vector<PixelValue>&);
+
+// Sets the pixels of all spans to the color.
+Command* fill_spans_command(const std::vector<PixelSpan>&, const Color&);
+
+// Replaces the pixels in the rectangle at the point with those of
+// the bitmap, without alpha blending.
+Command* put_bitmap_command(const IntPoint&, const Bitmap&);
+
 } // namespace
 
 #endif
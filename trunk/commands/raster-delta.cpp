@@ -0,0 +1,47 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include "bitmap/bitmap.hh"
+#include "bitmap/draw.hh"
+#include "commands/raster-delta.hh"
+
+namespace faint{
+
+RasterDelta::RasterDelta(const Bitmap& bmp, const IntRect& rect)
+  : m_rect(intersection(rect, IntRect(IntPoint(0, 0), bmp.GetSize())))
+{
+  if (!empty(m_rect)){
+    m_pixels.Set(CompressedBitmap(subbitmap(bmp, m_rect)));
+  }
+}
+
+void RasterDelta::Restore(Bitmap& bmp) const{
+  m_pixels.Visit(
+    [&](const CompressedBitmap& pixels){
+      pixels.DecompressOnto(bmp, m_rect.TopLeft());
+    });
+}
+
+size_t RasterDelta::GetByteCount() const{
+  return m_pixels.Visit(
+    [](const CompressedBitmap& pixels){
+      return pixels.GetByteCount();
+    },
+    [](){
+      return size_t(0);
+    });
+}
+
+} // namespace
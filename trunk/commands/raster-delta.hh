@@ -0,0 +1,46 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FAINT_RASTER_DELTA_HH
+#define FAINT_RASTER_DELTA_HH
+#include "bitmap/compressed-bitmap.hh"
+#include "geo/int-rect.hh"
+#include "util/optional.hh"
+
+namespace faint{
+
+class RasterDelta{
+  // The pixels of a rectangle of an image before a command modified
+  // them, so that the command can be undone by restoring the
+  // rectangle instead of reapplying all earlier commands.
+public:
+  // Stores the pixels from the bitmap within the rectangle, clipped
+  // to the bitmap.
+  RasterDelta(const Bitmap&, const IntRect&);
+
+  // Writes the stored pixels back to the bitmap, which must have the
+  // size of the bitmap the delta was created from.
+  void Restore(Bitmap&) const;
+
+  // The number of bytes used for the stored pixels
+  size_t GetByteCount() const;
+private:
+  IntRect m_rect;
+  Optional<CompressedBitmap> m_pixels;
+};
+
+} // namespace
+
+#endif
@@ -29,7 +29,8 @@ namespace faint{
 
 static Point adjusted_p0(const PosInfo& info, const AllowSnap& allowSnap){
   return (info.modifiers.Primary() && allowSnap.Get()) ?
-    snap(info.pos, info.canvas.GetObjects(), info.canvas.GetGrid()) :
+    snap(info.pos, info.canvas.GetImage(), objects_t(),
+      info.canvas.GetGrid()) :
     info.pos;
 }
 
@@ -39,7 +40,7 @@ static Point adjusted_p1(const PosInfo& info,
   const AllowSnap& allowSnap)
 {
   if (info.modifiers.Primary() && allowSnap.Get()){
-    return snap(info.pos, info.canvas.GetObjects(),
+    return snap(info.pos, info.canvas.GetImage(), objects_t(),
       info.canvas.GetGrid());
   }
   else if (info.modifiers.Secondary() && allowConstrain.Get()){
@@ -68,12 +68,12 @@ void set_hot_spot(IconDirEntry& e, const HotSpot& p){
   e.bpp = static_cast<uint16_t>(p.y); // Fixme: Error check
 }
 
-BitmapInfoHeader create_bitmap_info_header(const Bitmap& bmp, uint16_t bpp,
+BitmapInfoHeader create_bitmap_info_header(const IntSize& bmpSize,
+  uint16_t bpp,
   bool andMap)
 {
   BitmapInfoHeader h;
   h.headerLen = 40; // Fixme
-  IntSize bmpSize = bmp.GetSize();
   h.width = bmpSize.w;
   h.height = bmpSize.h;
   if (andMap){
@@ -112,9 +112,7 @@ HotSpot get_hot_spot(const IconDirEntry&);
 void set_hot_spot(IconDirEntry&, const HotSpot&);
 
 // Fixme: Move these somewhere else
-class Bitmap; // Fixme
-
-BitmapInfoHeader create_bitmap_info_header(const Bitmap& bmp,
+BitmapInfoHeader create_bitmap_info_header(const IntSize& bmpSize,
   uint16_t bpp,
   bool andMap);
 
@@ -163,7 +163,7 @@ SaveResult write_bmp(const FilePath& filePath,
   const int rowStride = bmp_row_stride(bpp, size.w);
 
   write_struct(out, create_bitmap_file_header(quality, rowStride, size.h));
-  write_struct(out, create_bitmap_info_header(bmp, bpp, false));
+  write_struct(out, create_bitmap_info_header(bmp.GetSize(), bpp, false));
 
   switch(quality){
     // Note: No default, to ensure warning if unhandled enum value
@@ -184,4 +184,29 @@ SaveResult write_bmp(const FilePath& filePath,
   return SaveResult::SaveFailed(utf8_string("Internal error in save_bitmap"));
 }
 
+SaveResult write_bmp_24bpp_bands(const FilePath& filePath,
+  const IntSize& size,
+  const std::function<void(const bmp_band_sink_t&)>& writeBands)
+{
+  BinaryWriter out(filePath);
+  if (!out.good()){
+    return SaveResult::SaveFailed(error_open_file_write(filePath));
+  }
+
+  const uint16_t bpp = 24;
+  const int rowStride = bmp_row_stride(bpp, size.w);
+  write_struct(out, create_bitmap_file_header(BitmapQuality::COLOR_24BIT,
+    rowStride, size.h));
+  write_struct(out, create_bitmap_info_header(size, bpp, false));
+
+  int rowsWritten = 0;
+  writeBands([&](const Bitmap& band){
+    assert(band.m_w == size.w);
+    write_24bpp_BI_RGB(out, band);
+    rowsWritten += band.m_h;
+  });
+  assert(rowsWritten == size.h);
+  return SaveResult::SaveSuccessful();
+}
+
 } // namespace
@@ -15,6 +15,7 @@
 
 #ifndef FAINT_SAVE_BITMAP_HH
 #define FAINT_SAVE_BITMAP_HH
+#include <functional>
 #include "bitmap/bitmap.hh"
 #include "formats/save-result.hh"
 #include "util/or-error.hh"
@@ -32,6 +33,15 @@ enum class BitmapQuality{
 
 SaveResult write_bmp(const FilePath&, const Bitmap&, BitmapQuality);
 
+// Receives full-width bands of the image, bottom band first.
+using bmp_band_sink_t = std::function<void(const Bitmap&)>;
+
+// Writes a 24-bit bitmap of the given size without requiring the
+// entire image in memory. The writeBands function must pass all
+// rows of the image to the sink it receives, bottom band first.
+SaveResult write_bmp_24bpp_bands(const FilePath&, const IntSize&,
+  const std::function<void(const bmp_band_sink_t&)>& writeBands);
+
 OrError<Bitmap> read_bmp(const FilePath&);
 
 } // namespace
@@ -20,9 +20,13 @@
 #include "formats/bmp/file-bmp.hh"
 #include "util/image-props.hh"
 #include "util/image-util.hh"
+#include "util/image.hh"
 
 namespace faint{
 
+// Rows per band when saving 24-bit bitmaps
+static const int bmp_band_height = 256;
+
 static label_t get_bmp_label(BitmapQuality quality){
   switch (quality){
   case BitmapQuality::COLOR_8BIT:
@@ -68,7 +72,19 @@ public:
 
   SaveResult Save(const FilePath& filePath, Canvas& canvas) override{
     assert(m_quality.IsSet());
-    Bitmap bmp(flatten(canvas.GetImage()));
+    const Image& image(canvas.GetImage());
+    if (m_quality.Get() == BitmapQuality::COLOR_24BIT){
+      // Flatten and write a band at a time, since no quantization of
+      // the entire image is required.
+      return write_bmp_24bpp_bands(filePath, image.GetSize(),
+        [&](const bmp_band_sink_t& sink){
+          flatten_bands(image, bmp_band_height, BandOrder::BOTTOM_UP,
+            [&](const Bitmap& band, int){
+              sink(band);
+            });
+        });
+    }
+    Bitmap bmp(flatten(image));
     return write_bmp(filePath, bmp, m_quality.Get());
   }
 
@@ -22,6 +22,7 @@
 #include "gui/art-container.hh"
 #include "util-wx/convert-wx.hh"
 #include "util-wx/file-path.hh"
+#include "util/parallel.hh"
 
 namespace faint{
 
@@ -37,12 +38,14 @@ ArtContainer::ArtContainer(){
 }
 
 wxBitmap ArtContainer::Get(Icon iconId) const{
+  assert(m_pendingIcons.empty());
   std::map<Icon, wxBitmap>::const_iterator it = m_icons.find(iconId);
   assert(it != m_icons.end());
   return it->second;
 }
 
 const wxCursor& ArtContainer::Get(Cursor cursorId) const{
+  assert(m_pendingCursors.empty());
   std::map<Cursor, wxCursor>::const_iterator it = m_cursors.find(cursorId);
   assert(it != m_cursors.end());
   return it->second;
@@ -53,42 +56,77 @@ void ArtContainer::Add(const wxCursor& cursor, Cursor cursorId){
 }
 
 void ArtContainer::Load(const wxString& filename, Icon iconId){
-  wxFileName fn_filename(filename);
-  if (fn_filename.IsRelative()){
-    fn_filename.MakeAbsolute(m_rootPath);
+  m_pendingIcons.emplace_back(Absolute(filename), iconId);
+}
+
+void ArtContainer::Load(const wxString& filename, Cursor cursorId){
+  assert(wxFileName(filename).GetExt() == "cur");
+  m_pendingCursors.emplace_back(Absolute(filename), cursorId);
+}
+
+void ArtContainer::LoadPending(){
+  // Decode the files in worker threads. Only the wxImage and the
+  // Faint-bitmaps are created there, the wxBitmaps and wxCursors
+  // must be created in the GUI-thread.
+  const size_t numIcons = m_pendingIcons.size();
+  const size_t numCursors = m_pendingCursors.size();
+  std::vector<wxImage> images(numIcons);
+  std::vector<cur_vec> cursors(numCursors);
+
+  auto load = [&](size_t i){
+    if (i < numIcons){
+      wxImage image(m_pendingIcons[i].first, wxBITMAP_TYPE_ANY);
+      assert(image.IsOk());
+      if (image.HasMask() && !image.HasAlpha()){
+        image.InitAlpha();
+      }
+      images[i] = image;
+    }
+    else{
+      const size_t c = i - numIcons;
+      const auto& path = m_pendingCursors[c].first;
+      read_cur(FilePath::FromAbsoluteWx(wxFileName(path))).Visit(
+        [&](const cur_vec& result){
+          cursors[c] = result;
+        },
+        [](const utf8_string&){
+          assert(false); // Fixme: Add proper error handling
+        });
+    }
+  };
+
+  parallel_for(resigned(numIcons + numCursors), 1, [&](int begin, int end){
+    for (int i = begin; i != end; i++){
+      load(to_size_t(i));
+    }
+  });
+
+  for (size_t i = 0; i != numIcons; i++){
+    m_icons[m_pendingIcons[i].second] = wxBitmap(images[i]);
   }
-  assert(fn_filename.FileExists());
 
-  wxImage image(fn_filename.GetLongPath(), wxBITMAP_TYPE_ANY);
-  assert(image.IsOk());
-  if (image.HasMask() && !image.HasAlpha()){
-    image.InitAlpha();
+  for (size_t i = 0; i != numCursors; i++){
+    assert(cursors[i].size() == 1); // Fixme: Add proper error handling
+    const auto& c = cursors[i].back();
+    m_cursors[m_pendingCursors[i].second] =
+      cur_from_bmp(to_wx_bmp(c.first), c.second);
   }
-  m_icons[iconId] = wxBitmap(image);
+
+  m_pendingIcons.clear();
+  m_pendingCursors.clear();
 }
 
-void ArtContainer::Load(const wxString& filename, Cursor cursorId){
+void ArtContainer::SetRoot(const DirPath& rootPath){
+  m_rootPath = to_wx(rootPath.Str());
+}
+
+wxString ArtContainer::Absolute(const wxString& filename) const{
   wxFileName fn_filename(filename);
   if (fn_filename.IsRelative()){
     fn_filename.MakeAbsolute(m_rootPath);
   }
   assert(fn_filename.FileExists());
-  assert(fn_filename.GetExt() == "cur");
-
-  auto result = read_cur(FilePath::FromAbsoluteWx(fn_filename));
-  result.Visit(
-    [&](const cur_vec& cursors){
-      assert(cursors.size() == 1); // Fixme: Add proper error handling
-      const auto& c = cursors.back();
-      m_cursors[cursorId] = cur_from_bmp(to_wx_bmp(c.first), c.second);
-    },
-    [](const utf8_string&){
-      assert(false); // Fixme: Add proper error handling
-    });
-}
-
-void ArtContainer::SetRoot(const DirPath& rootPath){
-  m_rootPath = to_wx(rootPath.Str());
+  return fn_filename.GetLongPath();
 }
 
 } // namespace
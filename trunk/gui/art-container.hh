@@ -16,6 +16,7 @@
 #ifndef FAINT_ART_CONTAINER_HH
 #define FAINT_ART_CONTAINER_HH
 #include <map>
+#include <vector>
 #include "wx/bitmap.h"
 #include "wx/cursor.h"
 #include "app/resource-id.hh"
@@ -28,20 +29,28 @@ class ArtContainer{
   // Handles bitmap loading and storage for application art (e.g.
   // icons, buttons). Supports setting a root path for interpreting
   // relative paths.
+  //
+  // Files passed to Load are not read until LoadPending is called,
+  // which decodes them in parallel.
 public:
   ArtContainer();
   wxBitmap Get(Icon id) const;
   const wxCursor& Get(Cursor id) const;
   void Load(const wxString& filename, Cursor id);
   void Load(const wxString& filename, Icon id);
+  void LoadPending();
   void Add(const wxCursor&, Cursor id);
   void SetRoot(const DirPath&);
 
   ArtContainer(const ArtContainer&) = delete;
   ArtContainer& operator=(const ArtContainer&) = delete;
 private:
+  wxString Absolute(const wxString& filename) const;
+
   std::map<Cursor, wxCursor> m_cursors;
   std::map<Icon, wxBitmap> m_icons;
+  std::vector<std::pair<wxString, Cursor>> m_pendingCursors;
+  std::vector<std::pair<wxString, Icon>> m_pendingIcons;
   wxString m_rootPath;
 };
 
@@ -427,6 +427,10 @@ public:
     return m_canvas.GetImageViewStart();
   }
 
+  IntRect GetVisibleImageRect() const override{
+    return m_canvas.GetVisibleImageRect();
+  }
+
   IntPoint GetMaxScrollPos() override{
     return m_canvas.GetMaxUsefulScroll();
   }
@@ -20,6 +20,7 @@
 #include "app/canvas-handle.hh"
 #include "app/template-drawable.hh"
 #include "geo/geo-func.hh"
+#include "geo/rect.hh"
 #include "geo/scale.hh"
 #include "geo/size.hh"
 #include "gui/art-container.hh"
@@ -133,6 +134,7 @@ CanvasPanel::CanvasPanel(wxWindow* parent,
 
   bind_fwd(this, wxEVT_LEFT_DCLICK,
     [&](const wxMouseEvent& event){
+      FlushMotion();
       PosInfo info = HitTest(to_faint(event.GetPosition()),
         mouse_modifiers(event));
       HandleToolResult(m_contexts.GetTool().DoubleClick(info));
@@ -188,6 +190,7 @@ CanvasPanel::CanvasPanel(wxWindow* parent,
 
   bind_fwd(this, wxEVT_LEFT_DOWN, wxEVT_RIGHT_DOWN,
     [this](wxMouseEvent& evt){
+      FlushMotion();
       SetFocus();
       IntPoint viewPos(to_faint(evt.GetPosition()));
       PosInfo info(HitTest(viewPos, mouse_modifiers(evt)));
@@ -216,6 +219,7 @@ CanvasPanel::CanvasPanel(wxWindow* parent,
 
   bind_fwd(this, wxEVT_LEFT_UP, wxEVT_RIGHT_UP,
     [this](wxMouseEvent& evt){
+      FlushMotion();
       m_mouse.Release();
       SetFocus();
       PosInfo info = HitTest(to_faint(evt.GetPosition()), mouse_modifiers(evt));
@@ -223,10 +227,11 @@ CanvasPanel::CanvasPanel(wxWindow* parent,
   });
 
   events::on_mouse_motion(this, [&](const IntPoint& pos){
-      MousePosRefresh(pos, get_tool_modifiers());
+      QueueMotion(pos, get_tool_modifiers());
     });
 
   events::on_mouse_leave_window(this, [&](){
+    FlushMotion();
     if (m_contexts.GetTool().RefreshOnMouseOut()){
       // Clear graphics remains, see \ref(refresh-on-mouse-out).
       RefreshToolRect();
@@ -523,6 +528,15 @@ Point CanvasPanel::GetImageViewStart() const{
   return max_coords(pos, Point::Both(0));
 }
 
+IntRect CanvasPanel::GetVisibleImageRect() const{
+  const IntSize clientSize(to_faint(GetClientSize()));
+  const Point topLeft(mouse::view_to_image(IntPoint(0, 0), m_state.geo));
+  const Point bottomRight(mouse::view_to_image(point_from_size(clientSize),
+    m_state.geo));
+  return intersection(floiled(Rect(topLeft, bottomRight)),
+    rect_from_size(m_images.Active().GetSize()));
+}
+
 RasterSelection& CanvasPanel::GetImageSelection(){
   return m_images.Active().GetRasterSelection();
 }
@@ -677,6 +691,7 @@ void CanvasPanel::MousePosRefresh(){
 }
 
 PreemptResult CanvasPanel::Preempt(PreemptOption option){
+  FlushMotion();
   Tool& tool = m_contexts.GetTool();
 
   PosInfo info(HitTest(mouse::view_position(*this),
@@ -989,23 +1004,62 @@ bool CanvasPanel::IgnoreCanvasHandle(const PosInfo& info){
 void CanvasPanel::MousePosRefresh(const IntPoint& viewPt,
   const ToolModifiers& modifiers)
 {
-  PosInfo info = HitTest(viewPt, modifiers);
+  FlushMotion();
+  if (MouseMoveTo(viewPt, modifiers, m_state.geo)){
+    RefreshToolRect();
+  }
+}
+
+bool CanvasPanel::MouseMoveTo(const IntPoint& viewPt,
+  const ToolModifiers& modifiers, const CanvasGeo& geo)
+{
+  // Forwards the mouse position, mapped to the image with the given
+  // geometry, to the interaction or the tool. Returns true if the
+  // tool rectangle needs refreshing, which is left to the caller, so
+  // that it can be done once for many positions.
+  PosInfo info = HitTest(viewPt, modifiers, geo);
   if (!m_mouse.HasCapture() && !IgnoreCanvasHandle(info)){
     auto canvasHandle = canvas_handle_hit_test(viewPt,
-      m_images.Active().GetSize(), m_state.geo);
+      m_images.Active().GetSize(), geo);
 
     if (canvasHandle.IsSet()){
       SetFaintCursor(canvasHandle.Get().GetCursor());
       m_statusInfo.SetMainText("Left click to resize, right click to rescale.");
-      return;
+      return false;
     }
   }
 
   if (!m_contexts.app.GetInteraction().MouseMove(info)){
     // Todo: Tidy up.
     auto& tool(m_contexts.GetTool());
-    HandleToolResult(tool.MouseMove(info));
+    const ToolResult result = tool.MouseMove(info);
+    const bool draw = result == ToolResult::DRAW;
+    if (!draw){
+      HandleToolResult(result);
+    }
     SetFaintCursor(tool.GetCursor(info));
+    return draw;
+  }
+  return false;
+}
+
+void CanvasPanel::QueueMotion(const IntPoint& viewPt,
+  const ToolModifiers& modifiers)
+{
+  if (!m_motion.samples.Push(viewPt, modifiers, m_state.geo)){
+    // The queue is full, forward the queued positions right away.
+    FlushMotion();
+    m_motion.samples.Push(viewPt, modifiers, m_state.geo);
+  }
+
+  if (!m_motion.flushQueued){
+    // Flush once the already queued events, e.g. further motion, have
+    // been handled.
+    m_motion.flushQueued = true;
+    CallAfter([this](){
+      m_motion.flushQueued = false;
+      FlushMotion();
+    });
   }
 }
 
@@ -1066,11 +1120,17 @@ void CanvasPanel::CloseUndoBundle(const utf8_string& name){
 }
 
 PosInfo CanvasPanel::HitTest(const IntPoint& ptView, const ToolModifiers& mod){
+  return HitTest(ptView, mod, m_state.geo);
+}
+
+PosInfo CanvasPanel::HitTest(const IntPoint& ptView, const ToolModifiers& mod,
+  const CanvasGeo& geo)
+{
   ObjectInfo objInfo = hit_test(ptView,
     m_images.Active(),
-    m_state.geo, objectHandleWidth);
+    geo, objectHandleWidth);
 
-  Point ptImage = mouse::view_to_image(ptView, m_state.geo);
+  Point ptImage = mouse::view_to_image(ptView, geo);
   PosInfo info = {
     GetInterface(),
     m_statusInfo,
@@ -1119,6 +1179,21 @@ void CanvasPanel::RunCommand(Command* cmd,
   m_contexts.GetTool().SelectionChange();
 }
 
+void CanvasPanel::FlushMotion(){
+  // Forwards all queued mouse positions, so that freehand tools get
+  // every position, but refreshes only once. Handling a position can
+  // flush again (via MousePosRefresh), which then continues with the
+  // remaining positions.
+  bool refresh = false;
+  m_motion.samples.Drain([&](const MotionSample& sample){
+    refresh = MouseMoveTo(sample.pos, sample.modifiers, sample.geo) ||
+      refresh;
+  });
+  if (refresh){
+    RefreshToolRect();
+  }
+}
+
 // Refreshes the union of the rectangle parameter and the rectangle
 // parameter from the previous call.
 void CanvasPanel::InclusiveRefresh(const IntRect& r){
@@ -30,6 +30,8 @@
 #include "util/grid.hh"
 #include "util/id-types.hh"
 #include "util/image-list.hh"
+#include "util/motion-queue.hh"
+#include "util/pos-info.hh"
 #include "util-wx/file-path.hh"
 
 class wxFileDropTarget;
@@ -39,7 +41,6 @@ namespace faint{
 class ArtContainer;
 class IntPoint;
 class PosInfo;
-class ToolModifiers;
 
 enum class PreemptResult{ NONE, COMMIT, CANCEL };
 enum class PreemptOption{ ALLOW_COMMAND, DISCARD_COMMAND };
@@ -118,6 +119,7 @@ public:
   Point GetRelativeMousePos();
   Index GetSelectedFrame() const;
   utf8_string GetUndoName() const;
+  IntRect GetVisibleImageRect() const;
   coord GetZoom() const;
   const ZoomLevel& GetZoomLevel() const;
   bool Has(const ObjectId&);
@@ -161,13 +163,17 @@ private:
   const RasterSelection& GetImageSelection() const;
   enum RefreshMode{REFRESH, NO_REFRESH};
   void CommitTool(Tool&, RefreshMode);
+  void FlushMotion();
   int GetHorizontalPageSize() const;
   int GetVerticalPageSize() const;
   bool HandleToolResult(ToolResult);
   PosInfo HitTest(const IntPoint&, const ToolModifiers&);
+  PosInfo HitTest(const IntPoint&, const ToolModifiers&, const CanvasGeo&);
   bool IgnoreCanvasHandle(const PosInfo&);
   void InclusiveRefresh(const IntRect&);
   void MousePosRefresh(const IntPoint&, const ToolModifiers&);
+  bool MouseMoveTo(const IntPoint&, const ToolModifiers&, const CanvasGeo&);
+  void QueueMotion(const IntPoint&, const ToolModifiers&);
   void RefreshToolRect();
   void RunCommand(Command*, const clear_redo&, Image*);
   void ScrollLineUp();
@@ -205,6 +211,11 @@ private:
 
   MouseCapture m_mouse;
 
+  struct {
+    MotionQueue samples;
+    bool flushQueued = false;
+  } m_motion;
+
   bool m_probablyCtrlEnter = false; // \ref(ctrl-enter-workaround)
 
   struct {
@@ -17,6 +17,7 @@
 #define FAINT_COMMAND_DIALOG_HH
 #include <functional>
 #include "commands/bitmap-cmd.hh"
+#include "geo/primitive.hh"
 #include "util/template-fwd.hh"
 
 class wxWindow;
@@ -25,6 +26,8 @@ namespace faint{
 
 class Canvas;
 class Command;
+class IntPoint;
+class IntRect;
 
 class DialogFeedback{
   // Context for letting dialogs show feedback on a Bitmap
@@ -35,6 +38,15 @@ public:
   virtual const Bitmap& GetBitmap() = 0;
   virtual void SetBitmap(const Bitmap&) = 0;
   virtual void SetBitmap(Bitmap&&) = 0;
+
+  // Replaces the pixels of the feedback bitmap at the position with
+  // the bitmap, without copying the rest of the feedback bitmap.
+  virtual void SetBitmapRegion(const Bitmap&, const IntPoint&) = 0;
+
+  // The part of the feedback bitmap visible in the canvas, and the
+  // zoom it is shown at, for limiting previews to what is seen.
+  virtual IntRect GetVisibleRect() const = 0;
+  virtual coord GetZoom() const = 0;
 };
 
 using bmp_dialog_func =
@@ -35,6 +35,15 @@ public:
   virtual Bitmap GetBitmap() = 0;
   virtual void SetBitmap(const Bitmap&) = 0; // Fixme: Rename to SetPreview
 
+  // Replaces the pixels of the feedback bitmap at the position with
+  // the bitmap, without copying the rest of the feedback bitmap.
+  virtual void SetBitmapRegion(const Bitmap&, const IntPoint&) = 0;
+
+  // The part of the feedback bitmap visible in the canvas, and the
+  // zoom it is shown at, for limiting previews to what is seen.
+  virtual IntRect GetVisibleRect() const = 0;
+  virtual coord GetZoom() const = 0;
+
   virtual void Reset() = 0; // Fixme: Do not expose this here, should not be visible to the command windows.
   virtual void UpdateSettings(const Settings&) = 0; // Fixme: Do not expose this here, should not be visible to the command windows.
 
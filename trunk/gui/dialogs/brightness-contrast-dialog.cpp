@@ -22,6 +22,7 @@
 #include "gui/layout.hh"
 #include "gui/slider.hh"
 #include "gui/command-dialog.hh"
+#include "gui/filter-preview.hh"
 #include "util-wx/fwd-bind.hh"
 #include "util-wx/fwd-wx.hh"
 #include "util-wx/key-codes.hh"
@@ -44,14 +45,13 @@ public:
       wxDefaultPosition,
       wxDefaultSize,
       wxDEFAULT_DIALOG_STYLE | wxWANTS_CHARS | wxRESIZE_BORDER),
-      m_bitmap(feedback.GetBitmap()),
-      m_feedback(feedback)
+      m_preview(*this, feedback)
   {
     using namespace layout;
 
     // Create the member-controls in intended tab-order (placement follows)
     m_enablePreview = create_checkbox(this, "&Preview",
-      enable_preview_default(m_bitmap),
+      enable_preview_default(m_preview.GetBitmap()),
       [&](){
         if (!PreviewEnabled()){
           ResetPreview();
@@ -131,18 +131,21 @@ private:
   }
 
   void ResetPreview(){
-    m_feedback.SetBitmap(m_bitmap);
+    m_preview.Reset();
   }
 
   void UpdatePreview(){
-    m_feedback.SetBitmap(brightness_and_contrast(m_bitmap, GetValues()));
+    const auto values = GetValues();
+    m_preview.Update(PreviewFilter::Pixelwise(
+      [values](const Bitmap& bmp){
+        return brightness_and_contrast(bmp, values);
+      }));
   }
 
-  Bitmap m_bitmap;
   Slider* m_brightnessSlider = nullptr;
   Slider* m_contrastSlider = nullptr;
   wxCheckBox* m_enablePreview = nullptr;
-  DialogFeedback& m_feedback;
+  FilterPreview m_preview;
 };
 
 Optional<BitmapCommand*> show_brightness_contrast_dialog(wxWindow& parent,
@@ -17,6 +17,7 @@
 #include "wx/dialog.h"
 #include "bitmap/bitmap-templates.hh"
 #include "commands/function-cmd.hh"
+#include "gui/filter-preview.hh"
 #include "gui/layout.hh"
 #include "gui/dual-slider.hh"
 #include "gui/slider-histogram-background.hh"
@@ -35,12 +36,11 @@ public:
     : wxDialog(&parent, wxID_ANY, "Color Balance",
       wxDefaultPosition, wxDefaultSize,
       wxDEFAULT_DIALOG_STYLE | wxWANTS_CHARS | wxRESIZE_BORDER),
-      m_bitmap(feedback.GetBitmap()),
       m_enablePreview(nullptr),
-      m_feedback(feedback),
       m_redSlider(nullptr),
       m_greenSlider(nullptr),
-      m_blueSlider(nullptr)
+      m_blueSlider(nullptr),
+      m_preview(*this, feedback)
   {
     // Create the member-controls in intended tab-order (placement follows)
     m_enablePreview = create_checkbox(this, "&Preview", true,
@@ -62,9 +62,10 @@ public:
         ui::horizontal_slider_size);
     };
 
-    m_redSlider = create_color_slider(ui::nice_red,red_histogram(m_bitmap));
-    m_greenSlider = create_color_slider(ui::nice_green, green_histogram(m_bitmap));
-    m_blueSlider = create_color_slider(ui::nice_blue, blue_histogram(m_bitmap));
+    const Bitmap& bmp(m_preview.GetBitmap());
+    m_redSlider = create_color_slider(ui::nice_red,red_histogram(bmp));
+    m_greenSlider = create_color_slider(ui::nice_green, green_histogram(bmp));
+    m_blueSlider = create_color_slider(ui::nice_blue, blue_histogram(bmp));
 
     // Outer-most sizer
     using namespace layout;
@@ -120,22 +121,24 @@ private:
   }
 
   void ResetPreview(){
-    m_feedback.SetBitmap(m_bitmap);
+    m_preview.Reset();
   }
 
   void UpdatePreview(){
     color_range_t red = GetRange(m_redSlider);
     color_range_t green = GetRange(m_greenSlider);
     color_range_t blue = GetRange(m_blueSlider);
-    m_feedback.SetBitmap(onto_new(color_balance, m_bitmap, red, green, blue));
+    m_preview.Update(PreviewFilter::Pixelwise(
+      [=](const Bitmap& bmp){
+        return onto_new(color_balance, bmp, red, green, blue);
+      }));
   }
 
-  Bitmap m_bitmap;
   wxCheckBox* m_enablePreview;
-  DialogFeedback& m_feedback;
   DualSlider* m_redSlider;
   DualSlider* m_greenSlider;
   DualSlider* m_blueSlider;
+  FilterPreview m_preview;
 };
 
 Optional<BitmapCommand*> show_color_balance_dialog(wxWindow& parent,
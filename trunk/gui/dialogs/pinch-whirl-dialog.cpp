@@ -17,6 +17,7 @@
 #include "wx/dialog.h"
 #include "wx/sizer.h"
 #include "bitmap/bitmap-templates.hh"
+#include "gui/filter-preview.hh"
 #include "gui/layout.hh"
 #include "gui/slider.hh"
 #include "util-wx/fwd-wx.hh"
@@ -35,11 +36,10 @@ public:
         wxDefaultPosition,
         wxDefaultSize,
         wxDEFAULT_DIALOG_STYLE | wxWANTS_CHARS | wxRESIZE_BORDER),
-      m_bitmap(feedback.GetBitmap()),
       m_pinchSlider(nullptr),
       m_whirlSlider(nullptr),
       m_enablePreviewCheck(nullptr),
-      m_feedback(feedback)
+      m_preview(*this, feedback)
   {
     using namespace layout;
 
@@ -121,19 +121,26 @@ private:
   }
 
   void ResetPreview(){
-    m_feedback.SetBitmap(m_bitmap);
+    m_preview.Reset();
   }
 
   void UpdatePreview(){
-    m_feedback.SetBitmap(onto_new(filter_pinch_whirl, m_bitmap,
-      GetPinchValue(), GetWhirlValue()));
+    const coord pinch = GetPinchValue();
+    const Angle whirl = GetWhirlValue();
+
+    // Pixels move around the center of the bitmap, so any pixel can
+    // end up in the visible region. The distortion is relative to the
+    // bitmap size, so a zoomed out preview can use a scaled bitmap.
+    m_preview.Update(PreviewFilter::ScaleInvariant(
+      [pinch, whirl](const Bitmap& bmp){
+        return onto_new(filter_pinch_whirl, bmp, pinch, whirl);
+      }));
   }
 
-  Bitmap m_bitmap;
   Slider* m_pinchSlider;
   Slider* m_whirlSlider;
   wxCheckBox* m_enablePreviewCheck;
-  DialogFeedback& m_feedback;
+  FilterPreview m_preview;
 };
 
 Optional<BitmapCommand*> show_pinch_whirl_dialog(wxWindow& parent,
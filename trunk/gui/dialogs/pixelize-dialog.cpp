@@ -16,6 +16,7 @@
 #include "wx/dialog.h"
 #include "wx/sizer.h"
 #include "bitmap/bitmap-templates.hh"
+#include "gui/filter-preview.hh"
 #include "gui/slider.hh"
 #include "util-wx/gui-util.hh"
 #include "util-wx/key-codes.hh"
@@ -35,16 +36,15 @@ public:
   PixelizeDialog(wxWindow& parent, DialogFeedback& feedback)
     : wxDialog(&parent, wxID_ANY, "Pixelize", wxDefaultPosition, wxDefaultSize,
       wxDEFAULT_DIALOG_STYLE | wxWANTS_CHARS | wxRESIZE_BORDER),
-      m_bitmap(feedback.GetBitmap()),
       m_pixelSizeSlider(nullptr),
       m_enablePreview(nullptr),
-      m_feedback(feedback)
+      m_preview(*this, feedback)
   {
     using namespace layout;
 
     // Create the member-controls in intended tab-order (placement follows)
     m_enablePreview = create_checkbox(this, "&Preview",
-      enable_preview_default(m_bitmap),
+      enable_preview_default(m_preview.GetBitmap()),
       [&](){
         if (PreviewEnabled()){
           UpdatePreview();
@@ -105,18 +105,21 @@ private:
   }
 
   void ResetPreview(){
-    m_feedback.SetBitmap(m_bitmap);
+    m_preview.Reset();
   }
 
   void UpdatePreview(){
-    m_feedback.SetBitmap(onto_new(pixelize, m_bitmap,
-      m_pixelSizeSlider->GetValue()));
+    // Each cell is averaged, so the region is extended to whole cells
+    const int width = m_pixelSizeSlider->GetValue();
+    m_preview.Update(PreviewFilter::Local(0, width,
+      [width](const Bitmap& bmp){
+        return onto_new(pixelize, bmp, width);
+      }));
   }
 
-  Bitmap m_bitmap;
   Slider* m_pixelSizeSlider;
   wxCheckBox* m_enablePreview;
-  DialogFeedback& m_feedback;
+  FilterPreview m_preview;
 };
 
 Optional<BitmapCommand*> show_pixelize_dialog(wxWindow& parent,
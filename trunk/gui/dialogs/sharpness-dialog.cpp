@@ -14,12 +14,14 @@
 // permissions and limitations under the License.
 
 #include <algorithm>
+#include <cmath>
 #include "wx/dialog.h"
 #include "wx/sizer.h"
 #include "bitmap/bitmap-templates.hh"
 #include "bitmap/filter.hh"
 #include "bitmap/gaussian-blur.hh"
 #include "commands/function-cmd.hh"
+#include "gui/filter-preview.hh"
 #include "gui/slider.hh"
 #include "util-wx/fwd-wx.hh"
 #include "util-wx/gui-util.hh"
@@ -39,14 +41,13 @@ public:
   SharpnessDialog(wxWindow& parent, DialogFeedback& feedback)
     : wxDialog(&parent, wxID_ANY, "Sharpness", wxDefaultPosition, wxDefaultSize,
         wxDEFAULT_DIALOG_STYLE | wxWANTS_CHARS | wxRESIZE_BORDER),
-      m_bitmap(feedback.GetBitmap()),
       m_enablePreview(nullptr),
-      m_feedback(feedback),
-      m_sharpnessSlider(nullptr)
+      m_sharpnessSlider(nullptr),
+      m_preview(*this, feedback)
   {
     // Create the member-controls in intended tab-order (placement follows)
     m_enablePreview = create_checkbox(this, "&Preview",
-      enable_preview_default(m_bitmap),
+      enable_preview_default(m_preview.GetBitmap()),
       [&](){
         if (PreviewEnabled()){
           UpdatePreview();
@@ -113,28 +114,37 @@ private:
   }
 
   void ResetPreview(){
-    m_feedback.SetBitmap(m_bitmap);
+    m_preview.Reset();
   }
 
   void UpdatePreview(){
     if (ValidSharpness()){
       double sharpness = GetSharpness();
+
+      // The blur reaches about three sigma
+      const int margin = static_cast<int>(std::ceil(3 * std::fabs(sharpness)))
+        + 2;
       if (sharpness < 0){
-        m_feedback.SetBitmap(gaussian_blur_fast(m_bitmap, -sharpness));
+        m_preview.Update(PreviewFilter::Local(margin, 1,
+          [sharpness](const Bitmap& bmp){
+            return gaussian_blur_fast(bmp, -sharpness);
+          }));
       }
       else {
-        m_feedback.SetBitmap(unsharp_mask_fast(m_bitmap, sharpness));
+        m_preview.Update(PreviewFilter::Local(margin, 1,
+          [sharpness](const Bitmap& bmp){
+            return unsharp_mask_fast(bmp, sharpness);
+          }));
       }
     }
     else{
-      m_feedback.SetBitmap(m_bitmap);
+      m_preview.Reset();
     }
   }
 
-  Bitmap m_bitmap;
   wxCheckBox* m_enablePreview;
-  DialogFeedback& m_feedback;
   Slider* m_sharpnessSlider;
+  FilterPreview m_preview;
 };
 
 Optional<BitmapCommand*> show_sharpness_dialog(wxWindow& parent,
@@ -13,11 +13,13 @@
 // implied. See the License for the specific language governing
 // permissions and limitations under the License.
 
+#include "wx/dialog.h"
 #include "bitmap/bitmap-templates.hh" // onto_new
 #include "bitmap/filter.hh"
 #include "gui/command-window.hh"
 #include "gui/dialog-context.hh"
 #include "gui/dual-slider.hh"
+#include "gui/filter-preview.hh"
 #include "gui/layout.hh"
 #include "gui/slider-histogram-background.hh"
 #include "util/command-util.hh" // get_threshold_command
@@ -43,13 +45,13 @@ public:
   }
 
   void Show(wxWindow& parent, WindowFeedback& feedback) override{
-    m_bitmap = feedback.GetBitmap();
     m_feedback = &feedback;
 
     auto cancel = [&](){Close();};
     auto ok = [&](){Close(true);};
 
     m_dialog = create_dialog(parent, "Threshold");
+    m_preview = std::make_unique<FilterPreview>(*m_dialog, feedback);
 
     events::on_close_window(m_dialog, cancel);
     m_enablePreview = create_checkbox(m_dialog, "Preview", true,
@@ -64,7 +66,7 @@ public:
 
     m_slider = create_dual_slider(raw(m_dialog),
       fractional_bounded_interval<threshold_range_t>(0.2, 0.8),
-      threshold_histogram_background(m_bitmap),
+      threshold_histogram_background(m_preview->GetBitmap()),
       ui::tall_horizontal_slider_size,
       [&](const Interval&, bool){
         if (get(m_enablePreview)){
@@ -95,6 +97,11 @@ public:
   }
 
   bool MouseMove(const PosInfo&) override{
+    // The canvas may have been scrolled or zoomed since the preview
+    // was computed for the visible region.
+    if (m_preview != nullptr){
+      m_preview->Refresh();
+    }
     return false;
   }
 
@@ -123,6 +130,7 @@ private:
           m_settings.Get(ts_Fg),
           m_settings.Get(ts_Bg))
         : nullptr;
+      m_preview.reset();
       m_dialog.reset(nullptr);
       m_feedback->Closed(cmd);
       m_feedback = nullptr;
@@ -130,13 +138,24 @@ private:
   }
 
   void UpdatePreview(){
-    m_feedback->SetBitmap(onto_new(threshold, m_bitmap, GetCurrentRange(),
-      m_settings.Get(ts_Fg), m_settings.Get(ts_Bg)));
+    const auto range = GetCurrentRange();
+    const Paint fg = m_settings.Get(ts_Fg);
+    const Paint bg = m_settings.Get(ts_Bg);
+    auto filter = [=](const Bitmap& bmp){
+      return onto_new(threshold, bmp, range, fg, bg);
+    };
+
+    // Patterns and gradients depend on the position in the bitmap,
+    // so only plain colors can be previewed for the visible region.
+    m_preview->Update(fg.IsColor() && bg.IsColor() ?
+      PreviewFilter::Pixelwise(filter) :
+      PreviewFilter::Global(filter));
   }
 
   void Reinitialize(WindowFeedback& feedback) override{
-    m_bitmap = feedback.GetBitmap();
-    m_slider->SetBackground(threshold_histogram_background(m_bitmap));
+    m_preview = std::make_unique<FilterPreview>(*m_dialog, feedback);
+    m_slider->SetBackground(threshold_histogram_background(
+      m_preview->GetBitmap()));
     UpdatePreview();
   }
 
@@ -145,14 +164,14 @@ private:
   }
 
   void ResetPreview(){
-    m_feedback->SetBitmap(m_bitmap);
+    m_preview->Reset();
   }
 
   wxCheckBox* m_enablePreview = nullptr;
   DualSlider* m_slider = nullptr;
   unique_dialog_ptr m_dialog;
   Settings m_settings;
-  Bitmap m_bitmap;
+  std::unique_ptr<FilterPreview> m_preview;
   WindowFeedback* m_feedback = nullptr;
 };
 
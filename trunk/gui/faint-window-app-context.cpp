@@ -18,6 +18,8 @@
 #include "app/app-context.hh"
 #include "app/context-commands.hh"
 #include "bitmap/draw.hh"
+#include "geo/int-rect.hh"
+#include "geo/offsat.hh"
 #include "gui/command-window.hh"
 #include "gui/faint-window.hh"
 #include "gui/faint-window-app-context.hh"
@@ -58,6 +60,18 @@ void SBInterface::SetText(const utf8_string& text, int field){
   m_statusbar.SetStatusText(to_wx(text), field + 1);
 }
 
+static IntRect visible_feedback_rect(const Canvas& canvas){
+  // The feedback bitmap is the selected region when there is a
+  // selection, otherwise the entire image.
+  const IntRect visible(canvas.GetVisibleImageRect());
+  const RasterSelection& selection = canvas.GetImage().GetRasterSelection();
+  if (!selection.Exists()){
+    return visible;
+  }
+  const IntRect selected(selection.GetRect());
+  return translated(intersection(visible, selected), -selected.TopLeft());
+}
+
 void SBInterface::Clear(){
   for (int i = 0; i != m_statusbar.GetFieldsCount(); i++){
     m_statusbar.SetStatusText("", i);
@@ -104,6 +118,22 @@ public:
     Update();
   }
 
+  void SetBitmapRegion(const Bitmap& bmp, const IntPoint& topLeft) override{
+    if (m_bitmap == nullptr){
+      Initialize();
+    }
+    blit(offsat(bmp, topLeft), onto(*m_bitmap));
+    Update();
+  }
+
+  IntRect GetVisibleRect() const override{
+    return visible_feedback_rect(m_app.GetActiveCanvas());
+  }
+
+  coord GetZoom() const override{
+    return m_app.GetActiveCanvas().GetZoom();
+  }
+
   void Reset() override{
     m_bitmap = nullptr;
     m_rasterSelection = nullptr;
@@ -283,6 +313,22 @@ public:
     Update();
   }
 
+  void SetBitmapRegion(const Bitmap& bmp, const IntPoint& topLeft) override{
+    if (m_bitmap == nullptr){
+      Initialize();
+    }
+    blit(offsat(bmp, topLeft), onto(*m_bitmap));
+    Update();
+  }
+
+  IntRect GetVisibleRect() const override{
+    return visible_feedback_rect(m_canvas);
+  }
+
+  coord GetZoom() const override{
+    return m_canvas.GetZoom();
+  }
+
 private:
   void Update(){
     if (m_rasterSelection != nullptr && m_rasterSelection->Floating()){
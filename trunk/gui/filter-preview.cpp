@@ -0,0 +1,133 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include "wx/event.h"
+#include "geo/geo-func.hh"
+#include "geo/int-point.hh"
+#include "gui/command-dialog.hh"
+#include "gui/command-window.hh"
+#include "gui/filter-preview.hh"
+
+namespace faint{
+
+class FilterPreview::Target{
+  // The feedback of either a dialog or a window.
+public:
+  template<typename FEEDBACK>
+  explicit Target(FEEDBACK& feedback)
+    : getBitmap([&](){return feedback.GetBitmap();}),
+      getVisibleRect([&](){return feedback.GetVisibleRect();}),
+      getZoom([&](){return feedback.GetZoom();}),
+      setBitmap([&](const Bitmap& bmp){feedback.SetBitmap(bmp);}),
+      setBitmapRegion([&](const Bitmap& bmp, const IntPoint& pos){
+        feedback.SetBitmapRegion(bmp, pos);
+      })
+  {}
+
+  std::function<Bitmap()> getBitmap;
+  std::function<IntRect()> getVisibleRect;
+  std::function<coord()> getZoom;
+  std::function<void(const Bitmap&)> setBitmap;
+  std::function<void(const Bitmap&, const IntPoint&)> setBitmapRegion;
+};
+
+class FilterPreview::State{
+  // Shared with the delivered results, which may arrive after the
+  // FilterPreview is destroyed.
+public:
+  explicit State(const std::function<void(const Bitmap&, const IntPoint&)>& f)
+    : setBitmapRegion(f)
+  {}
+
+  // Identifies the most recent preview, results of earlier previews
+  // are discarded.
+  unsigned int latest = 0;
+  std::function<void(const Bitmap&, const IntPoint&)> setBitmapRegion;
+};
+
+FilterPreview::FilterPreview(wxEvtHandler& owner,
+  std::unique_ptr<Target> target)
+  : m_owner(owner),
+    m_source(std::make_shared<const Bitmap>(target->getBitmap())),
+    m_state(std::make_shared<State>(target->setBitmapRegion)),
+    m_target(std::move(target))
+{}
+
+FilterPreview::FilterPreview(wxEvtHandler& owner, DialogFeedback& feedback)
+  : FilterPreview(owner, std::make_unique<Target>(feedback))
+{}
+
+FilterPreview::FilterPreview(wxEvtHandler& owner, WindowFeedback& feedback)
+  : FilterPreview(owner, std::make_unique<Target>(feedback))
+{}
+
+FilterPreview::~FilterPreview(){
+  m_worker.Cancel();
+}
+
+const Bitmap& FilterPreview::GetBitmap() const{
+  return *m_source;
+}
+
+void FilterPreview::Refresh(){
+  if (m_filter != nullptr){
+    const IntRect region(m_target->getVisibleRect());
+    if (region != m_region){
+      Post(*m_filter, region);
+    }
+  }
+}
+
+void FilterPreview::Reset(){
+  m_filter.reset();
+  m_state->latest++;
+  m_worker.Cancel();
+  m_target->setBitmap(*m_source);
+}
+
+void FilterPreview::Update(const PreviewFilter& filter){
+  m_filter = std::make_unique<PreviewFilter>(filter);
+  Post(filter, m_target->getVisibleRect());
+}
+
+void FilterPreview::Post(const PreviewFilter& filter, const IntRect& region){
+  m_region = region;
+  const unsigned int id = ++m_state->latest;
+  if (empty(region)){
+    m_worker.Cancel();
+    return;
+  }
+
+  const coord zoom = m_target->getZoom();
+  std::shared_ptr<const Bitmap> source(m_source);
+  std::weak_ptr<State> weakState(m_state);
+  wxEvtHandler* owner = &m_owner;
+
+  m_worker.Post(
+    [=](const CoalescingWorker::is_cancelled_t& isCancelled){
+      filter_region(*source, filter, region, zoom, isCancelled).Visit(
+        [&](const Bitmap& result){
+          // Deliver on the GUI-thread, unless superseded by then
+          owner->CallAfter([=](){
+            auto state = weakState.lock();
+            if (state != nullptr && state->latest == id){
+              state->setBitmapRegion(result, region.TopLeft());
+            }
+          });
+        });
+    });
+}
+
+} // namespace
@@ -0,0 +1,80 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FAINT_FILTER_PREVIEW_HH
+#define FAINT_FILTER_PREVIEW_HH
+#include <memory>
+#include "bitmap/bitmap.hh"
+#include "geo/int-rect.hh"
+#include "util/coalescing-worker.hh"
+#include "util/preview-filter.hh"
+
+class wxEvtHandler;
+
+namespace faint{
+
+class DialogFeedback;
+class WindowFeedback;
+
+class FilterPreview{
+  // Computes previews of filters for dialogs on a worker thread,
+  // limited to the part of the bitmap visible in the canvas.
+  //
+  // Updates while a preview is computed replace the pending preview
+  // and cancel the running, so that only the latest filter is
+  // shown. The full-resolution result should be computed when the
+  // dialog is accepted, since the preview may have been computed
+  // from less than the entire bitmap.
+public:
+  // The results are delivered to the feedback on the thread of the
+  // event handler, which must outlive the FilterPreview.
+  FilterPreview(wxEvtHandler&, DialogFeedback&);
+  FilterPreview(wxEvtHandler&, WindowFeedback&);
+  ~FilterPreview();
+
+  // The unfiltered bitmap.
+  const Bitmap& GetBitmap() const;
+
+  // Re-runs the latest filter if the visible region has changed
+  // since it was previewed.
+  void Refresh();
+
+  // Cancels any pending preview and restores the unfiltered bitmap.
+  void Reset();
+
+  // Starts computing the preview for the filter, replacing any
+  // pending preview.
+  void Update(const PreviewFilter&);
+
+  FilterPreview(const FilterPreview&) = delete;
+  FilterPreview& operator=(const FilterPreview&) = delete;
+private:
+  class Target;
+  class State;
+  FilterPreview(wxEvtHandler&, std::unique_ptr<Target>);
+  void Post(const PreviewFilter&, const IntRect&);
+
+  std::unique_ptr<PreviewFilter> m_filter;
+  wxEvtHandler& m_owner;
+  IntRect m_region;
+  std::shared_ptr<const Bitmap> m_source;
+  std::shared_ptr<State> m_state;
+  std::unique_ptr<Target> m_target;
+  CoalescingWorker m_worker;
+};
+
+} // namespace
+
+#endif
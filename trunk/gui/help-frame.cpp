@@ -465,29 +465,58 @@ private:
   bool m_updateOnTree;
 };
 
+struct HelpFrame::Deferred{
+  // Arguments for creating the frame when first shown
+  Deferred(const wxString& rootDir, const ArtContainer& art)
+    : rootDir(rootDir),
+      art(art)
+  {}
+
+  wxString rootDir;
+  const ArtContainer& art;
+  wxIconBundle icons;
+};
+
 HelpFrame::HelpFrame(const DirPath& rootDir, const ArtContainer& art)
-  : m_impl(make_dumb<HelpFrameImpl>(to_wx(rootDir.Str()), art))
-{
-  restore_persisted_state(m_impl.get(), storage_name("HelpFrame"));
-}
+  : m_deferred(std::make_unique<Deferred>(to_wx(rootDir.Str()), art)),
+    m_impl(nullptr),
+    m_closed(false)
+{}
 
 HelpFrame::~HelpFrame(){
   if (m_impl != nullptr){
     Close();
   }
- }
+}
+
+HelpFrame::HelpFrameImpl& HelpFrame::Impl(){
+  assert(!m_closed);
+  if (m_impl == nullptr){
+    m_impl = make_dumb<HelpFrameImpl>(m_deferred->rootDir, m_deferred->art);
+    restore_persisted_state(m_impl.get(), storage_name("HelpFrame"));
+    if (!m_deferred->icons.IsEmpty()){
+      m_impl->SetIcons(m_deferred->icons);
+    }
+  }
+  return *m_impl;
+}
 
 void HelpFrame::Close(){
-  m_impl->Close(true);
-  m_impl = nullptr;
+  if (m_impl != nullptr){
+    m_impl->Close(true);
+    m_impl = nullptr;
+  }
+  m_closed = true;
 }
 
 void HelpFrame::Hide(){
-  m_impl->Hide();
+  if (m_impl != nullptr){
+    m_impl->Hide();
+  }
 }
 
 bool HelpFrame::HasFocus() const{
-  return m_impl->FaintHasFocus();
+  return m_impl != nullptr && m_impl->FaintHasFocus();
 }
 
 bool HelpFrame::IsHidden() const{
@@ -495,27 +524,30 @@ bool HelpFrame::IsHidden() const{
 }
 
 bool HelpFrame::IsIconized() const{
-  return m_impl->IsIconized();
+  return m_impl != nullptr && m_impl->IsIconized();
 }
 
 bool HelpFrame::IsShown() const{
-  return m_impl->IsShown();
+  return m_impl != nullptr && m_impl->IsShown();
 }
 
 void HelpFrame::Raise(){
-  m_impl->Raise();
+  Impl().Raise();
 }
 
 void HelpFrame::Restore(){
-  m_impl->Restore();
+  Impl().Restore();
 }
 
 void HelpFrame::SetIcons(const wxIcon& icon16, const wxIcon& icon32){
-  m_impl->SetIcons(bundle_icons(icon16, icon32));
+  m_deferred->icons = bundle_icons(icon16, icon32);
+  if (m_impl != nullptr){
+    m_impl->SetIcons(m_deferred->icons);
+  }
 }
 
 void HelpFrame::Show(){
-  m_impl->FaintShow();
+  Impl().FaintShow();
 }
 
 } // namespace
@@ -15,6 +15,7 @@
 
 #ifndef FAINT_HELP_FRAME_HH
 #define FAINT_HELP_FRAME_HH
+#include <memory>
 #include "util/dumb-ptr.hh"
 
 class wxIcon;
@@ -28,6 +29,8 @@ class HelpFrame {
 // The frame containing the html help for Faint.
 // Used instead of the wxHtmlHelpFrame to allow more customization,
 // like closing on F1.
+//
+// The frame is created when first shown.
 public:
   HelpFrame(const DirPath& rootDir, const ArtContainer&);
   ~HelpFrame();
@@ -44,7 +47,12 @@ public:
 private:
   HelpFrame(const HelpFrame&);
   class HelpFrameImpl;
+  HelpFrameImpl& Impl();
+
+  struct Deferred;
+  std::unique_ptr<Deferred> m_deferred;
   dumb_ptr<HelpFrameImpl> m_impl;
+  bool m_closed;
 };
 
 } // namespace
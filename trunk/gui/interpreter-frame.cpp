@@ -89,11 +89,17 @@ private:
   scoped_ref m_ifaint;
 };
 
+struct InterpreterFrame::Deferred{
+  // State for the frame until it is created
+  wxIconBundle icons;
+  std::vector<std::function<void(InterpreterCtrl&)>> calls;
+};
+
 InterpreterFrame::InterpreterFrame()
-  : m_impl(make_dumb<InterpreterFrameImpl>())
-{
-  restore_persisted_state(m_impl.get(), storage_name("InterpreterFrame"));
-}
+  : m_deferred(std::make_unique<Deferred>()),
+    m_impl(nullptr),
+    m_closed(false)
+{}
 
 InterpreterFrame::~InterpreterFrame(){
   if (m_impl != nullptr){
@@ -102,81 +108,133 @@ InterpreterFrame::~InterpreterFrame(){
   }
 }
 
+InterpreterFrameImpl& InterpreterFrame::Impl(){
+  assert(!m_closed);
+  if (m_impl == nullptr){
+    m_impl = make_dumb<InterpreterFrameImpl>();
+    restore_persisted_state(m_impl.get(), storage_name("InterpreterFrame"));
+    if (!m_deferred->icons.IsEmpty()){
+      m_impl->SetIcons(m_deferred->icons);
+    }
+    for (const auto& f : m_deferred->calls){
+      f(m_impl->GetInterpreterCtrl());
+    }
+    m_deferred->calls.clear();
+  }
+  return *m_impl;
+}
+
+void InterpreterFrame::WithCtrl(
+  const std::function<void(InterpreterCtrl&)>& f)
+{
+  if (m_impl == nullptr){
+    m_deferred->calls.push_back(f);
+  }
+  else{
+    f(m_impl->GetInterpreterCtrl());
+  }
+}
+
 void InterpreterFrame::AddNames(const std::vector<utf8_string>& names){
-  m_impl->GetInterpreterCtrl().AddNames(names);
+  WithCtrl([names](InterpreterCtrl& ctrl){
+    ctrl.AddNames(names);
+  });
 }
 
 void InterpreterFrame::Close(){
-  m_impl->Close(true);
-  m_impl = nullptr;
+  if (m_impl != nullptr){
+    m_impl->Close(true);
+    m_impl = nullptr;
+  }
+  m_closed = true;
 }
 
 bool InterpreterFrame::HasFocus() const{
-  return m_impl->HasFocus() || m_impl->GetInterpreterCtrl().HasFocus();
+  return m_impl != nullptr &&
+    (m_impl->HasFocus() || m_impl->GetInterpreterCtrl().HasFocus());
 }
 
 void InterpreterFrame::Hide(){
-  m_impl->Hide();
+  if (m_impl != nullptr){
+    m_impl->Hide();
+  }
 }
 
 bool InterpreterFrame::IsIconized() const{
-  return m_impl->IsIconized();
+  return m_impl != nullptr && m_impl->IsIconized();
 }
 
 void InterpreterFrame::Raise(){
-  m_impl->Raise();
+  Impl().Raise();
 }
 
 void InterpreterFrame::Restore(){
-  return m_impl->Restore();
+  return Impl().Restore();
 }
 
 void InterpreterFrame::SetBackgroundColor(const ColRGB& c){
-  m_impl->GetInterpreterCtrl().SetBackgroundColor(c);
+  WithCtrl([c](InterpreterCtrl& ctrl){
+    ctrl.SetBackgroundColor(c);
+  });
 }
 
 void InterpreterFrame::SetIcons(const wxIcon& icon16, const wxIcon& icon32){
-  m_impl->SetIcons(bundle_icons(icon16, icon32));
+  m_deferred->icons = bundle_icons(icon16, icon32);
+  if (m_impl != nullptr){
+    m_impl->SetIcons(m_deferred->icons);
+  }
 }
 
 void InterpreterFrame::Show(){
-  m_impl->Show();
+  Impl().Show();
 }
 
 void InterpreterFrame::GetKey(){
-  m_impl->GetInterpreterCtrl().GetKey();
+  WithCtrl([](InterpreterCtrl& ctrl){
+    ctrl.GetKey();
+  });
 }
 
 void InterpreterFrame::IntFaintPrint(const utf8_string& s){
-  m_impl->GetInterpreterCtrl().AppendText(to_wx(s));
+  WithCtrl([s](InterpreterCtrl& ctrl){
+    ctrl.AppendText(to_wx(s));
+  });
 }
 
 bool InterpreterFrame::IsHidden() const{
-  return !m_impl->IsShown();
+  return m_impl == nullptr || !m_impl->IsShown();
 }
 
 bool InterpreterFrame::IsMaximized() const{
-  return !m_impl->IsMaximized();
+  return m_impl == nullptr || !m_impl->IsMaximized();
 }
 
 void InterpreterFrame::Maximize(bool b){
-  m_impl->Maximize(b);
+  Impl().Maximize(b);
 }
 
 void InterpreterFrame::NewContinuation(){
-  m_impl->GetInterpreterCtrl().NewContinuation();
+  WithCtrl([](InterpreterCtrl& ctrl){
+    ctrl.NewContinuation();
+  });
 }
 
 void InterpreterFrame::NewPrompt(){
-  m_impl->GetInterpreterCtrl().NewPrompt();
+  WithCtrl([](InterpreterCtrl& ctrl){
+    ctrl.NewPrompt();
+  });
 }
 
 void InterpreterFrame::Print(const utf8_string& s){
-  m_impl->GetInterpreterCtrl().AddText(to_wx(s));
+  WithCtrl([s](InterpreterCtrl& ctrl){
+    ctrl.AddText(to_wx(s));
+  });
 }
 
 void InterpreterFrame::SetTextColor(const ColRGB& c){
-  m_impl->GetInterpreterCtrl().SetTextColor(c);
+  WithCtrl([c](InterpreterCtrl& ctrl){
+    ctrl.SetTextColor(c);
+  });
 }
 
 } // namespace
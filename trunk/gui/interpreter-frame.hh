@@ -15,6 +15,8 @@
 
 #ifndef FAINT_INTERPRETER_FRAME_HH
 #define FAINT_INTERPRETER_FRAME_HH
+#include <functional>
+#include <memory>
 #include "text/utf8-string.hh"
 #include "util/dumb-ptr.hh"
 
@@ -27,6 +29,10 @@ class InterpreterCtrl;
 class InterpreterFrameImpl;
 
 class InterpreterFrame{
+  // The frame for the interactive Python interpreter.
+  //
+  // The frame is created when first shown. Until then, output and
+  // settings for the interpreter are queued.
 public:
   InterpreterFrame();
   ~InterpreterFrame();
@@ -50,7 +56,13 @@ public:
   void SetTextColor(const ColRGB&);
   void Show();
 private:
+  InterpreterFrameImpl& Impl();
+  void WithCtrl(const std::function<void(InterpreterCtrl&)>&);
+
+  struct Deferred;
+  std::unique_ptr<Deferred> m_deferred;
   dumb_ptr<InterpreterFrameImpl> m_impl;
+  bool m_closed;
 };
 
 } // namespace
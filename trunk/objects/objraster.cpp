@@ -67,10 +67,10 @@ static void apply_transform(const Bitmap& src,
   }
   else {
     if (t2.Width() < 0){
-      dst = flip(dst, along(Axis::HORIZONTAL));
+      flip_in_place(dst, along(Axis::HORIZONTAL));
     }
     if (t2.Height() < 0){
-      dst = flip(dst, across(Axis::HORIZONTAL));
+      flip_in_place(dst, across(Axis::HORIZONTAL));
     }
   }
 
@@ -0,0 +1,64 @@
+"""Benchmark for writing pixels from Python, comparing per-pixel
+commands with the batched set_pixels, fill_spans and blit_buffer.
+
+Run from py/test with:
+  faint --run faint_scripts/bench-pixel-writes.py
+
+Prints the time per pixel for applying, undoing and redoing the
+writes.
+
+"""
+
+from ifaint import *
+import time
+
+WIDTH = 320
+HEIGHT = 200
+
+def timed(func):
+    start = time.perf_counter()
+    func()
+    return time.perf_counter() - start
+
+def report(name, num_pixels, seconds):
+    print("%-28s %10.3f us/pixel (%d pixels, %.3f s)" %
+          (name, seconds * 1e6 / num_pixels, num_pixels, seconds))
+
+def color(x, y):
+    return (x % 256, y % 256, (x + y) % 256)
+
+def bench(name, num_pixels, write):
+    img = Canvas(WIDTH, HEIGHT)
+    report(name, num_pixels, timed(lambda: write(img)))
+    report(name + " (undo)", num_pixels, timed(img.undo))
+    report(name + " (redo)", num_pixels, timed(img.redo))
+    img.close()
+
+def set_pixel_each(img, num_rows):
+    for y in range(num_rows):
+        for x in range(WIDTH):
+            img.set_pixel((x, y), color(x, y))
+
+def set_pixels(img):
+    img.set_pixels([((x, y), color(x, y))
+                    for y in range(HEIGHT) for x in range(WIDTH)])
+
+def fill_spans(img):
+    img.fill_spans([(y % 7, y, WIDTH - 7) for y in range(HEIGHT)],
+                   (255, 0, 0))
+
+def blit_buffer(img):
+    data = bytearray(WIDTH * HEIGHT * 4)
+    for y in range(HEIGHT):
+        for x in range(WIDTH):
+            i = (y * WIDTH + x) * 4
+            data[i:i + 4] = bytes(color(x, y) + (255,))
+    img.blit_buffer((0, 0, WIDTH, HEIGHT), data)
+
+# The per-pixel commands are slow, so fewer rows are written.
+EACH_ROWS = 10
+bench("set_pixel", WIDTH * EACH_ROWS,
+      lambda img: set_pixel_each(img, EACH_ROWS))
+bench("set_pixels", WIDTH * HEIGHT, set_pixels)
+bench("fill_spans", (WIDTH - 7) * HEIGHT, fill_spans)
+bench("blit_buffer", WIDTH * HEIGHT, blit_buffer)
@@ -80,6 +80,25 @@ def test(fail_if):
     fail_if(canvas.get_paint(29,39) != (0,0,0,255))
     fail_if(canvas.get_paint(30,40) != (255,255,255,255))
 
+    # Batched pixel writes
+    canvas.set_pixels([((1,1),(255,0,0)), ((2,1),(0,255,0,128))])
+    fail_if(canvas.get_pixel((1,1)) != (255,0,0,255))
+    fail_if(canvas.get_pixel((2,1)) != (0,255,0,128))
+    canvas.fill_spans([(0,2,5), (3,3,2)], (0,0,255))
+    fail_if(canvas.get_pixel((4,2)) != (0,0,255,255))
+    fail_if(canvas.get_pixel((4,3)) != (0,0,255,255))
+    canvas.blit_buffer((5,5,2,1), bytes([1,2,3, 4,5,6]))
+    fail_if(canvas.get_pixel((6,5)) != (4,5,6,255))
+    undo()
+    fail_if(canvas.get_pixel((6,5)) != (255,255,255,255))
+    undo()
+    undo()
+    fail_if(canvas.get_pixel((1,1)) != (255,255,255,255))
+    redo()
+    redo()
+    redo()
+    fail_if(canvas.get_pixel((6,5)) != (4,5,6,255))
+
     fail_if(canvas.get_zoom() != 1.0)
     e = canvas.Ellipse((10,20,30,40))
     fail_if(str(e) != 'Ellipse')
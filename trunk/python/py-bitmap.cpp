@@ -221,12 +221,12 @@ void Common_erase_but_color(Bitmap& bmp, const Color& keep,
 
 template<>
 void Common_flip_horizontally(Bitmap& bmp){
-  flip(bmp, along(Axis::HORIZONTAL));
+  flip_in_place(bmp, along(Axis::HORIZONTAL));
 }
 
 template<>
 void Common_flip_vertically(Bitmap& bmp){
-  flip(bmp, along(Axis::VERTICAL));
+  flip_in_place(bmp, along(Axis::VERTICAL));
 }
 
 template<>
@@ -239,7 +239,7 @@ void Common_fill(Bitmap& bmp, const IntPoint& pos, const Paint& paint){
 
 template<>
 void Common_gaussian_blur(Bitmap& bmp, coord sigma){
-  gaussian_blur_fast(bmp, sigma);
+  bmp = gaussian_blur_fast(bmp, sigma);
 }
 
 template<>
@@ -305,6 +305,33 @@ void Common_set_threshold(Bitmap& bmp, const threshold_range_t& range,
   threshold(bmp, range, in.Get(), out.Get());
 }
 
+template<>
+void Common_set_pixels(Bitmap& bmp, const std::vector<PixelValue>& pixels){
+  throw_if_outside(pixels, bmp.GetSize());
+  for (const PixelValue& px : pixels){
+    put_pixel(bmp, px.pos, px.color);
+  }
+}
+
+template<>
+void Common_fill_spans(Bitmap& bmp, const std::vector<PixelSpan>& spans,
+  const Color& color)
+{
+  throw_if_outside(spans, bmp.GetSize());
+  for (const PixelSpan& span : spans){
+    fill_rect_color(bmp, IntRect(span.pos, IntSize(span.length, 1)), color);
+  }
+}
+
+template<>
+void Common_blit_buffer(Bitmap& bmp, const IntRect& rect,
+  const std::string& data)
+{
+  throw_if_outside(rect, bmp.GetSize());
+  blit(offsat(bitmap_from_buffer(rect.GetSize(), data), rect.TopLeft()),
+    onto(bmp));
+}
+
 #define COMMONFWD(bundle)FORWARDER(bundle::Func<Bitmap&>, bundle::ArgType(), bundle::Name(), bundle::Doc())
 
 /* extra_include: "generated/python/method-def/py-common-methoddef.hh" */
@@ -764,13 +764,20 @@ static void canvas_scroll_max_right(Canvas& canvas){
   canvas.ScrollMaxRight();
 }
 
-/* method: "unsharp_mask(sigma)\n
-Sharpen the image using an unsharp mask." */
-static void canvas_unsharp_mask(Canvas& canvas, coord sigma){
+/* method: "unsharp_mask(sigma[,amount,threshold])\n
+Sharpen the image using an unsharp mask.\n
+The difference from the image blurred with sigma is scaled by amount.\n
+Channels differing less than threshold are not sharpened." */
+static void canvas_unsharp_mask(Canvas& canvas,
+  coord sigma,
+  const Optional<coord>& amount,
+  const Optional<int>& threshold)
+{
+  const unsharp_mask_t params(sigma, amount.Or(1.0), threshold.Or(0));
   python_run_command(canvas,
     target_full_image(get_function_command("Unsharp mask",
       [=](Bitmap& bmp){
-        bmp = unsharp_mask_fast(bmp, sigma);
+        bmp = unsharp_mask(bmp, params);
       })));
 }
 
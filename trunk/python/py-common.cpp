@@ -18,15 +18,75 @@
 #include "bitmap/bitmap.hh"
 #include "bitmap/draw.hh"
 #include "bitmap/filter.hh"
+#include "commands/put-pixel-cmd.hh"
+#include "geo/geo-func.hh"
 #include "geo/int-rect.hh"
 #include "python/py-function-error.hh"
 #include "text/formatting.hh"
 #include "util/color-span.hh"
 #include "util/either.hh"
+#include "util/iter.hh"
 #include "util-wx/clipboard.hh"
 
 namespace faint{
 
+void throw_if_outside(const std::vector<PixelValue>& pixels,
+  const IntSize& size)
+{
+  for (const auto& px : enumerate(pixels)){
+    const IntPoint& pos = px.item.pos;
+    if (pos.x < 0 || pos.y < 0 || pos.x >= size.w || pos.y >= size.h){
+      throw ValueError(space_sep("Pixel", str_int(px.num),
+        "outside image."));
+    }
+  }
+}
+
+void throw_if_outside(const std::vector<PixelSpan>& spans,
+  const IntSize& size)
+{
+  for (const auto& span : enumerate(spans)){
+    const IntPoint& pos = span.item.pos;
+    if (pos.x < 0 || pos.y < 0 || pos.y >= size.h ||
+      span.item.length > size.w - pos.x)
+    {
+      throw ValueError(space_sep("Span", str_int(span.num),
+        "outside image."));
+    }
+  }
+}
+
+void throw_if_outside(const IntRect& rect, const IntSize& size){
+  if (intersection(rect, rect_from_size(size)) != rect){
+    throw ValueError("Rectangle not fully inside image.");
+  }
+}
+
+Bitmap bitmap_from_buffer(const IntSize& size, const std::string& data){
+  const size_t numPixels = to_size_t(area(size));
+  const size_t bytesPerPixel =
+    data.size() == numPixels * 4 ? 4 :
+    data.size() == numPixels * 3 ? 3 :
+    0;
+
+  if (bytesPerPixel == 0){
+    throw ValueError(space_sep("Expected", str_int(resigned(numPixels * 3)),
+      "(rgb) or", str_int(resigned(numPixels * 4)), "(rgba) bytes, got",
+      str_int(resigned(data.size())) + "."));
+  }
+
+  Bitmap bmp(size);
+  const uchar* src = reinterpret_cast<const uchar*>(data.data());
+  for (int y = 0; y != size.h; y++){
+    for (int x = 0; x != size.w; x++){
+      const uchar a = bytesPerPixel == 4 ? src[3] : 255;
+      put_pixel_raw(bmp, x, y, Color(src[0], src[1], src[2], a));
+      src += bytesPerPixel;
+    }
+  }
+  return bmp;
+}
+
 void copy_rect_to_clipboard(const Bitmap& bmp, const IntRect& rect){
   Clipboard clipboard;
   if (!clipboard.Good()){
@@ -25,6 +25,7 @@
 #include "commands/draw-object-cmd.hh"
 #include "commands/flip-rotate-cmd.hh"
 #include "commands/function-cmd.hh"
+#include "commands/put-pixel-cmd.hh"
 #include "commands/rescale-cmd.hh"
 #include "commands/resize-cmd.hh"
 #include "geo/axis.hh"
@@ -109,6 +110,17 @@ int Common_color_count(T target){
     });
 }
 
+// Throw ValueError unless all pixels are inside an image with the
+// given size.
+void throw_if_outside(const std::vector<PixelValue>&, const IntSize&);
+void throw_if_outside(const std::vector<PixelSpan>&, const IntSize&);
+void throw_if_outside(const IntRect&, const IntSize&);
+
+// Creates a Bitmap from packed rgb or rgba bytes, decided by the
+// length of the data. Throws ValueError if the length matches
+// neither.
+Bitmap bitmap_from_buffer(const IntSize&, const std::string&);
+
 // Copies the specified rectangle from the Bitmap or Color-span to the clipboard
 // Throws exceptions derived from PythonError.
 void copy_rect_to_clipboard(const Either<Bitmap, ColorSpan>& , const IntRect&);
@@ -144,7 +156,7 @@ template<typename T>
 void Common_flip_horizontally(T target){
   python_run_command(target,
     target_full_image(get_function_command("Flip horizontally",
-      [=](Bitmap& bmp){bmp = flip(bmp, along(Axis::HORIZONTAL));})));
+      [=](Bitmap& bmp){flip_in_place(bmp, along(Axis::HORIZONTAL));})));
 }
 
 /* method: "flip_vertically()\n
@@ -153,7 +165,7 @@ template<typename T>
 void Common_flip_vertically(T target){
   python_run_command(target,
     target_full_image(get_function_command("Flip vertically",
-      [=](Bitmap& bmp){bmp = flip(bmp, along(Axis::VERTICAL));})));
+      [=](Bitmap& bmp){flip_in_place(bmp, along(Axis::VERTICAL));})));
 }
 
 /* method: "fill((x,y),paint)\n
@@ -326,6 +338,41 @@ void Common_set_alpha(T target, const color_value_t& alpha){
       alpha.GetValue()))));
 }
 
+/* method: "set_pixels([((x,y),(r,g,b[,a])),...])\n
+Sets the pixels at the positions to the specified colors.\n
+Much faster than calling set_pixel for each pixel, and undone in a
+single step." */
+template<typename T>
+void Common_set_pixels(T target, const std::vector<PixelValue>& pixels){
+  throw_if_outside(pixels, target.GetImage().GetSize());
+  python_run_command(target, put_pixels_command(pixels));
+}
+
+/* method: "fill_spans([(x,y,length),...],(r,g,b[,a]))\n
+Sets the pixels of the horizontal spans, each starting at x,y and
+extending length pixels to the right, to the specified color." */
+template<typename T>
+void Common_fill_spans(T target, const std::vector<PixelSpan>& spans,
+  const Color& color)
+{
+  throw_if_outside(spans, target.GetImage().GetSize());
+  python_run_command(target, fill_spans_command(spans, color));
+}
+
+/* method: "blit_buffer((x,y,w,h), data)\n
+Replaces the pixels in the rectangle with the packed rgb or rgba
+bytes in data (e.g. bytes, bytearray or memoryview), row by row. The
+pixels are not alpha blended." */
+template<typename T>
+void Common_blit_buffer(T target, const IntRect& rect,
+  const std::string& data)
+{
+  throw_if_outside(rect, target.GetImage().GetSize());
+  python_run_command(target,
+    put_bitmap_command(rect.TopLeft(), bitmap_from_buffer(rect.GetSize(),
+      data)));
+}
+
 /* method: "color_balance((r0,r1),(g0,g1),(b0,b1))\n
 Stretches the specified color intervals to [0,255]" */
 template<typename T>
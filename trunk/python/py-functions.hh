@@ -55,6 +55,7 @@
 #include "util/index-iter.hh"
 #include "util/make-vector.hh"
 #include "util/optional.hh"
+#include "util/parallel.hh"
 #include "util/settings.hh"
 #include "util-wx/clipboard.hh"
 #include "util-wx/encode-bitmap.hh"
@@ -228,6 +229,13 @@ static std::vector<Canvas*> list_images(){
     });
 }
 
+/* function: "get_concurrency()->n\n
+Returns the number of threads used for image processing."
+name: "get_concurrency" */
+static int py_get_concurrency(){
+  return get_concurrency();
+}
+
 /* function: "get_font()->font\nReturns the active font face name." */
 static StringSetting::ValueType get_font(){
   return get_app_context().Get(ts_FontFace);
@@ -250,12 +258,42 @@ static Settings get_settings(){
   return get_app_context().GetToolSettings();
 }
 
+// The number of tasks and the seconds spent running them
+using parallel_stats_t = std::pair<int, coord>;
+
+/* function: "get_parallel_stats()->(tasks, seconds)\n
+Returns the number of image processing tasks run on the thread pool,
+and the time spent running them summed over all threads."
+name: "get_parallel_stats" */
+static parallel_stats_t py_get_parallel_stats(){
+  const ParallelStats stats = get_parallel_stats();
+  return {static_cast<int>(stats.tasks), stats.taskSeconds};
+}
+
+/* function: "reset_parallel_stats()\n
+Resets the counters returned by get_parallel_stats."
+name: "reset_parallel_stats" */
+static void py_reset_parallel_stats(){
+  reset_parallel_stats();
+}
+
 /* function: "set_active_image(image)\n
 Activates (selects in a tab) the specified image." */
 static void set_active_image(Canvas* canvas){
   get_app_context().SetActiveCanvas(canvas->GetId());
 }
 
+/* function: "set_concurrency(n)\n
+Sets the number of threads used for image processing. 0 uses one
+thread per core."
+name: "set_concurrency" */
+static void py_set_concurrency(int n){
+  if (n < 0){
+    throw ValueError("The number of threads must not be negative");
+  }
+  set_concurrency(n);
+}
+
 /* function: "set_layer(layer)\n
 Select layer. 0=Raster, 1=Object" */
 static void set_layer(int layer){
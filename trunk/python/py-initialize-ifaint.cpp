@@ -185,12 +185,15 @@ static void run_envsetup(const FilePath& path){
   assert(err.NotSet());
 }
 
-bool init_python(const utf8_string& arg){
+static void init_ifaint_module(){
   PyImport_AppendInittab("ifaint", PyInit_ifaint);
   Py_Initialize();
-  DirPath dataDir = get_data_dir();
-  add_to_python_path(dataDir.SubDir("py"));
-  run_envsetup(dataDir.SubDir("py").SubDir("core").File("envsetup.py"));
+  add_to_python_path(get_data_dir().SubDir("py"));
+}
+
+bool init_python(const utf8_string& arg){
+  init_ifaint_module();
+  run_envsetup(get_data_dir().SubDir("py").SubDir("core").File("envsetup.py"));
 
   if (!arg.empty()){
     scoped_ref ifaint(PyImport_ImportModule("ifaint"));
@@ -201,6 +204,10 @@ bool init_python(const utf8_string& arg){
   return true;
 }
 
+void init_python_headless(){
+  init_ifaint_module();
+}
+
 void display_error_info(const FaintPyExc& info, PythonContext& python){
   python.IntFaintPrint(format_error_info(info));
 }
@@ -29,6 +29,11 @@ class PythonContext;
 // Returns true on success.
 bool init_python(const utf8_string& arg);
 
+// Initializes the ifaint module without the interpreter environment
+// (envsetup.py), so that output goes to stdout and stderr. For use
+// without the Faint GUI.
+void init_python_headless();
+
 Optional<FaintPyExc> run_python_file(const FilePath&);
 
 // Runs the user configuration. Returns true if loaded without error
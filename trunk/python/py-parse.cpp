@@ -19,6 +19,7 @@
 #include "bitmap/gradient.hh"
 #include "bitmap/paint.hh"
 #include "bitmap/pattern.hh"
+#include "commands/put-pixel-cmd.hh"
 #include "geo/arc.hh"
 #include "geo/calibration.hh"
 #include "geo/int-rect.hh"
@@ -61,6 +62,8 @@ const TypeName arg_traits<Index>::name("Index");
 const TypeName arg_traits<IntLineSegment>::name("Line");
 const TypeName arg_traits<LineSegment>::name("Line");
 const TypeName arg_traits<Paint>::name("Paint");
+const TypeName arg_traits<PixelSpan>::name("pixel span");
+const TypeName arg_traits<PixelValue>::name("pixel");
 const TypeName arg_traits<Settings>::name("Settings");
 const TypeName arg_traits<Tri>::name("Tri");
 const TypeName arg_traits<utf8_string>::name("str");
@@ -187,12 +190,16 @@ bool parse_coord(PyObject* args, int n, coord* value){
 }
 
 bool parse_bytes(PyObject* args, int, std::string* value){
-  char* str = PyBytes_AsString(args);
-  if (str == nullptr){
-    // PyBytes_AsString will have raised TypeError
+  // Accepts any object supporting the buffer protocol (e.g. bytes,
+  // bytearray, memoryview), and keeps embedded null-bytes.
+  Py_buffer view;
+  if (PyObject_GetBuffer(args, &view, PyBUF_SIMPLE) != 0){
+    // PyObject_GetBuffer will have raised TypeError
     return false;
   }
-  *value = std::string(str);
+  value->assign(static_cast<const char*>(view.buf),
+    static_cast<size_t>(view.len));
+  PyBuffer_Release(&view);
   return true;
 }
 
@@ -699,6 +706,38 @@ bool parse_flat(IntPoint& pt, PyObject* args, int& n, int len){
   return true;
 }
 
+bool parse_flat(PixelSpan& span, PyObject* args, int& n, int len){
+  throw_insufficient_args_if(len - n < 3, "pixel span");
+
+  int x, y, length;
+  if (!parse_int(args, n, &x) ||
+    !parse_int(args, n + 1, &y) ||
+    !parse_int(args, n + 2, &length)){
+    return false;
+  }
+  if (length < 0){
+    throw ValueError("Negative span length", n);
+  }
+  span.pos = IntPoint(x, y);
+  span.length = length;
+  n += 3;
+  return true;
+}
+
+bool parse_flat(PixelValue& px, PyObject* args, int& n, int len){
+  throw_insufficient_args_if(len - n < 2, "pixel");
+
+  IntPoint pos;
+  Color color;
+  if (!parse_item(pos, args, n, len, false) ||
+    !parse_item(color, args, n, len, false)){
+    return false;
+  }
+  px.pos = pos;
+  px.color = color;
+  return true;
+}
+
 bool parse_flat(ColorStop& stop, PyObject* args, int& n, int len){
   throw_insufficient_args_if(len - n < 2, "color stop");
 
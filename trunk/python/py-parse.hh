@@ -62,6 +62,8 @@ template<> struct type2type<Delay>{
 
 class ObjRaster;
 class ObjText;
+class PixelSpan;
+class PixelValue;
 
 template<typename T>
 struct arg_traits{};
@@ -79,6 +81,8 @@ template<> struct arg_traits<IntLineSegment>{static const TypeName name;};
 template<> struct arg_traits<LineSegment>{static const TypeName name;};
 template<> struct arg_traits<Object> {static const TypeName name;};
 template<> struct arg_traits<Paint>{static const TypeName name;};
+template<> struct arg_traits<PixelSpan>{static const TypeName name;};
+template<> struct arg_traits<PixelValue>{static const TypeName name;};
 template<> struct arg_traits<Settings>{static const TypeName name;};
 template<> struct arg_traits<Tri>{static const TypeName name;};
 template<> struct arg_traits<utf8_string>{static const TypeName name;};
@@ -157,6 +161,8 @@ bool parse_flat(IntSize&, PyObject*, int& n, int len);
 bool parse_flat(Color&, PyObject*, int& n, int len);
 bool parse_flat(ColorStop&, PyObject*, int& n, int len);
 bool parse_flat(Paint&, PyObject*, int& n, int len);
+bool parse_flat(PixelSpan&, PyObject*, int& n, int len);
+bool parse_flat(PixelValue&, PyObject*, int& n, int len);
 bool parse_flat(IntLineSegment&, PyObject*, int& n, int len);
 bool parse_flat(IntPoint&, PyObject*, int& n, int len);
 bool parse_flat(LineSegment&, PyObject*, int& n, int len);
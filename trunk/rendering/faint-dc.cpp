@@ -38,6 +38,7 @@
 #include "text/utf8-string.hh"
 #include "util/math-constants.hh"
 #include "util/optional.hh"
+#include "util/scratch-arena.hh"
 #include "util/setting-util.hh"
 #include "util/settings.hh"
 
@@ -316,15 +317,46 @@ void FaintDC::Blit(const Bitmap& bmp, const Point& topLeft,
   }
 }
 
+// The helpers below use the frame arena for their temporary bitmaps
+// while painting, so that repeated paints don't allocate from the
+// heap. Callers rewind the arena with a ScratchArenaRewind when done
+// with the temporary, so that the memory is reused by the next call
+// rather than kept for the rest of the paint.
+
+static Bitmap scratch_bitmap(const IntSize& size, const Color& bg){
+  ScratchArena* arena = frame_arena();
+  if (arena == nullptr){
+    return Bitmap(size, bg);
+  }
+  Bitmap bmp(size, *arena);
+  clear(bmp, bg);
+  return bmp;
+}
+
+static Bitmap scratch_scale_bilinear(const Bitmap& bmp, coord scale){
+  ScratchArena* arena = frame_arena();
+  return arena == nullptr ?
+    scale_bilinear(bmp, Scale(scale)) :
+    scale_bilinear(bmp, Scale(scale), *arena);
+}
+
+static Bitmap scratch_scale_nearest(const Bitmap& bmp, int scale){
+  ScratchArena* arena = frame_arena();
+  return arena == nullptr ?
+    scale_nearest(bmp, scale) :
+    scale_nearest(bmp, scale, *arena);
+}
+
 void FaintDC::BitmapBlendAlpha(const Bitmap& drawnBitmap,
   const IntPoint& topLeft)
 {
+  const ScratchArenaRewind rewind(frame_arena());
   if (m_sc < 1){
-    const Bitmap scaled(scale_bilinear(drawnBitmap, Scale(m_sc)));
+    const Bitmap scaled(scratch_scale_bilinear(drawnBitmap, m_sc));
     blend(offsat(scaled, topLeft), onto(m_bitmap));
   }
   else if (m_sc > 1){
-    const Bitmap scaled(scale_nearest(drawnBitmap, truncated(m_sc)));
+    const Bitmap scaled(scratch_scale_nearest(drawnBitmap, truncated(m_sc)));
     blend(offsat(scaled, topLeft), onto(m_bitmap));
   }
   else {
@@ -335,12 +367,13 @@ void FaintDC::BitmapBlendAlpha(const Bitmap& drawnBitmap,
 void FaintDC::BitmapBlendAlphaMasked(const Bitmap& drawnBitmap,
   const Color& maskColor, const IntPoint& topLeft)
 {
+  const ScratchArenaRewind rewind(frame_arena());
   if (m_sc < 1){
-    const Bitmap scaled(scale_bilinear(drawnBitmap, Scale(m_sc)));
+    const Bitmap scaled(scratch_scale_bilinear(drawnBitmap, m_sc));
     blend_masked(offsat(scaled, topLeft), onto(m_bitmap), maskColor);
   }
   else if (m_sc > 1){
-    const Bitmap scaled(scale_nearest(drawnBitmap, truncated(m_sc)));
+    const Bitmap scaled(scratch_scale_nearest(drawnBitmap, truncated(m_sc)));
     blend_masked(offsat(scaled, topLeft), onto(m_bitmap), maskColor);
   }
   else {
@@ -351,12 +384,13 @@ void FaintDC::BitmapBlendAlphaMasked(const Bitmap& drawnBitmap,
 void FaintDC::BitmapSetAlpha(const Bitmap& drawnBitmap,
   const IntPoint& topLeft)
 {
+  const ScratchArenaRewind rewind(frame_arena());
   if (m_sc < 1){
-    const Bitmap scaled(scale_bilinear(drawnBitmap, Scale(m_sc)));
+    const Bitmap scaled(scratch_scale_bilinear(drawnBitmap, m_sc));
     blit(offsat(scaled, topLeft), onto(m_bitmap));
   }
   else if (m_sc > 1){
-    const Bitmap scaled(scale_nearest(drawnBitmap, truncated(m_sc)));
+    const Bitmap scaled(scratch_scale_nearest(drawnBitmap, truncated(m_sc)));
     blit(offsat(scaled, topLeft), onto(m_bitmap));
   }
   else {
@@ -367,12 +401,13 @@ void FaintDC::BitmapSetAlpha(const Bitmap& drawnBitmap,
 void FaintDC::BitmapSetAlphaMasked(const Bitmap& drawnBitmap,
   const Color& maskColor, const IntPoint& topLeft)
 {
+  const ScratchArenaRewind rewind(frame_arena());
   if (m_sc < 1){
-    Bitmap scaled(scale_bilinear(drawnBitmap, Scale(m_sc)));
+    Bitmap scaled(scratch_scale_bilinear(drawnBitmap, m_sc));
     blit_masked(offsat(scaled, topLeft), onto(m_bitmap), maskColor);
   }
   else if (m_sc > 1){
-    Bitmap scaled(scale_nearest(drawnBitmap, truncated(m_sc)));
+    Bitmap scaled(scratch_scale_nearest(drawnBitmap, truncated(m_sc)));
     blit_masked(offsat(scaled, topLeft), onto(m_bitmap), maskColor);
   }
   else {
@@ -390,14 +425,21 @@ void FaintDC::Blend(const AlphaMap& alpha, const IntPoint& topLeft,
 
   Filter* f = get_filter(s);
   if (f != nullptr){
-    // Fixme: Need to offset the alpha-map and such.
-    Padding p(f->GetPadding());
-    Bitmap bmp(alpha.GetSize() + p.GetSize(), color_transparent_white);
-    IntPoint offset(p.left, p.top);
-    blend(offsat(alpha.FullReference(), imagePt), onto(bmp),
-      get_fg(s, m_origin, anchor));
-    f->Apply(bmp);
-    blend(offsat(bmp, imagePt - offset), onto(m_bitmap));
+    // Filter only the region with non-zero alpha, padded for the
+    // filter, rather than the full alpha map.
+    alpha.FullReference().BoundingRect().Visit(
+      [&](const IntRect& bounds){
+        const ScratchArenaRewind rewind(frame_arena());
+        Padding p(f->GetPadding());
+        Bitmap bmp(scratch_bitmap(bounds.GetSize() + p.GetSize(),
+          color_transparent_white));
+        IntPoint offset(p.left, p.top);
+        blend(offsat(alpha.SubReference(bounds), offset), onto(bmp),
+          get_fg(s, m_origin, anchor));
+        f->Apply(bmp);
+        blend(offsat(bmp, imagePt + bounds.TopLeft() - offset),
+          onto(m_bitmap));
+      });
     delete f;
   }
   else{
@@ -442,8 +484,10 @@ void FaintDC::DrawRasterEllipse(const Tri& tri, const Filter& f,
   IntRect r(floored(tri.P0() * m_sc + m_origin),
     floored(tri.P3() * m_sc + m_origin));
 
+  const ScratchArenaRewind rewind(frame_arena());
   Padding p(f.GetPadding());
-  Bitmap bmp(r.GetSize() + p.GetSize(), color_transparent_white);
+  Bitmap bmp(scratch_bitmap(r.GetSize() + p.GetSize(),
+    color_transparent_white));
   IntPoint offset(p.left, p.top);
   IntRect r2(offset, r.GetSize());
   if (filled(s)){
@@ -534,8 +578,10 @@ void FaintDC::DrawRasterRect(const Tri& tri, const Filter& f,
   IntRect r(floored(tri.P0() * m_sc + m_origin),
     floored(tri.P3() * m_sc + m_origin));
 
+  const ScratchArenaRewind rewind(frame_arena());
   Padding p(f.GetPadding());
-  Bitmap bmp(r.GetSize() + p.GetSize(), color_transparent_white);
+  Bitmap bmp(scratch_bitmap(r.GetSize() + p.GetSize(),
+    color_transparent_white));
   IntPoint offset(p.left, p.top);
   IntRect r2(offset, r.GetSize());
 
@@ -589,9 +635,10 @@ void FaintDC::Line(const LineSegment& line, const Filter& f, const Settings& s){
   // Fixme: Raster only (filter variant)
   IntSize extraSize(40,40);
   // Fixme: use bounding-rect function for line.
-  Bitmap bmp(truncated(Size(std::fabs(line.p1.x - line.p0.x),
+  const ScratchArenaRewind rewind(frame_arena());
+  Bitmap bmp(scratch_bitmap(truncated(Size(std::fabs(line.p1.x - line.p0.x),
     std::fabs(line.p1.y - line.p0.y))) + extraSize,
-    color_transparent_white);
+    color_transparent_white));
   IntPoint origin = floored(min_coords(line.p0, line.p1));
   IntPoint offset(10,10);
   draw_line(bmp, {floored(line.p0) - origin + offset,
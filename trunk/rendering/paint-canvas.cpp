@@ -45,6 +45,7 @@
 #include "util/mouse.hh"
 #include "util/object-util.hh"
 #include "util/pos-info.hh"
+#include "util/scratch-arena.hh"
 #include "util-wx/convert-wx.hh"
 #include "rendering/extra-overlay.hh"
 
@@ -201,7 +202,8 @@ struct PaintInfo{
 static void from_bitmap(PaintInfo& info,
   const Bitmap& bmp,
   const IntRect& viewRect,
-  const CanvasGeo& geo)
+  const CanvasGeo& geo,
+  ScratchArena& arena)
 {
   info.bmpSize = bmp.GetSize();
   info.imageRegion = get_image_region(viewRect, info.bmpSize, geo);
@@ -209,19 +211,24 @@ static void from_bitmap(PaintInfo& info,
   if (empty(info.imageRegion)){
     return;
   }
-  info.subBitmap = subbitmap(bmp, info.imageRegion);
+  info.subBitmap = subbitmap(bmp, info.imageRegion, arena);
 }
 
 static void from_color(PaintInfo& info,
   const Color& color,
   const IntSize& size,
   const IntRect rView,
-  const CanvasGeo& geo)
+  const CanvasGeo& geo,
+  ScratchArena& arena)
 {
   info.bmpSize = size;
   info.imageRegion = get_image_region(rView, size, geo);
   info.imageCoordRect = view_to_image(rView, geo);
-  info.subBitmap = Bitmap(info.imageRegion.GetSize(), color);
+  if (empty(info.imageRegion)){
+    return;
+  }
+  info.subBitmap = Bitmap(info.imageRegion.GetSize(), arena);
+  clear(info.subBitmap, color);
 }
 
 static void set_origin(wxDC& dc, const IntPoint& p){
@@ -309,22 +316,29 @@ void paint_canvas(wxDC& paintDC,
   int objectHandleWidth,
   Drawable&& eo)
 {
+  // Temporary bitmaps for this paint are taken from the frame arena,
+  // which is reset when the scope ends, so the arena must outlive
+  // them.
+  FrameArenaScope frame;
+  ScratchArena& arena = frame.Arena();
+
   PaintInfo info;
   if (auto bitmapMirage = weakBitmapMirage.lock()){
     // Use the bitmap mirage as the raster background (this is for
     // feedback from some operation in a dialog, e.g.
     // brightness/contrast).
-    from_bitmap(info, *bitmapMirage, updateRegion, state.geo);
+    from_bitmap(info, *bitmapMirage, updateRegion, state.geo, arena);
   }
   else{
     active.GetBackground().Visit(
       [&](const Bitmap& bg){
         // Use the image background bitmap.
-        from_bitmap(info, bg, updateRegion, state.geo);
+        from_bitmap(info, bg, updateRegion, state.geo, arena);
       },
       [&](const ColorSpan& bg){
         // No raster background - create on the fly.
-        from_color(info, bg.color, bg.size, updateRegion, state.geo);
+        from_color(info, bg.color, bg.size, updateRegion, state.geo,
+          arena);
       });
   }
 
@@ -362,10 +376,12 @@ void paint_canvas(wxDC& paintDC,
 
   // Create a scaled bitmap for object graphics and overlays
   const coord zoom = state.geo.zoom.GetScaleFactor();
+  // At 100% the sub-bitmap is not needed after this, so it is used
+  // as is.
   Bitmap scaled = state.geo.zoom.At100() ?
-    info.subBitmap : (zoom > 1.0 ?
-      scale_nearest(info.subBitmap, rounded(zoom)):
-      scale_bilinear(info.subBitmap, Scale(zoom)));
+    std::move(info.subBitmap) : (zoom > 1.0 ?
+      scale_nearest(info.subBitmap, rounded(zoom), arena):
+      scale_bilinear(info.subBitmap, Scale(zoom), arena));
 
   if (!bitmap_ok(scaled)){
     return paint_without_image(paintDC, updateRegion, state.geo,
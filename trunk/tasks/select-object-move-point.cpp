@@ -156,10 +156,8 @@ public:
     }
     else if (snapHeld){
       // Snap to objects and corners formed by the points
-      objects_t objects = info.canvas.GetObjects();
-      remove(m_object, from(objects));
-      p = snap(p, objects, info.canvas.GetGrid(),
-        get_corners(m_object, m_pointIndex));
+      p = snap(p, info.canvas.GetImage(), as_list(m_object),
+        info.canvas.GetGrid(), get_corners(m_object, m_pointIndex));
     }
 
     m_object->SetPoint(p, m_pointIndex);
@@ -128,7 +128,7 @@ public:
     m_refreshRect = translated(m_refreshRect, delta);
 
     if (info.modifiers.Primary()){
-      Point snapOffset = SnapObject(info.canvas.GetObjects(),
+      Point snapOffset = SnapObject(info.canvas.GetImage(),
         info.canvas.GetGrid());
       offset_by(m_objects, snapOffset);
       m_refreshRect = translated(m_refreshRect, snapOffset);
@@ -154,15 +154,14 @@ private:
     return TaskResult::COMMIT_AND_CHANGE;
   }
 
-  Point SnapObject(objects_t snappable, const Grid& grid){
+  Point SnapObject(const Image& image, const Grid& grid){
     std::vector<Point> points = m_mainObject->GetSnappingPoints();
     if (points.empty()){
       return Point(0,0);
     }
     // Do not snap to any of the moved objects
-    remove(m_objects, from(snappable));
     Point p_first(points.front());
-    Point p_adj = snap(p_first, snappable, grid);
+    Point p_adj = snap(p_first, image, m_objects, grid);
     Point delta = p_adj - p_first;
     return delta;
   }
@@ -160,20 +160,20 @@ public:
     // this makes growing something at width 0 impossible.
     Point p = info.pos;
     if (info.modifiers.Primary()){
-      objects_t objects = info.canvas.GetObjects();
-      remove(m_object, from(objects));
+      const Image& image = info.canvas.GetImage();
+      const objects_t ignored(as_list(m_object));
       if (m_lockY){
         Rect oldRect(bounding_rect(m_oldTri));
-        p.x = snap_x(p.x, objects, info.canvas.GetGrid(), oldRect.Top(),
-          oldRect.Bottom());
+        p.x = snap_x(p.x, image, ignored, info.canvas.GetGrid(),
+          oldRect.Top(), oldRect.Bottom());
       }
       else if (m_lockX){
         Rect oldRect(bounding_rect(m_oldTri));
-        p.y = snap_y(p.y, objects, info.canvas.GetGrid(), oldRect.Left(),
-          oldRect.Right());
+        p.y = snap_y(p.y, image, ignored, info.canvas.GetGrid(),
+          oldRect.Left(), oldRect.Right());
       }
       else {
-        p = snap(p, objects, info.canvas.GetGrid());
+        p = snap(p, image, ignored, info.canvas.GetGrid());
       }
     }
 
@@ -226,9 +226,8 @@ public:
   TaskResult MouseMove(const PosInfo& info) override{
     Point p = info.pos;
     if (info.modifiers.Primary()){
-      objects_t objects = info.canvas.GetObjects();
-      remove(m_object, from(objects));
-      p = snap(p, objects, info.canvas.GetGrid());
+      p = snap(p, info.canvas.GetImage(), as_list(m_object),
+        info.canvas.GetGrid());
     }
     else if (info.modifiers.Secondary()){
       if (m_handle == Handle::P0 || m_handle == Handle::P3){
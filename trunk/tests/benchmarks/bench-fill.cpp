@@ -0,0 +1,48 @@
+// -*- coding: us-ascii-unix -*-
+#include "test-sys/bench.hh"
+#include "bitmap/bitmap.hh"
+#include "bitmap/color.hh"
+#include "bitmap/draw.hh"
+#include "geo/int-rect.hh"
+#include "geo/int-size.hh"
+
+const int REPS = 10;
+
+static void reference_clear(faint::Bitmap& bmp, const faint::Color& c){
+  // The previous per-channel clear, for comparison
+  using namespace faint;
+  uchar* data = bmp.m_data;
+  for (int y = 0; y != bmp.m_h; y++){
+    for (int x = 0; x != bmp.m_w; x++){
+      int dst = y * bmp.m_row_stride + x * BPP;
+      data[dst + iR] = c.r;
+      data[dst + iG] = c.g;
+      data[dst + iB] = c.b;
+      data[dst + iA] = c.a;
+    }
+  }
+}
+
+void bench_fill(){
+  using namespace faint;
+  const IntSize size(3000, 2000);
+  Bitmap bmp(size);
+  const Color color(200, 120, 40, 255);
+  const IntRect rect(IntPoint(100, 50), IntSize(2500, 1800));
+
+  timed("reference_clear(3000x2000)", REPS,
+    [&](){reference_clear(bmp, color);});
+  timed("clear(3000x2000)", REPS, [&](){clear(bmp, color);});
+  timed("clear(3000x2000, white)", REPS, [&](){clear(bmp, color_white);});
+  timed("fill_rect_color(2500x1800)", REPS,
+    [&](){fill_rect_color(bmp, rect, color);});
+  timed("fill_rect(2500x1800, Paint)", REPS,
+    [&](){fill_rect(bmp, rect, Paint(color));});
+  timed("horizontal+vertical_scanline(x1000)", REPS,
+    [&](){
+      for (int i = 0; i != 1000; i++){
+        horizontal_scanline(bmp, i, color);
+        vertical_scanline(bmp, i, color);
+      }
+    });
+}
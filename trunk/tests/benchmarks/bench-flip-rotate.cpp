@@ -0,0 +1,70 @@
+// -*- coding: us-ascii-unix -*-
+#include "test-sys/bench.hh"
+#include "bitmap/bitmap.hh"
+#include "bitmap/color.hh"
+#include "bitmap/draw.hh"
+#include "geo/axis.hh"
+#include "geo/int-size.hh"
+
+const int REPS = 10;
+
+static faint::Bitmap reference_rotate_90cw(const faint::Bitmap& src){
+  // The previous, non-blocked, rotation for comparison
+  using namespace faint;
+  Bitmap dst(transposed(src.GetSize()));
+  uchar* pDst = dst.m_data;
+  uchar* pSrc = src.m_data;
+  for (int y = 0; y != src.m_h; y++){
+    for (int x = 0 ; x != src.m_w; x++){
+      int iSrc = y * src.m_row_stride + x * BPP;
+      int iDst = x * dst.m_row_stride + (dst.m_w - y - 1) * BPP;
+      pDst[ iDst + iR ] = pSrc[iSrc + iR ];
+      pDst[ iDst + iG ] = pSrc[iSrc + iG ];
+      pDst[ iDst + iB ] = pSrc[iSrc + iB ];
+      pDst[ iDst + iA ] = pSrc[iSrc + iA ];
+    }
+  }
+  return dst;
+}
+
+static faint::Bitmap reference_flip_horizontal(const faint::Bitmap& src){
+  // The previous horizontal flip for comparison
+  using namespace faint;
+  Bitmap dst(src);
+  uchar* pDst = dst.m_data;
+  uchar* pSrc = src.m_data;
+  for (int y = 0; y != src.m_h; y++){
+    for (int x = 0 ; x != src.m_w; x++){
+      int iSrc = y * src.m_row_stride + x * BPP;
+      int iDst = y * dst.m_row_stride + (dst.m_w - 1) * BPP - x * BPP;
+      pDst[ iDst + iR ] = pSrc[iSrc + iR ];
+      pDst[ iDst + iG ] = pSrc[iSrc + iG ];
+      pDst[ iDst + iB ] = pSrc[iSrc + iB ];
+      pDst[ iDst + iA ] = pSrc[iSrc + iA ];
+    }
+  }
+  return dst;
+}
+
+void bench_flip_rotate(){
+  using namespace faint;
+  Bitmap bmp(IntSize(3000, 2000), color_white);
+
+  timed("reference_rotate_90cw(3000x2000)", REPS,
+    [&](){reference_rotate_90cw(bmp);});
+  timed("rotate_90cw(3000x2000)", REPS, [&](){rotate_90cw(bmp);});
+  timed("rotate_90ccw(3000x2000)", REPS, [&](){rotate_90ccw(bmp);});
+  timed("rotate_180(3000x2000)", REPS, [&](){rotate_180(bmp);});
+  timed("transposed(3000x2000)", REPS, [&](){transposed(bmp);});
+
+  timed("reference_flip_horizontal(3000x2000)", REPS,
+    [&](){reference_flip_horizontal(bmp);});
+  timed("flip(3000x2000, horizontal)", REPS,
+    [&](){flip(bmp, along(Axis::HORIZONTAL));});
+  timed("flip(3000x2000, vertical)", REPS,
+    [&](){flip(bmp, along(Axis::VERTICAL));});
+  timed("flip_in_place(3000x2000, horizontal)", REPS,
+    [&](){flip_in_place(bmp, along(Axis::HORIZONTAL));});
+  timed("flip_in_place(3000x2000, vertical)", REPS,
+    [&](){flip_in_place(bmp, along(Axis::VERTICAL));});
+}
@@ -0,0 +1,104 @@
+// -*- coding: us-ascii-unix -*-
+#include "test-sys/bench.hh"
+#include "bitmap/bitmap.hh"
+#include "bitmap/color.hh"
+#include "bitmap/draw.hh"
+#include "bitmap/filter.hh"
+#include "geo/int-size.hh"
+#include "geo/offsat.hh"
+
+const int REPS = 10;
+
+static void reference_blend(const faint::Bitmap& src, faint::Bitmap& dst){
+  // The previous per-pixel blend with float alpha, for comparison
+  using namespace faint;
+  const uchar* srcData = src.m_data;
+  uchar* dstData = dst.m_data;
+  for (int y = 0; y != src.m_h; y++){
+    for (int x = 0; x != src.m_w; x++){
+      int srcPos = y * src.m_row_stride + x * BPP;
+      int dstPos = y * dst.m_row_stride + x * BPP;
+      float alpha = srcData[srcPos + iA];
+      dstData[dstPos + iR] = static_cast<uchar>((srcData[srcPos + iR] * alpha +
+        dstData[dstPos + iR] * (255 - alpha)) / 255);
+      dstData[dstPos + iG] = static_cast<uchar>((srcData[srcPos + iG] * alpha +
+        dstData[dstPos + iG] * (255 - alpha)) / 255);
+      dstData[dstPos + iB] = static_cast<uchar>((srcData[srcPos + iB] * alpha +
+        dstData[dstPos + iB] * (255 - alpha)) / 255);
+      dstData[dstPos + iA] =
+        std::max(srcData[srcPos + iA], dstData[dstPos + iA]);
+    }
+  }
+}
+
+static void reference_invert(faint::Bitmap& bmp){
+  // The previous per-channel invert, for comparison
+  using namespace faint;
+  for (int y = 0; y != bmp.m_h; y++){
+    uchar* data = bmp.m_data + y * bmp.m_row_stride;
+    for (int x = 0; x != bmp.m_w * BPP; x += BPP){
+      uchar* pos = data + x;
+      *(pos + iR) = static_cast<uchar>(255 - *(pos + iR));
+      *(pos + iG) = static_cast<uchar>(255 - *(pos + iG));
+      *(pos + iB) = static_cast<uchar>(255 - *(pos + iB));
+    }
+  }
+}
+
+static void reference_desaturate_weighted(faint::Bitmap& bmp){
+  // The previous desaturate, indexing each pixel from the origin
+  using namespace faint;
+  uchar* data = bmp.m_data;
+  for (int y = 0; y != bmp.m_h; y++){
+    for (int x = 0; x != bmp.m_w; x++){
+      int dst = y * bmp.m_row_stride + x * BPP;
+      uchar gray = static_cast<uchar>(0.3 * data[dst + iR] +
+          0.59 * data[dst + iG] +
+          0.11 * data[dst + iB]);
+      data[dst + iR] = gray;
+      data[dst + iG] = gray;
+      data[dst + iB] = gray;
+    }
+  }
+}
+
+static void reference_sepia(faint::Bitmap& bmp, int intensity){
+  // The previous sepia, via Color per pixel
+  using namespace faint;
+  const int depth = 20;
+  for (int y = 0; y != bmp.m_h; y++){
+    for (int x = 0; x != bmp.m_w; x++){
+      Color c = get_color_raw(bmp, x, y);
+      const int gray = (c.r + c.g + c.b) / 3;
+      const int r = std::min(gray + depth * 2, 255);
+      const int g = std::min(gray + depth, 255);
+      const int b = std::max(gray - intensity, 0);
+      put_pixel_raw(bmp, x, y, color_from_ints(r,g,b, c.a));
+    }
+  }
+}
+
+void bench_pixel_view(){
+  using namespace faint;
+  const IntSize size(3000, 2000);
+  Bitmap bmp(size, Color(200, 120, 40, 255));
+  const Bitmap overlay(size, Color(10, 90, 250, 128));
+
+  timed("reference_blend(3000x2000)", REPS,
+    [&](){reference_blend(overlay, bmp);});
+  timed("blend(3000x2000)", REPS,
+    [&](){blend(at_top_left(overlay), onto(bmp));});
+
+  timed("reference_invert(3000x2000)", REPS,
+    [&](){reference_invert(bmp);});
+  timed("invert(3000x2000)", REPS, [&](){invert(bmp);});
+
+  timed("reference_desaturate_weighted(3000x2000)", REPS,
+    [&](){reference_desaturate_weighted(bmp);});
+  timed("desaturate_weighted(3000x2000)", REPS,
+    [&](){desaturate_weighted(bmp);});
+
+  timed("reference_sepia(3000x2000)", REPS,
+    [&](){reference_sepia(bmp, 20);});
+  timed("sepia(3000x2000)", REPS, [&](){sepia(bmp, 20);});
+}
@@ -0,0 +1,39 @@
+// -*- coding: us-ascii-unix -*-
+#include "test-sys/bench.hh"
+#include "tests/test-util/file-handling.hh"
+#include "bitmap/alpha-map.hh"
+#include "bitmap/bitmap.hh"
+#include "bitmap/draw.hh"
+#include "bitmap/quantize.hh"
+#include "geo/scale.hh"
+
+const int REPS = 10;
+
+static void timed_quantized(const char* title, const faint::Bitmap& bmp,
+  faint::Dithering dithering)
+{
+  using namespace faint;
+  timed(title, REPS, [&](){quantized(bmp, dithering);});
+}
+
+void bench_quantize(){
+  using namespace faint;
+  const Bitmap gauss = load_test_image(FileName("gauss-source.png"));
+  timed_quantized("quantized(gauss-source, dithering off)", gauss,
+    Dithering::OFF);
+  timed_quantized("quantized(gauss-source, dithering on)", gauss,
+    Dithering::ON);
+
+  const Bitmap gradients = load_test_image(FileName("gradients.png"));
+  timed_quantized("quantized(gradients, dithering off)", gradients,
+    Dithering::OFF);
+  timed_quantized("quantized(gradients, dithering on)", gradients,
+    Dithering::ON);
+
+  // Large enough to be split over several threads
+  const Bitmap large = scale_bilinear(gauss, Scale(5.0));
+  timed_quantized("quantized(gauss-source x5, dithering off)", large,
+    Dithering::OFF);
+  timed_quantized("quantized(gauss-source x5, dithering on)", large,
+    Dithering::ON);
+}
@@ -87,4 +87,31 @@ void test_alpha_map(){
   copy.Set(0,0,103);
   EQUAL(copy.Get(0,0), 103);
   NOT_EQUAL(map.Get(0,0), 103);
+
+  {
+    // Only tiles with values set are allocated
+    AlphaMap large(IntSize(20000,20000));
+    EQUAL(large.NumTiles(), 0);
+    large.Set(10000, 10000, 0);
+    large.Add(15000, 3, 0);
+    EQUAL(large.NumTiles(), 0);
+    large.Set(10000, 10000, 1);
+    large.SetSpan(19990, 500, 20, 7);
+    EQUAL(large.NumTiles(), 2);
+    EQUAL(large.Get(10000, 10000), 1);
+    EQUAL(large.Get(19999, 500), 7);
+    EQUAL(large.Get(19989, 500), 0);
+    EQUAL(large.FullReference().BoundingRect().Get(),
+      IntRect(IntPoint(10000, 500), IntPoint(19999, 10000)));
+
+    // Copies only copy the allocated tiles
+    AlphaMap sub(large.SubCopy(IntRect(IntPoint(9000, 9000),
+      IntSize(2000, 2000))));
+    EQUAL(sub.NumTiles(), 1);
+    EQUAL(sub.Get(1000, 1000), 1);
+
+    large.Reset(IntSize(20000,20000));
+    EQUAL(large.NumTiles(), 0);
+    EQUAL(large.Get(10000, 10000), 0);
+  }
 }
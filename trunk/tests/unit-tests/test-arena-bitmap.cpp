@@ -0,0 +1,71 @@
+// -*- coding: us-ascii-unix -*-
+#include <utility>
+#include "test-sys/test.hh"
+#include "tests/test-util/print-objects.hh"
+#include "bitmap/bitmap.hh"
+#include "bitmap/color.hh"
+#include "bitmap/draw.hh"
+#include "geo/int-rect.hh"
+#include "geo/scale.hh"
+#include "util/scratch-arena.hh"
+
+void test_arena_bitmap(){
+  using namespace faint;
+
+  Bitmap src(IntSize(20, 15), color_white);
+  for (int y = 0; y != src.m_h; y++){
+    for (int x = 0; x != src.m_w; x++){
+      put_pixel_raw(src, x, y, color_from_ints(x * 10, y * 15,
+        (x + y) * 5, 200));
+    }
+  }
+
+  ScratchArena arena;
+  {
+    Bitmap bmp(IntSize(10, 5), arena);
+    EQUAL(bmp.GetSize(), IntSize(10, 5));
+    VERIFY(arena.Used() >= static_cast<size_t>(bmp.m_row_stride * 5));
+    clear(bmp, color_magenta);
+
+    // Copies use the heap
+    Bitmap copy(bmp);
+    VERIFY(copy.m_data != bmp.m_data);
+    VERIFY(copy == bmp);
+
+    // Moving keeps the arena memory
+    uchar* data = bmp.m_data;
+    Bitmap moved(std::move(bmp));
+    VERIFY(moved.m_data == data);
+
+    // Assigning a heap bitmap to an arena bitmap
+    moved = src;
+    VERIFY(moved == src);
+  }
+
+  {
+    // The arena variants give the same results as the heap variants
+    const IntRect r(IntPoint(3, 2), IntSize(12, 9));
+    VERIFY(subbitmap(src, r, arena) == subbitmap(src, r));
+    VERIFY(scale_nearest(src, 3, arena) == scale_nearest(src, 3));
+    VERIFY(scale_bilinear(src, Scale(0.5), arena) ==
+      scale_bilinear(src, Scale(0.5)));
+    VERIFY(scale_bilinear(src, Scale(-0.5, 0.7), arena) ==
+      scale_bilinear(src, Scale(-0.5, 0.7)));
+    VERIFY(scale_bilinear(src, Scale(1.0), arena) == src);
+  }
+
+  {
+    // Repeated frames with the same temporaries reuse the frame
+    // arena without allocating
+    auto paint = [&](){
+      FrameArenaScope frame;
+      Bitmap sub(subbitmap(src, IntRect(IntPoint(0, 0), IntSize(10, 10)),
+        frame.Arena()));
+      Bitmap scaled(scale_nearest(sub, 4, frame.Arena()));
+      return frame.Arena().HeapAllocations();
+    };
+    const size_t heapAllocations = paint();
+    EQUAL(paint(), heapAllocations);
+    EQUAL(paint(), heapAllocations);
+  }
+}
@@ -9,6 +9,7 @@
 #include "geo/int-rect.hh"
 #include "geo/int-size.hh"
 #include "util/at-most.hh"
+#include "util/optional.hh"
 
 using namespace faint;
 
@@ -129,4 +130,35 @@ void test_auto_crop(){
     FAIL_UNLESS_CALLED_FWD(EqualRects2(
       IntRect(IntPoint(0,2),IntSize(10,8)),
       IntRect(IntPoint(0,0),IntSize(10,8)))));
+
+  // Content not aligned to the scanned blocks, in a wider image
+  Bitmap wide(IntSize(53, 12), color_white);
+  put_pixel(wide, IntPoint(11, 3), color_black);
+  put_pixel(wide, IntPoint(41, 9), color_magenta);
+  get_auto_crop_rectangles(wide).Visit(
+    FAIL_IF_CALLED(),
+    FAIL_UNLESS_CALLED_FWD(EqualRects1(
+      IntRect(IntPoint(11,3), IntSize(31,7)))),
+    FAIL_IF_CALLED());
+
+  // Color extents
+  EQUAL(find_color_extents(wide, color_black).Get(),
+    IntRect(IntPoint(11,3), IntSize(1,1)));
+  EQUAL(find_color_extents(wide, color_white).Get(),
+    IntRect(IntPoint(0,0), IntSize(53,12)));
+  VERIFY(find_color_extents(wide, color_red).NotSet());
+  put_pixel(wide, IntPoint(2, 7), color_black);
+  put_pixel(wide, IntPoint(19, 5), color_black);
+  EQUAL(find_color_extents(wide, color_black).Get(),
+    IntRect(IntPoint(2,3), IntSize(18,5)));
+
+  // Edge colors
+  EQUAL(get_edge_color(wide, IntRect(IntPoint(0,0), IntSize(53,3))).Get(),
+    color_white);
+  VERIFY(get_edge_color(wide, IntRect(IntPoint(0,0), IntSize(53,4))).
+    NotSet());
+  VERIFY(get_edge_color(wide, IntRect(IntPoint(11,0), IntSize(20,12))).
+    NotSet());
+  VERIFY(get_edge_color(wide, IntRect(IntPoint(10,0), IntSize(50,12))).
+    NotSet());
 }
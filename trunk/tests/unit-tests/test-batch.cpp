@@ -0,0 +1,97 @@
+// -*- coding: us-ascii-unix -*-
+#include "test-sys/test.hh"
+#include "tests/test-util/file-handling.hh"
+#include "tests/test-util/print-objects.hh"
+#include "batch/batch-python.hh"
+#include "batch/batch.hh"
+#include "bitmap/bitmap.hh"
+#include "bitmap/color.hh"
+#include "bitmap/draw.hh"
+#include "formats/bmp/file-bmp.hh"
+#include "geo/int-rect.hh"
+#include "util-wx/stream.hh"
+
+void test_batch(){
+  using namespace faint;
+
+  const FilePath a(get_test_save_path(FileName("a.bmp")));
+  const FilePath b(get_test_save_path(FileName("b.bmp")));
+  VERIFY(write_bmp(a, Bitmap(IntSize(5, 3), color_red),
+    BitmapQuality::COLOR_24BIT).Successful());
+  VERIFY(write_bmp(b, Bitmap(IntSize(4, 2), color_blue),
+    BitmapQuality::COLOR_24BIT).Successful());
+
+  const DirPath outDir(a.StripFileName().SubDir("batch-out"));
+  if (!exists(outDir)){
+    make_dir(outDir);
+  }
+
+  BatchOptions options(outDir, 2);
+  options.extension.Set(FileExtension("bmp"));
+
+  {
+    // Test "batch_output_path"
+    EQUAL(batch_output_path(a, options).Str(),
+      outDir.File(utf8_string("a.bmp")).Str());
+
+    const FilePath png(a.StripFileName().File(utf8_string("a.png")));
+    EQUAL(batch_output_path(png, options).Str(),
+      outDir.File(utf8_string("a.bmp")).Str());
+  }
+
+  {
+    // Files which would be saved to the same path as an earlier file
+    // are not processed
+    FileList files;
+    files.push_back(a);
+    files.push_back(a.StripFileName().File(utf8_string("a.png")));
+    files.push_back(b);
+    files.push_back(a);
+
+    const auto results = run_batch(files, options,
+      [](const Bitmap& bmp) -> OrError<Bitmap>{
+        return bmp;
+      });
+
+    ASSERT_EQUAL(results.size(), 4);
+    VERIFY(results[0].error.NotSet());
+    VERIFY(results[1].error.IsSet());
+    VERIFY(results[2].error.NotSet());
+    VERIFY(results[3].error.IsSet());
+    EQUAL(results[3].file, a.Str());
+  }
+
+  {
+    // Bitmap methods called from the script modify the saved bitmap
+    Bitmap edge(IntSize(20, 10), color_white);
+    fill_rect(edge, IntRect(IntPoint(0, 0), IntSize(10, 10)),
+      Paint(color_black));
+    const FilePath c(get_test_save_path(FileName("c.bmp")));
+    VERIFY(write_bmp(c, edge, BitmapQuality::COLOR_24BIT).Successful());
+
+    const FilePath script(get_test_save_path(FileName("blur.py")));
+    {
+      const std::string text("def process(bmp):\n"
+        "    bmp.gaussian_blur(2.0)\n");
+      BinaryWriter out(script);
+      out.write(text.c_str(), static_cast<std::streamsize>(text.size()));
+    }
+    const auto process = load_batch_script(script);
+    ASSERT(process.Get<batch_process_t>().IsSet());
+
+    FileList files;
+    files.push_back(c);
+    const auto results = run_batch(files, options,
+      process.Expect<batch_process_t>());
+    ASSERT_EQUAL(results.size(), 1);
+    VERIFY(results[0].error.NotSet());
+
+    const auto blurred = read_bmp(batch_output_path(c, options));
+    ASSERT(blurred.Get<Bitmap>().IsSet());
+    const Bitmap& result(blurred.Expect<Bitmap>());
+    EQUAL(result.GetSize(), edge.GetSize());
+    const Color nearEdge(get_color(result, IntPoint(9, 5)));
+    VERIFY(nearEdge != color_black);
+    VERIFY(nearEdge != color_white);
+  }
+}
@@ -0,0 +1,53 @@
+// -*- coding: us-ascii-unix -*-
+#include <memory>
+#include "test-sys/test.hh"
+#include "tests/test-util/print-objects.hh"
+#include "bitmap/alpha-map.hh"
+#include "bitmap/bitmap.hh"
+#include "bitmap/color.hh"
+#include "bitmap/paint.hh"
+#include "commands/brush-stroke-cmd.hh"
+#include "commands/command.hh"
+#include "commands/raster-delta.hh"
+#include "geo/int-point.hh"
+#include "geo/int-rect.hh"
+#include "rendering/faint-dc.hh"
+#include "util/setting-id.hh"
+#include "util/settings.hh"
+
+void test_brush_stroke_cmd(){
+  using namespace faint;
+
+  // Undoing a stroke with a drop-shadow via the delta for the raster
+  // bounds must remove the shadow as well.
+  Settings s;
+  s.Set(ts_Fg, Paint(color_blue));
+  s.Set(ts_Filter, 5);
+
+  AlphaMap alpha(IntSize(20, 10));
+  for (int y = 0; y != 10; y++){
+    alpha.SetSpan(0, y, 20, 255);
+  }
+  const IntPoint topLeft(5, 4);
+  const std::unique_ptr<Command> cmd(brush_stroke_command(UpperLeft(topLeft),
+    alpha, UpperLeft(topLeft), s));
+
+  Bitmap bmp(IntSize(60, 50), color_white);
+  const Bitmap original(bmp);
+  const Optional<IntRect> bounds(cmd->RasterBounds());
+  ASSERT(bounds.IsSet());
+  const RasterDelta delta(bmp, bounds.Get());
+
+  // As done by the command
+  FaintDC dc(bmp);
+  dc.Blend(alpha, topLeft, topLeft, s);
+  VERIFY(bmp != original);
+
+  // The shadow is drawn outside the alpha map
+  const IntPoint inShadow(28, 20);
+  VERIFY(!IntRect(topLeft, alpha.GetSize()).Contains(inShadow));
+  VERIFY(get_color(bmp, inShadow) != color_white);
+
+  delta.Restore(bmp);
+  VERIFY(bmp == original);
+}
@@ -5,6 +5,41 @@
 #include "bitmap/brush.hh"
 #include "geo/int-point.hh"
 
+static void stamp_along(faint::AlphaMap& map, const faint::AlphaMap& line,
+  const faint::Brush& b)
+{
+  // Adds the brush at every position set in line
+  using namespace faint;
+  const IntSize sz(map.GetSize());
+  const IntSize brushSz(b.GetSize());
+  for (int y = 0; y != sz.h; y++){
+    for (int x = 0; x != sz.w; x++){
+      if (line.Get(x, y) == 0){
+        continue;
+      }
+      for (int yB = 0; yB != brushSz.h; yB++){
+        for (int xB = 0; xB != brushSz.w; xB++){
+          if (x + xB < sz.w && y + yB < sz.h){
+            map.Add(x + xB, y + yB, b.Get(xB, yB));
+          }
+        }
+      }
+    }
+  }
+}
+
+static bool equal(const faint::AlphaMap& a, const faint::AlphaMap& b){
+  using namespace faint;
+  for (int y = 0; y != a.GetSize().h; y++){
+    for (int x = 0; x != a.GetSize().w; x++){
+      if (a.Get(x, y) != b.Get(x, y)){
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 void test_brush_stroke(){
   using namespace faint;
   const auto valueMap = alphamap_value_map({{'.', 0u}, {'X', 255u}});
@@ -44,4 +79,36 @@ void test_brush_stroke(){
       "..........",
       valueMap);
   }
+
+  {
+    // Strokes give the same result as adding the brush at each
+    // position of the line
+    const Brush pixel(create_brush({1,1}, "X", valueMap));
+    const Brush translucent(create_brush({3,2},
+      "XaX"
+      ".a.",
+      {{'.', 0u}, {'a', 100u}, {'X', 255u}}));
+    for (const Brush& b : {circle_brush(2), circle_brush(5), circle_brush(9),
+      rect_brush(4), experimental_brush(6), translucent})
+    {
+      for (const auto& ends : {std::make_pair(IntPoint(3,4), IntPoint(40,9)),
+        std::make_pair(IntPoint(30,2), IntPoint(28,35)),
+        std::make_pair(IntPoint(35,30), IntPoint(2,1)),
+        std::make_pair(IntPoint(20,20), IntPoint(20,20)),
+        std::make_pair(IntPoint(40,3), IntPoint(44,30))})
+      {
+        const UpperLeft p0(ends.first);
+        const UpperLeft p1(ends.second);
+        AlphaMap line(IntSize(45,38));
+        stroke(line, p0, p1, pixel);
+
+        AlphaMap expected(IntSize(45,38));
+        stamp_along(expected, line, b);
+
+        AlphaMap map(IntSize(45,38));
+        stroke(map, p0, p1, b);
+        VERIFY(equal(map, expected));
+      }
+    }
+  }
 }
@@ -0,0 +1,71 @@
+// -*- coding: us-ascii-unix -*-
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include "test-sys/test.hh"
+#include "util/coalescing-worker.hh"
+
+void test_coalescing_worker(){
+  using namespace faint;
+  using is_cancelled_t = CoalescingWorker::is_cancelled_t;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool started = false;
+  bool sawCancel = false;
+  std::vector<int> ran;
+  {
+    CoalescingWorker worker;
+    EQUAL(worker.Generation(), 0);
+
+    // The first job blocks until it is superseded.
+    const unsigned int first = worker.Post(
+      [&](const is_cancelled_t& cancelled){
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          started = true;
+        }
+        cv.notify_all();
+        while (!cancelled()){
+          std::this_thread::yield();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        sawCancel = true;
+        ran.push_back(1);
+      });
+    EQUAL(first, 1);
+
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&](){return started;});
+    }
+
+    // Posted while the first job runs (it can not finish while the
+    // lock is held): only the last is run.
+    std::atomic<int> done(0);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (int i = 2; i != 5; i++){
+        worker.Post([&, i](const is_cancelled_t&){
+          std::lock_guard<std::mutex> lock(mutex);
+          ran.push_back(i);
+          done = 1;
+        });
+      }
+    }
+    EQUAL(worker.Generation(), 4);
+    while (done == 0){
+      std::this_thread::yield();
+    }
+
+    // Cancelled before it could run
+    worker.Cancel();
+    EQUAL(worker.Generation(), 5);
+  }
+
+  VERIFY(sawCancel);
+  VERIFY(ran.size() == 2);
+  VERIFY(ran.front() == 1);
+  VERIFY(ran.back() == 4);
+}
@@ -1,8 +1,11 @@
 // -*- coding: us-ascii-unix -*-
+#include <algorithm>
 #include "test-sys/test.hh"
+#include "tests/test-util/print-objects.hh"
 #include "bitmap/bitmap.hh"
 #include "bitmap/color.hh"
 #include "bitmap/color-counting.hh"
+#include "bitmap/draw.hh"
 #include "geo/int-point.hh"
 #include "geo/int-size.hh"
 
@@ -60,4 +63,45 @@ void test_color_counting(){
     EQUAL(colorCounts.at(Color(255,0,0,100)), 1);
     EQUAL(colorCounts.at(Color(255,0,0,200)), 1);
   }
+
+  {
+    // Most common color, ties go to the lesser color
+    color_counts_t colorCounts;
+    colorCounts.insert(color_blue, 2);
+    colorCounts.insert(color_red, 3);
+    colorCounts.insert(color_green, 3);
+    EQUAL(most_common(colorCounts), std::min(color_red, color_green));
+
+    color_counts_t other;
+    other.insert(color_blue, 2);
+    colorCounts.merge(other);
+    EQUAL(colorCounts.size(), 3);
+    EQUAL(most_common(colorCounts), color_blue);
+  }
+
+  {
+    // A bitmap large enough to be counted in bands on several threads,
+    // with many more colors than the initial table size.
+    Bitmap bmp(IntSize(1000, 600), color_white);
+    for (int y = 0; y != 600; y++){
+      for (int x = 0; x < 1000; x += 2){
+        put_pixel(bmp, {x, y},
+          Color(static_cast<uchar>(x % 256), static_cast<uchar>(y % 100),
+            static_cast<uchar>(x / 256), 255));
+      }
+    }
+    const int numColors = 500 * 100 + 1; // Including the white
+    EQUAL(count_colors(bmp), numColors);
+    EQUAL(resigned(get_palette(bmp).size()), numColors);
+
+    const ColorHistogram all(color_histogram(bmp, numColors));
+    EQUAL(all.size(), numColors);
+    EQUAL(all.at(color_white), 1000 * 600 / 2);
+    EQUAL(all.at(Color(10, 10, 0, 255)), 6);
+
+    // Counting stops soon after exceeding the limit
+    const ColorHistogram limited(color_histogram(bmp, 256));
+    VERIFY(limited.size() > 256);
+    VERIFY(limited.size() < numColors);
+  }
 }
@@ -0,0 +1,73 @@
+// -*- coding: us-ascii-unix -*-
+#include "test-sys/test.hh"
+#include "tests/test-util/print-objects.hh"
+#include "bitmap/bitmap.hh"
+#include "bitmap/color.hh"
+#include "bitmap/compressed-bitmap.hh"
+#include "bitmap/draw.hh"
+#include "commands/raster-delta.hh"
+#include "geo/int-rect.hh"
+
+void test_compressed_bitmap(){
+  using namespace faint;
+
+  // Solid regions, noise and short runs
+  Bitmap bmp(IntSize(50, 20), color_white);
+  fill_rect_color(bmp, IntRect(IntPoint(5, 2), IntSize(20, 10)), color_red);
+  for (int y = 0; y != 20; y++){
+    for (int x = 30; x != 50; x++){
+      put_pixel(bmp, IntPoint(x, y),
+        Color(static_cast<uint8_t>(x * 7 + y),
+          static_cast<uint8_t>(x * y),
+          static_cast<uint8_t>(y * 13), 255));
+    }
+  }
+  put_pixel(bmp, IntPoint(1, 1), color_black);
+  put_pixel(bmp, IntPoint(2, 1), color_black);
+
+  {
+    // Test "Decompress"
+    const CompressedBitmap compressed(bmp);
+    EQUAL(compressed.GetSize(), bmp.GetSize());
+    VERIFY(compressed.Decompress() == bmp);
+  }
+
+  {
+    // A single color compresses well
+    const Bitmap solid(IntSize(200, 100), color_blue);
+    const CompressedBitmap compressed(solid);
+    VERIFY(compressed.GetByteCount() < 200 * 100);
+    VERIFY(compressed.Decompress() == solid);
+
+    // Empty bitmap
+    EQUAL(CompressedBitmap(Bitmap()).GetSize(), IntSize(0, 0));
+  }
+
+  {
+    // Test "DecompressOnto"
+    const IntRect r(IntPoint(3, 4), IntSize(30, 12));
+    const CompressedBitmap compressed(subbitmap(bmp, r));
+    Bitmap dst(bmp.GetSize(), color_magenta);
+    compressed.DecompressOnto(dst, r.TopLeft());
+    VERIFY(subbitmap(dst, r) == subbitmap(bmp, r));
+    EQUAL(get_color(dst, IntPoint(2, 4)), color_magenta);
+    EQUAL(get_color(dst, IntPoint(33, 4)), color_magenta);
+  }
+
+  {
+    // Test "RasterDelta"
+    const Bitmap original(bmp);
+    const RasterDelta delta(bmp, IntRect(IntPoint(40, 10), IntSize(20, 20)));
+    fill_rect_color(bmp, IntRect(IntPoint(40, 10), IntSize(10, 10)),
+      color_green);
+    VERIFY(bmp != original);
+    delta.Restore(bmp);
+    VERIFY(bmp == original);
+
+    // Clipped to nothing
+    const RasterDelta outside(bmp, IntRect(IntPoint(60, 0), IntSize(5, 5)));
+    EQUAL(outside.GetByteCount(), 0);
+    outside.Restore(bmp);
+    VERIFY(bmp == original);
+  }
+}
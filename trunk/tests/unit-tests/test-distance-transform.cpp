@@ -0,0 +1,73 @@
+// -*- coding: us-ascii-unix -*-
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "test-sys/test.hh"
+#include "tests/test-util/print-objects.hh"
+#include "bitmap/bitmap.hh"
+#include "bitmap/color.hh"
+#include "bitmap/distance-transform.hh"
+#include "bitmap/draw.hh"
+#include "bitmap/filter.hh"
+#include "geo/int-point.hh"
+#include "geo/int-rect.hh"
+
+void test_distance_transform(){
+  using namespace faint;
+
+  {
+    // Without any opaque pixels, all distances are infinite
+    const auto d = squared_distance_to_opaque(
+      Bitmap(IntSize(5, 4), color_transparent_white));
+    EQUAL(d.size(), 20);
+    VERIFY(std::all_of(begin(d), end(d), [](float v){
+      return v == std::numeric_limits<float>::infinity();
+    }));
+  }
+
+  {
+    // Compare with the brute force distance to a few opaque pixels
+    Bitmap bmp(IntSize(23, 17), color_transparent_white);
+    const std::vector<IntPoint> opaque = {
+      {3, 2}, {4, 2}, {20, 15}, {11, 8}, {0, 16}};
+    for (const auto& pt : opaque){
+      put_pixel_raw(bmp, pt.x, pt.y, color_black);
+    }
+
+    const auto d = squared_distance_to_opaque(bmp);
+    for (int y = 0; y != bmp.m_h; y++){
+      for (int x = 0; x != bmp.m_w; x++){
+        int expected = std::numeric_limits<int>::max();
+        for (const auto& pt : opaque){
+          const int dx = x - pt.x;
+          const int dy = y - pt.y;
+          expected = std::min(expected, dx * dx + dy * dy);
+        }
+        EQUAL(d[to_size_t(y * bmp.m_w + x)], static_cast<float>(expected));
+      }
+    }
+  }
+
+  {
+    // Test "with_stroke"
+    Bitmap bmp(IntSize(20, 20), color_transparent_white);
+    put_pixel_raw(bmp, 10, 10, color_white);
+    const Bitmap stroked(with_stroke(bmp, 3.0, color_black));
+    EQUAL(get_color_raw(stroked, 10, 10), color_white);
+    EQUAL(get_color_raw(stroked, 13, 10), color_black);
+    EQUAL(get_color_raw(stroked, 10, 7), color_black);
+    EQUAL(get_color_raw(stroked, 14, 10).a, 0);
+    EQUAL(get_color_raw(stroked, 13, 13).a, 0);
+  }
+
+  {
+    // Test "with_shadow"
+    Bitmap bmp(IntSize(30, 30), color_transparent_white);
+    fill_rect_color(bmp, IntRect(IntPoint(2, 2), IntSize(10, 10)),
+      color_white);
+    const Bitmap shadowed(with_shadow(bmp, 8, 1.0, Color(0, 0, 0, 200)));
+    EQUAL(get_color_raw(shadowed, 5, 5), color_white);
+    EQUAL(get_color_raw(shadowed, 15, 15), Color(0, 0, 0, 200));
+    EQUAL(get_color_raw(shadowed, 27, 27).a, 0);
+  }
+}
@@ -0,0 +1,54 @@
+// -*- coding: us-ascii-unix -*-
+#include <memory>
+#include "test-sys/test.hh"
+#include "tests/test-util/print-objects.hh"
+#include "bitmap/bitmap.hh"
+#include "bitmap/color.hh"
+#include "bitmap/paint.hh"
+#include "commands/command.hh"
+#include "commands/draw-object-cmd.hh"
+#include "commands/raster-delta.hh"
+#include "geo/int-rect.hh"
+#include "geo/tri.hh"
+#include "objects/object.hh"
+#include "objects/objrectangle.hh"
+#include "rendering/faint-dc.hh"
+#include "util/default-settings.hh"
+#include "util/frame-props.hh"
+#include "util/image.hh"
+#include "util/setting-id.hh"
+
+void test_draw_object_cmd(){
+  using namespace faint;
+
+  // Undoing a drop-shadowed object via the delta for the raster
+  // bounds must remove the shadow as well.
+  Settings s(default_rectangle_settings());
+  s.Set(ts_AntiAlias, false);
+  s.Set(ts_FillStyle, FillStyle::FILL);
+  s.Set(ts_Bg, Paint(color_blue));
+  s.Set(ts_Filter, 5);
+  Object* obj = create_rectangle_object(
+    Tri(Point(5, 4), Point(25, 4), Point(5, 14)), s);
+  const std::unique_ptr<Command> cmd(draw_object_command(its_yours(obj)));
+
+  Bitmap bmp(IntSize(60, 50), color_white);
+  const Bitmap original(bmp);
+  Image image((FrameProps(original)));
+
+  const Optional<IntRect> bounds(cmd->RasterBounds());
+  ASSERT(bounds.IsSet());
+  const RasterDelta delta(bmp, bounds.Get());
+
+  FaintDC dc(bmp);
+  obj->Draw(dc, image.GetExpressionContext());
+  VERIFY(bmp != original);
+
+  // The shadow is drawn outside the refresh rectangle
+  const IntPoint inShadow(28, 20);
+  VERIFY(!obj->GetRefreshRect().Contains(inShadow));
+  VERIFY(get_color(bmp, inShadow) != color_white);
+
+  delta.Restore(bmp);
+  VERIFY(bmp == original);
+}
@@ -0,0 +1,77 @@
+// -*- coding: us-ascii-unix -*-
+#include "test-sys/test.hh"
+#include "tests/test-util/print-objects.hh"
+#include "bitmap/bitmap.hh"
+#include "bitmap/color.hh"
+#include "bitmap/draw.hh"
+#include "bitmap/paint.hh"
+#include "geo/int-rect.hh"
+
+static int count_color(const faint::Bitmap& bmp, const faint::Color& c){
+  int n = 0;
+  for (int y = 0; y != bmp.m_h; y++){
+    for (int x = 0; x != bmp.m_w; x++){
+      if (faint::get_color_raw(bmp, x, y) == c){
+        n++;
+      }
+    }
+  }
+  return n;
+}
+
+void test_fill(){
+  using namespace faint;
+  const Color c1(10, 20, 30, 40);
+  const Color c2(7, 7, 7, 7);
+
+  // A stride with padding, which must be left untouched
+  Bitmap bmp(IntSize(13, 7), 15 * BPP);
+  clear(bmp, c1);
+  EQUAL(count_color(bmp, c1), 13 * 7);
+  for (int y = 0; y != bmp.m_h; y++){
+    for (int i = 13 * BPP; i != 15 * BPP; i++){
+      EQUAL(bmp.m_data[y * bmp.m_row_stride + i], 0);
+    }
+  }
+
+  // Filling with equal channels
+  clear(bmp, c2);
+  EQUAL(count_color(bmp, c2), 13 * 7);
+
+  {
+    // Rectangles are clipped to the bitmap
+    Bitmap bmp2(IntSize(10, 8), c1);
+    fill_rect_color(bmp2, IntRect(IntPoint(-2, 5), IntSize(5, 10)), c2);
+    EQUAL(count_color(bmp2, c2), 3 * 3);
+    EQUAL(get_color(bmp2, IntPoint(2, 7)), c2);
+    EQUAL(get_color(bmp2, IntPoint(3, 7)), c1);
+    EQUAL(get_color(bmp2, IntPoint(2, 4)), c1);
+
+    fill_rect_color(bmp2, IntRect(IntPoint(10, 0), IntSize(5, 5)), c2);
+    EQUAL(count_color(bmp2, c2), 3 * 3);
+
+    fill_rect_rgb(bmp2, IntRect(IntPoint(1, 1), IntSize(2, 2)),
+      ColRGB(1, 2, 3));
+    EQUAL(count_color(bmp2, Color(1, 2, 3, 255)), 4);
+
+    fill_rect(bmp2, IntRect(IntPoint(0, 0), IntSize(10, 8)), Paint(c1));
+    EQUAL(count_color(bmp2, c1), 10 * 8);
+  }
+
+  {
+    // Scanlines span the bitmap, and are ignored outside it
+    Bitmap bmp2(IntSize(10, 8), c1);
+    horizontal_scanline(bmp2, 3, c2);
+    EQUAL(count_color(bmp2, c2), 10);
+    vertical_scanline(bmp2, 9, c2);
+    EQUAL(count_color(bmp2, c2), 10 + 7);
+    EQUAL(get_color(bmp2, IntPoint(9, 0)), c2);
+    EQUAL(get_color(bmp2, IntPoint(9, 7)), c2);
+
+    horizontal_scanline(bmp2, 8, c2);
+    horizontal_scanline(bmp2, -1, c2);
+    vertical_scanline(bmp2, 10, c2);
+    vertical_scanline(bmp2, -1, c2);
+    EQUAL(count_color(bmp2, c2), 10 + 7);
+  }
+}
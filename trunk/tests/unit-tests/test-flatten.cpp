@@ -0,0 +1,93 @@
+// -*- coding: us-ascii-unix -*-
+#include "test-sys/test.hh"
+#include "tests/test-util/print-objects.hh"
+#include "bitmap/bitmap.hh"
+#include "bitmap/color.hh"
+#include "bitmap/draw.hh"
+#include "geo/int-rect.hh"
+#include "geo/offsat.hh"
+#include "geo/tri.hh"
+#include "objects/objellipse.hh"
+#include "objects/objrectangle.hh"
+#include "util/default-settings.hh"
+#include "util/frame-props.hh"
+#include "util/image-util.hh"
+#include "util/image.hh"
+
+void test_flatten(){
+  using namespace faint;
+
+  // Objects crossing the band boundaries, and one within a single
+  // band.
+  const objects_t objects = {
+    create_rectangle_object(Tri(Point(2, 3), Point(30, 3), Point(2, 25)),
+      default_rectangle_settings()),
+    create_ellipse_object(Tri(Point(10, 5), Point(38, 5), Point(10, 28)),
+      default_ellipse_settings()),
+    create_rectangle_object(Tri(Point(20, 15), Point(25, 15), Point(20, 17)),
+      default_rectangle_settings())};
+
+  Image image(FrameProps(Bitmap(IntSize(40, 30), color_white), objects));
+  const Bitmap full(flatten(image));
+  EQUAL(full.GetSize(), IntSize(40, 30));
+
+  {
+    // Test "flatten" for a region
+    const IntRect region(IntPoint(5, 6), IntSize(20, 10));
+    VERIFY(flatten(image, region) == subbitmap(full, region));
+
+    // Clipped to the image
+    const IntRect outside(IntPoint(30, 20), IntSize(20, 20));
+    VERIFY(flatten(image, outside) ==
+      subbitmap(full, IntRect(IntPoint(30, 20), IntSize(10, 10))));
+  }
+
+  {
+    // Test "flatten_bands", top down
+    Bitmap joined(IntSize(40, 30), color_magenta);
+    std::vector<int> tops;
+    flatten_bands(image, 7, BandOrder::TOP_DOWN,
+      [&](const Bitmap& band, int y){
+        EQUAL(band.m_w, 40);
+        tops.push_back(y);
+        blit(offsat(band, 0, y), onto(joined));
+      });
+    VERIFY(tops == std::vector<int>({0, 7, 14, 21, 28}));
+    VERIFY(joined == full);
+  }
+
+  {
+    // Test "flatten_bands", bottom up
+    Bitmap joined(IntSize(40, 30), color_magenta);
+    std::vector<int> tops;
+    flatten_bands(image, 10, BandOrder::BOTTOM_UP,
+      [&](const Bitmap& band, int y){
+        EQUAL(band.m_h, 10);
+        tops.push_back(y);
+        blit(offsat(band, 0, y), onto(joined));
+      });
+    VERIFY(tops == std::vector<int>({20, 10, 0}));
+    VERIFY(joined == full);
+  }
+
+  {
+    // A shadow reaching into bands which the object itself does not
+    // overlap
+    Settings s(default_rectangle_settings());
+    s.Set(ts_AntiAlias, false);
+    s.Set(ts_FillStyle, FillStyle::FILL);
+    s.Set(ts_Filter, 5);
+    Image shadowed(FrameProps(Bitmap(IntSize(40, 40), color_white),
+      {create_rectangle_object(Tri(Point(4, 2), Point(20, 2), Point(4, 8)),
+        s)}));
+    const Bitmap shadowedFull(flatten(shadowed));
+
+    Bitmap joined(IntSize(40, 40), color_magenta);
+    flatten_bands(shadowed, 10, BandOrder::TOP_DOWN,
+      [&](const Bitmap& band, int y){
+        blit(offsat(band, 0, y), onto(joined));
+      });
+    VERIFY(joined == shadowedFull);
+    VERIFY(get_color(shadowedFull, IntPoint(18, 15)) != color_white);
+  }
+}
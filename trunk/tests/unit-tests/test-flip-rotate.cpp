@@ -0,0 +1,70 @@
+// -*- coding: us-ascii-unix -*-
+#include "test-sys/test.hh"
+#include "tests/test-util/print-objects.hh"
+#include "bitmap/bitmap.hh"
+#include "bitmap/color.hh"
+#include "bitmap/draw.hh"
+#include "geo/axis.hh"
+#include "geo/int-size.hh"
+
+static faint::Color color_at(int x, int y){
+  return faint::Color(faint::uchar(x * 7), faint::uchar(y * 11),
+    faint::uchar(x + y), faint::uchar(255 - x));
+}
+
+void test_flip_rotate(){
+  using namespace faint;
+
+  // Sizes smaller than, equal to and not a multiple of the block size
+  for (const IntSize& size : {IntSize(1, 1), IntSize(3, 2), IntSize(16, 16),
+    IntSize(37, 23)})
+  {
+    const int w = size.w;
+    const int h = size.h;
+    Bitmap src(size);
+    for (int y = 0; y != h; y++){
+      for (int x = 0; x != w; x++){
+        put_pixel_raw(src, x, y, color_at(x, y));
+      }
+    }
+
+    const Bitmap cw = rotate_90cw(src);
+    const Bitmap ccw = rotate_90ccw(src);
+    const Bitmap half = rotate_180(src);
+    const Bitmap t = transposed(src);
+    ASSERT_EQUAL(cw.GetSize(), IntSize(h, w));
+    ASSERT_EQUAL(ccw.GetSize(), IntSize(h, w));
+    ASSERT_EQUAL(half.GetSize(), size);
+    ASSERT_EQUAL(t.GetSize(), IntSize(h, w));
+
+    const Bitmap horizontal = flip(src, along(Axis::HORIZONTAL));
+    const Bitmap vertical = flip(src, along(Axis::VERTICAL));
+    VERIFY(flip(src, across(Axis::VERTICAL)) == horizontal);
+    VERIFY(flip(src, across(Axis::HORIZONTAL)) == vertical);
+
+    for (int y = 0; y != h; y++){
+      for (int x = 0; x != w; x++){
+        const Color c = color_at(x, y);
+        EQUAL(get_color_raw(cw, h - 1 - y, x), c);
+        EQUAL(get_color_raw(ccw, y, w - 1 - x), c);
+        EQUAL(get_color_raw(half, w - 1 - x, h - 1 - y), c);
+        EQUAL(get_color_raw(t, y, x), c);
+        EQUAL(get_color_raw(horizontal, w - 1 - x, y), c);
+        EQUAL(get_color_raw(vertical, x, h - 1 - y), c);
+      }
+    }
+
+    Bitmap inPlace(src);
+    flip_in_place(inPlace, along(Axis::HORIZONTAL));
+    VERIFY(inPlace == horizontal);
+    flip_in_place(inPlace, along(Axis::VERTICAL));
+    VERIFY(inPlace == half);
+    flip_in_place(inPlace, across(Axis::VERTICAL));
+    VERIFY(inPlace == vertical);
+    flip_in_place(inPlace, across(Axis::HORIZONTAL));
+    VERIFY(inPlace == src);
+
+    VERIFY(rotate_90ccw(cw) == src);
+    VERIFY(rotate_90cw(cw) == half);
+  }
+}
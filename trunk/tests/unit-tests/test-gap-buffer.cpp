@@ -0,0 +1,73 @@
+// -*- coding: us-ascii-unix -*-
+#include "test-sys/test.hh"
+#include "tests/test-util/print-objects.hh"
+#include "text/char-constants.hh"
+#include "text/gap-buffer.hh"
+
+void test_gap_buffer(){
+  using namespace faint;
+
+  {
+    // Edits on both sides of the gap
+    GapBuffer b(utf8_string("ab\ncd\nef"));
+    EQUAL(b.size(), 8);
+    EQUAL(b.str(), "ab\ncd\nef");
+
+    b.insert(1, utf8_char("X"));
+    EQUAL(b.str(), "aXb\ncd\nef");
+    b.insert(9, utf8_string("\ngh"));
+    EQUAL(b.str(), "aXb\ncd\nef\ngh");
+    b.erase(1, 1);
+    EQUAL(b.str(), "ab\ncd\nef\ngh");
+    b.insert(0, snowman);
+    EQUAL(b.at(0), snowman);
+    EQUAL(b.at(1), utf8_char("a"));
+    EQUAL(b.substr(1, 4), "ab\nc");
+    b.erase(0, 1);
+    EQUAL(b.str(), "ab\ncd\nef\ngh");
+  }
+
+  {
+    // Indexed eol-search
+    GapBuffer b(utf8_string("ab\ncd\nef\ngh"));
+    b.insert(4, utf8_char("X")); // Gap between the eols
+    EQUAL(b.str(), "ab\ncXd\nef\ngh");
+
+    EQUAL(b.find(eol, 0), 2);
+    EQUAL(b.find(eol, 2), 2);
+    EQUAL(b.find(eol, 3), 6);
+    EQUAL(b.find(eol, 7), 9);
+    EQUAL(b.find(eol, 10), GapBuffer::npos);
+
+    EQUAL(b.rfind(eol, 12), 9);
+    EQUAL(b.rfind(eol, 9), 9);
+    EQUAL(b.rfind(eol, 8), 6);
+    EQUAL(b.rfind(eol, 5), 2);
+    EQUAL(b.rfind(eol, 1), GapBuffer::npos);
+    EQUAL(b.rfind(eol, GapBuffer::npos), 9);
+
+    // Erase eols spanning the gap
+    b.erase(2, 5);
+    EQUAL(b.str(), "abef\ngh");
+    EQUAL(b.find(eol, 0), 4);
+    EQUAL(b.rfind(eol, 3), GapBuffer::npos);
+    b.erase(4, 1);
+    EQUAL(b.find(eol, 0), GapBuffer::npos);
+    EQUAL(b.rfind(eol, GapBuffer::npos), GapBuffer::npos);
+  }
+
+  {
+    // Growing past the initial gap
+    GapBuffer b;
+    utf8_string expected;
+    for (int i = 0; i != 500; i++){
+      b.insert(b.size(), i % 10 == 0 ? eol : utf8_char("x"));
+      expected += (i % 10 == 0 ? eol : utf8_char("x"));
+    }
+    EQUAL(b.str(), expected);
+    EQUAL(b.find(eol, 1), 10);
+    EQUAL(b.rfind(eol, 499), 490);
+    EQUAL(b.find(utf8_char("x"), 490), 491);
+    EQUAL(b.rfind(utf8_char("x"), 490), 489);
+  }
+}
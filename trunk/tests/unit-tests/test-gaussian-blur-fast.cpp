@@ -0,0 +1,48 @@
+// -*- coding: us-ascii-unix -*-
+#include "test-sys/test.hh"
+#include "tests/test-util/print-objects.hh"
+#include "bitmap/bitmap.hh"
+#include "bitmap/channel.hh"
+#include "bitmap/color.hh"
+#include "bitmap/draw.hh"
+#include "bitmap/gaussian-blur.hh"
+#include "util/scratch-arena.hh"
+
+void test_gaussian_blur_fast(){
+  using namespace faint;
+
+  Bitmap bmp(IntSize(200, 150), color_white);
+  for (int y = 40; y != 110; y++){
+    for (int x = 50; x != 150; x++){
+      put_pixel_raw(bmp, x, y, color_from_ints(x, y, 0, 255));
+    }
+  }
+  const Bitmap expected(gaussian_blur_fast(bmp, 4.0));
+  const IntSize size(40, 30);
+  channel_t expectedChannel(to_size_t(area(size)), 0);
+  expectedChannel[to_size_t(15 * size.w + 20)] = 255;
+  channel_t channel(expectedChannel);
+  gaussian_blur_fast(expectedChannel, size, 3.0);
+
+  {
+    // While painting, the blurs use the frame arena and rewind it
+    // when done, so repeated blurs reuse its memory.
+    FrameArenaScope frame;
+    ScratchArena& arena = frame.Arena();
+    arena.Allocate(10);
+    const size_t used = arena.Used();
+
+    VERIFY(gaussian_blur_fast(bmp, 4.0) == expected);
+    EQUAL(arena.Used(), used);
+    VERIFY(arena.Peak() > used);
+    const size_t heapAllocations = arena.HeapAllocations();
+    const size_t capacity = arena.Capacity();
+
+    VERIFY(gaussian_blur_fast(bmp, 4.0) == expected);
+    gaussian_blur_fast(channel, size, 3.0);
+    VERIFY(channel == expectedChannel);
+    EQUAL(arena.Used(), used);
+    EQUAL(arena.HeapAllocations(), heapAllocations);
+    EQUAL(arena.Capacity(), capacity);
+  }
+}
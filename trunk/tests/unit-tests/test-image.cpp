@@ -0,0 +1,98 @@
+// -*- coding: us-ascii-unix -*-
+#include <memory>
+#include "test-sys/test.hh"
+#include "geo/tri.hh"
+#include "objects/objcomposite.hh"
+#include "objects/object.hh"
+#include "objects/objrectangle.hh"
+#include "util/default-settings.hh"
+#include "util/image.hh"
+
+void test_image(){
+  using namespace faint;
+
+  auto rectangle = [](const char* name){
+    Object* obj = create_rectangle_object(Tri(Point(0,0), Point(10,0),
+      Point(0,5)), default_rectangle_settings());
+    obj->SetName(option(utf8_string(name)));
+    return std::unique_ptr<Object>(obj);
+  };
+
+  auto r1 = rectangle("r1");
+  auto r2 = rectangle("r2");
+  auto r3 = rectangle("r3");
+  auto r4 = rectangle("r4");
+  auto r5 = rectangle("r2");
+
+  Image image;
+  image.Add(r1.get());
+  image.Add(r2.get());
+  image.Add(r3.get(), 0);
+
+  {
+    // Test "GetObjectZ", "Has"
+    EQUAL(image.GetObjectZ(r3.get()), 0);
+    EQUAL(image.GetObjectZ(r1.get()), 1);
+    EQUAL(image.GetObjectZ(r2.get()), 2);
+    VERIFY(image.Has(r1.get()));
+    VERIFY(image.Has(r1->GetId()));
+    VERIFY(!image.Has(r4.get()));
+    VERIFY(!image.Has(r4->GetId()));
+
+    image.SetObjectZ(r2.get(), 0);
+    EQUAL(image.GetObjectZ(r2.get()), 0);
+    EQUAL(image.GetObjectZ(r3.get()), 1);
+    EQUAL(image.GetObjectZ(r1.get()), 2);
+    EQUAL(image.GetObjects().size(), 3);
+
+    // Moving up is clamped to the top, the selection is kept sorted
+    image.SelectObjects({r1.get(), r2.get()});
+    image.SetObjectZ(r2.get(), 10);
+    EQUAL(image.GetObjectZ(r3.get()), 0);
+    EQUAL(image.GetObjectZ(r1.get()), 1);
+    EQUAL(image.GetObjectZ(r2.get()), 2);
+    VERIFY(image.GetObjectSelection() == objects_t({r1.get(), r2.get()}));
+    image.SetObjectZ(r2.get(), 0);
+    EQUAL(image.GetObjectZ(r2.get()), 0);
+    EQUAL(image.GetObjectZ(r3.get()), 1);
+    EQUAL(image.GetObjectZ(r1.get()), 2);
+    VERIFY(image.GetObjectSelection() == objects_t({r2.get(), r1.get()}));
+    VERIFY(image.Has(r2->GetId()));
+    image.DeselectObjects();
+
+    image.Remove(r3.get());
+    VERIFY(!image.Has(r3.get()));
+    VERIFY(!image.Has(r3->GetId()));
+    EQUAL(image.GetObjectZ(r2.get()), 0);
+    EQUAL(image.GetObjectZ(r1.get()), 1);
+  }
+
+  {
+    // Test "FindObject"
+    VERIFY(image.FindObject("r1") == r1.get());
+    VERIFY(image.FindObject("r2") == r2.get());
+    VERIFY(image.FindObject("r3") == nullptr);
+    VERIFY(image.FindObject("") == nullptr);
+
+    // Objects within groups are found, the first in z-order wins
+    std::unique_ptr<Object> group(create_composite_object(
+      {r4.get(), r5.get()}, Ownership::LOANER));
+    group->SetName(option(utf8_string("group")));
+    image.Add(group.get(), 0);
+    VERIFY(image.Has(r4->GetId()));
+    VERIFY(image.Has(r5->GetId()));
+    VERIFY(image.FindObject("group") == group.get());
+    VERIFY(image.FindObject("r4") == r4.get());
+    VERIFY(image.FindObject("r2") == r5.get());
+
+    // Renaming requires notifying the image
+    r5->SetName(option(utf8_string("r5")));
+    image.NotifyObjectsModified();
+    VERIFY(image.FindObject("r2") == r2.get());
+    VERIFY(image.FindObject("r5") == r5.get());
+
+    image.Remove(group.get());
+    VERIFY(!image.Has(r4->GetId()));
+    VERIFY(image.FindObject("r4") == nullptr);
+  }
+}
@@ -0,0 +1,79 @@
+// -*- coding: us-ascii-unix -*-
+#include <vector>
+#include "test-sys/test.hh"
+#include "tests/test-util/print-objects.hh"
+#include "geo/canvas-geo.hh"
+#include "geo/point.hh"
+#include "util/motion-queue.hh"
+#include "util/mouse.hh"
+
+using namespace faint;
+
+static CanvasGeo geo(coord scale, const IntPoint& pos){
+  CanvasGeo g;
+  g.zoom.SetApproximate(scale);
+  g.pos = pos;
+  return g;
+}
+
+void test_motion_queue(){
+  using mouse::view_to_image;
+  MotionQueue queue;
+
+  ToolModifiers left;
+  left.SetLeftMouse();
+  ToolModifiers primary;
+  primary.SetPrimary();
+
+  CanvasGeo g = geo(1.0, IntPoint(0, 0));
+  VERIFY(queue.Push(IntPoint(10, 20), left, g));
+  VERIFY(queue.Push(IntPoint(12, 22), primary, g));
+  const Point first = view_to_image(IntPoint(10, 20), g);
+  const Point second = view_to_image(IntPoint(12, 22), g);
+
+  // Zoom and scroll before the queue is drained (e.g. with the mouse
+  // wheel). The queued positions must still map to the image points
+  // they were received at.
+  g = geo(2.0, IntPoint(30, 40));
+  VERIFY(view_to_image(IntPoint(10, 20), g) != first);
+  VERIFY(queue.Push(IntPoint(10, 20), left, g));
+
+  std::vector<Point> drained;
+  std::vector<bool> leftMouse;
+  EQUAL(queue.Drain([&](const MotionSample& sample){
+    drained.push_back(view_to_image(sample.pos, sample.geo));
+    leftMouse.push_back(sample.modifiers.LeftMouse());
+  }), 3);
+
+  ABORT_IF(drained.size() != 3);
+  EQUAL(drained[0], first);
+  EQUAL(drained[1], second);
+  EQUAL(drained[2], view_to_image(IntPoint(10, 20), g));
+  VERIFY(leftMouse[0]);
+  VERIFY(!leftMouse[1]);
+  VERIFY(leftMouse[2]);
+  EQUAL(queue.Drain([](const MotionSample&){}), 0);
+
+  // Draining from the callback continues with the remaining samples.
+  for (int i = 0; i != 3; i++){
+    VERIFY(queue.Push(IntPoint(i, i), left, g));
+  }
+  std::vector<int> order;
+  queue.Drain([&](const MotionSample& sample){
+    order.push_back(sample.pos.x);
+    queue.Drain([&](const MotionSample& inner){
+      order.push_back(inner.pos.x);
+    });
+  });
+  ABORT_IF(order.size() != 3);
+  EQUAL(order[0], 0);
+  EQUAL(order[1], 1);
+  EQUAL(order[2], 2);
+
+  // A full queue refuses further positions.
+  size_t pushed = 0;
+  while (queue.Push(IntPoint(0, 0), left, g)){
+    pushed++;
+  }
+  EQUAL(pushed, 1024);
+}
@@ -0,0 +1,162 @@
+// -*- coding: us-ascii-unix -*-
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include "test-sys/test.hh"
+#include "tests/test-util/print-objects.hh"
+#include "bitmap/alpha-map.hh"
+#include "bitmap/bitmap-templates.hh"
+#include "bitmap/bitmap.hh"
+#include "bitmap/color.hh"
+#include "bitmap/draw.hh"
+#include "bitmap/gradient.hh"
+#include "bitmap/paint.hh"
+#include "bitmap/pattern.hh"
+#include "geo/int-rect.hh"
+#include "geo/offsat.hh"
+
+void test_paint_span(){
+  using namespace faint;
+
+  {
+    // Test ColorRamp
+    const ColorRamp ramp({{color_white, 1.0}, {color_black, 0.0}});
+    EQUAL(ramp.At(0.0), color_black);
+    EQUAL(ramp.At(1.0), color_white);
+    EQUAL(ramp.At(-1.0), color_black);
+    EQUAL(ramp.At(2.0), color_white);
+    EQUAL(ramp.At(std::numeric_limits<double>::quiet_NaN()), color_black);
+    VERIFY(std::abs(ramp.At(0.5).r - 128) <= 1);
+    EQUAL(ramp.At(0.5).a, 255);
+
+    const ColorRamp sharp({{color_red, 0.0}, {color_red, 0.5},
+      {color_blue, 0.5}, {color_blue, 1.0}});
+    EQUAL(sharp.At(0.49), color_red);
+    EQUAL(sharp.At(0.51), color_blue);
+
+    EQUAL(ColorRamp({}).At(0.5), color_transparent_black);
+    EQUAL(ColorRamp({{color_green, 0.3}}).At(0.9), color_green);
+  }
+
+  Bitmap patternBmp(IntSize(3, 2));
+  for (int y = 0; y != 2; y++){
+    for (int x = 0; x != 3; x++){
+      put_pixel_raw(patternBmp, x, y, Color(uchar(10 + x * 40),
+        uchar(20 + y * 100), 30, uchar(100 + x)));
+    }
+  }
+  const Pattern pattern(patternBmp, IntPoint(1, 2), object_aligned_t(false));
+
+  {
+    // Pattern fill, partly outside the bitmap
+    Bitmap bmp(IntSize(10, 6), color_white);
+    const IntRect r(IntPoint(-2, 1), IntSize(9, 4));
+    fill_rect(bmp, r, Paint(pattern));
+    for (int y = 0; y != bmp.m_h; y++){
+      for (int x = 0; x != bmp.m_w; x++){
+        const Color expected = r.Contains(IntPoint(x, y)) ?
+          get_color_modulo(patternBmp, IntPoint(x, y) + pattern.GetAnchor()) :
+          color_white;
+        EQUAL(get_color_raw(bmp, x, y), expected);
+      }
+    }
+  }
+
+  {
+    // Pattern blended via an alpha map
+    AlphaMap alpha(IntSize(5, 3));
+    for (int y = 0; y != 3; y++){
+      for (int x = 0; x != 5; x++){
+        alpha.Set(x, y, uchar(x * 60 + y * 5));
+      }
+    }
+
+    const Color bg(200, 100, 50, 128);
+    Bitmap bmp(IntSize(6, 4), bg);
+    const IntPoint offset(2, 1);
+    blend(offsat(alpha.FullReference(), offset), onto(bmp), Paint(pattern));
+    for (int y = 0; y != bmp.m_h; y++){
+      for (int x = 0; x != bmp.m_w; x++){
+        const IntPoint local = IntPoint(x, y) - offset;
+        if (local.x < 0 || local.y < 0 || local.y >= 3){
+          EQUAL(get_color_raw(bmp, x, y), bg);
+          continue;
+        }
+        const int a = alpha.Get(local.x, local.y);
+        const Color src = get_color_modulo(patternBmp,
+          IntPoint(x, y) + pattern.GetAnchor());
+        auto mixed = [a](int s, int d){
+          return uchar((s * a + d * (255 - a)) / 255);
+        };
+        EQUAL(get_color_raw(bmp, x, y), Color(mixed(src.r, bg.r),
+          mixed(src.g, bg.g), mixed(src.b, bg.b),
+          uchar(std::max(a, int(bg.a)))));
+      }
+    }
+  }
+
+  {
+    // Horizontal linear gradient
+    const Gradient g(LinearGradient(Angle::Zero(),
+      {{color_black, 0.0}, {color_white, 1.0}}));
+    Bitmap bmp(IntSize(256, 4), color_red);
+    fill_rect(bmp, IntRect(IntPoint(0, 0), IntSize(256, 4)), Paint(g));
+    for (int y = 0; y != 4; y++){
+      for (int x = 0; x != 256; x++){
+        const Color c = get_color_raw(bmp, x, y);
+        VERIFY(std::abs(c.r - x) <= 1);
+        EQUAL(c, get_color_raw(bmp, x, 0));
+      }
+    }
+
+    // Vertical, extending outside the rectangle repeats the gradient
+    const Gradient vertical(LinearGradient(Angle::Deg(90),
+      {{color_black, 0.0}, {color_white, 1.0}}));
+    Bitmap bmp2(IntSize(2, 20), color_red);
+    fill_rect(bmp2, IntRect(IntPoint(0, 0), IntSize(2, 20)),
+      Paint(vertical));
+    VERIFY(get_color_raw(bmp2, 0, 0).r < 10);
+    VERIFY(get_color_raw(bmp2, 0, 19).r > 245);
+    VERIFY(get_color_raw(bmp2, 0, 5).r < get_color_raw(bmp2, 0, 6).r);
+    EQUAL(get_color_raw(bmp2, 0, 7), get_color_raw(bmp2, 1, 7));
+  }
+
+  {
+    // Radial gradient
+    const Gradient g(RadialGradient(Point(0, 0), Radii(1.0, 1.0),
+      {{color_white, 0.0}, {color_blue, 1.0}}));
+    Bitmap bmp(IntSize(100, 100), color_red);
+    fill_rect(bmp, IntRect(IntPoint(0, 0), IntSize(100, 100)), Paint(g));
+    VERIFY(get_color_raw(bmp, 50, 50).r > 245);
+    EQUAL(get_color_raw(bmp, 0, 0), color_blue);
+    EQUAL(get_color_raw(bmp, 99, 99), color_blue);
+    EQUAL(get_color_raw(bmp, 30, 50), get_color_raw(bmp, 50, 30));
+  }
+
+  {
+    // Off-center radial gradient, compared with the per-pixel mapping
+    // of the Cairo gradient matrix (scaled to the rectangle, then
+    // translated by -center.x, +center.y).
+    const Point center(10, 20);
+    const Gradient g(RadialGradient(center, Radii(1.0, 1.0),
+      {{color_white, 0.0}, {color_blue, 1.0}}));
+    const IntRect r(IntPoint(4, 6), IntSize(100, 80));
+    Bitmap bmp(IntSize(110, 90), color_red);
+    fill_rect(bmp, r, Paint(g));
+    for (int y = r.Top(); y <= r.Bottom(); y++){
+      for (int x = r.Left(); x <= r.Right(); x++){
+        const coord dx = (x - r.x + 0.5 - center.x) / r.w - 0.5;
+        const coord dy = (y - r.y + 0.5 + center.y) / r.h - 0.5;
+        const Color expected = g.GetRamp().At(2 * std::sqrt(dx * dx + dy * dy));
+        const Color c = get_color_raw(bmp, x, y);
+        VERIFY(std::abs(c.r - expected.r) <= 1);
+        VERIFY(std::abs(c.b - expected.b) <= 1);
+      }
+    }
+
+    // The center is moved right and up
+    const IntPoint brightest(r.x + 60, r.y + 20);
+    VERIFY(get_color_raw(bmp, brightest.x, brightest.y).r > 245);
+    VERIFY(get_color_raw(bmp, brightest.x, r.y + 60).r < 150);
+  }
+}
@@ -0,0 +1,110 @@
+// -*- coding: us-ascii-unix -*-
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include "test-sys/test.hh"
+#include "util/parallel.hh"
+
+void test_parallel(){
+  using namespace faint;
+
+  const int defaultConcurrency = get_concurrency();
+  VERIFY(defaultConcurrency >= 1);
+
+  for (int concurrency : {1, 2, 5}){
+    set_concurrency(concurrency);
+    EQUAL(get_concurrency(), concurrency);
+
+    {
+      // Each index is visited once, in ranges of at most the grain
+      std::vector<std::atomic<int>> visits(1000);
+      for (auto& v : visits){
+        v = 0;
+      }
+      std::atomic<int> tooLong(0);
+      parallel_for(1000, 7, [&](int begin, int end){
+        if (end - begin > 7 || begin % 7 != 0){
+          tooLong++;
+        }
+        for (int i = begin; i != end; i++){
+          visits[static_cast<size_t>(i)]++;
+        }
+      });
+      EQUAL(tooLong, 0);
+      int once = 0;
+      for (auto& v : visits){
+        once += v == 1 ? 1 : 0;
+      }
+      EQUAL(once, 1000);
+    }
+
+    {
+      // The reduction is in range order
+      const std::vector<int> order = parallel_reduce(100, 10,
+        std::vector<int>(),
+        [](int begin, int){
+          return std::vector<int>(1, begin);
+        },
+        [](std::vector<int> all, const std::vector<int>& part){
+          all.insert(all.end(), part.begin(), part.end());
+          return all;
+        });
+      VERIFY(order == std::vector<int>({0, 10, 20, 30, 40, 50, 60, 70,
+        80, 90}));
+
+      const int sum = parallel_reduce(1001, 13, 5,
+        [](int begin, int end){
+          int partial = 0;
+          for (int i = begin; i != end; i++){
+            partial += i;
+          }
+          return partial;
+        },
+        [](int a, int b){
+          return a + b;
+        });
+      EQUAL(sum, 5 + 1000 * 1001 / 2);
+    }
+
+    {
+      // Nested calls run on the calling thread
+      std::atomic<int> count(0);
+      parallel_for(8, 1, [&](int, int){
+        parallel_for(10, 2, [&](int begin, int end){
+          count += end - begin;
+        });
+      });
+      EQUAL(count, 80);
+    }
+
+    {
+      // Exceptions are passed to the caller
+      bool caught = false;
+      try{
+        parallel_for(100, 1, [](int begin, int){
+          if (begin == 50){
+            throw std::runtime_error("fail");
+          }
+        });
+      }
+      catch (const std::runtime_error&){
+        caught = true;
+      }
+      VERIFY(caught);
+    }
+  }
+
+  {
+    // Counters
+    reset_parallel_stats();
+    EQUAL(get_parallel_stats().tasks, 0);
+    parallel_for(64, 4, [](int, int){});
+    const ParallelStats stats = get_parallel_stats();
+    EQUAL(stats.jobs, 1);
+    EQUAL(stats.tasks, 16);
+    VERIFY(stats.taskSeconds >= 0.0);
+  }
+
+  set_concurrency(0);
+  EQUAL(get_concurrency(), defaultConcurrency);
+}
@@ -0,0 +1,73 @@
+// -*- coding: us-ascii-unix -*-
+#include <cmath>
+#include "test-sys/test.hh"
+#include "tests/test-util/print-objects.hh"
+#include "bitmap/bitmap.hh"
+#include "bitmap/color.hh"
+#include "bitmap/filter.hh"
+#include "bitmap/pinch-whirl.hh"
+#include "util/math-constants.hh"
+
+void test_pinch_whirl(){
+  using namespace faint;
+
+  Bitmap bmp(IntSize(41, 30));
+  for (int y = 0; y != bmp.m_h; y++){
+    for (int x = 0; x != bmp.m_w; x++){
+      put_pixel_raw(bmp, x, y, color_from_ints(x * 6, y * 8, 100, 255));
+    }
+  }
+
+  // No pinch or whirl leaves the bitmap unchanged
+  VERIFY(PinchWhirlField(bmp.GetSize(), 0.0, Angle::Zero()).Apply(bmp) ==
+    bmp);
+
+  // Matches the pinch and whirl computed directly for each pixel,
+  // also for the mirrored lower half.
+  const coord pinch = 0.6;
+  const Angle whirl = Angle::Deg(90);
+  const Bitmap result(PinchWhirlField(bmp.GetSize(), pinch, whirl).Apply(bmp));
+  const coord cx = (bmp.m_w - 1) / 2.0;
+  const coord cy = (bmp.m_h - 1) / 2.0;
+  const coord radius = bmp.m_w / 2.0;
+  for (int y = 0; y != bmp.m_h; y++){
+    for (int x = 0; x != bmp.m_w; x++){
+      const coord dx = x - cx;
+      const coord dy = y - cy;
+      const coord dist = std::sqrt(dx * dx + dy * dy) / radius;
+      if (dist >= 1.0){
+        EQUAL(get_color_raw(result, x, y), get_color_raw(bmp, x, y));
+        continue;
+      }
+      const coord scale = std::pow(std::sin(math::pi / 2 * dist), pinch);
+      const coord angle = whirl.Rad() * (1 - dist) * (1 - dist);
+      const coord sx = cx + scale * (std::cos(angle) * dx -
+        std::sin(angle) * dy);
+      const coord sy = cy + scale * (std::sin(angle) * dx +
+        std::cos(angle) * dy);
+
+      if (sx < 0 || sx > bmp.m_w - 1 || sy < 0 || sy > bmp.m_h - 1){
+        // Pixels from outside the bitmap are kept
+        EQUAL(get_color_raw(result, x, y), get_color_raw(bmp, x, y));
+        continue;
+      }
+
+      // The source is a linear gradient, so bilinear sampling gives
+      // the gradient at the source position.
+      const Color c(get_color_raw(result, x, y));
+      VERIFY(std::fabs(c.r - sx * 6) <= 1.5);
+      VERIFY(std::fabs(c.g - sy * 8) <= 1.5);
+    }
+  }
+
+  // The most recent field is reused
+  auto f1 = pinch_whirl_field(bmp.GetSize(), pinch, whirl);
+  auto f2 = pinch_whirl_field(bmp.GetSize(), pinch, whirl);
+  VERIFY(f1 == f2);
+  VERIFY(pinch_whirl_field(bmp.GetSize(), pinch, Angle::Zero()) != f1);
+
+  // Fields for large sizes are not kept
+  const IntSize large(2048, 1024);
+  VERIFY(pinch_whirl_field(large, pinch, whirl) !=
+    pinch_whirl_field(large, pinch, whirl));
+}
@@ -0,0 +1,92 @@
+// -*- coding: us-ascii-unix -*-
+#include "test-sys/test.hh"
+#include "tests/test-util/print-objects.hh"
+#include "bitmap/bitmap.hh"
+#include "bitmap/color.hh"
+#include "bitmap/draw.hh"
+#include "bitmap/filter.hh"
+#include "bitmap/pixel-view.hh"
+
+void test_pixel_view(){
+  using namespace faint;
+
+  {
+    // Test "Pack", "Unpack"
+    using RGBA = PixelFormat<0, 1, 2, 3>;
+    uchar px[BPP];
+    store_pixel(px, RGBA::Pack(10, 20, 30, 40));
+    EQUAL(px[0], 10);
+    EQUAL(px[1], 20);
+    EQUAL(px[2], 30);
+    EQUAL(px[3], 40);
+    EQUAL(RGBA::Unpack(px), Color(10, 20, 30, 40));
+
+    store_pixel(px, BitmapFormat::Pack(Color(10, 20, 30, 40)));
+    EQUAL(px[iR], 10);
+    EQUAL(px[iG], 20);
+    EQUAL(px[iB], 30);
+    EQUAL(px[iA], 40);
+    EQUAL(BitmapFormat::Unpack(px), Color(10, 20, 30, 40));
+  }
+
+  {
+    // The view addresses the pixels of the Bitmap, with its stride
+    Bitmap bmp(IntSize(5, 3), color_white);
+    const auto view = pixel_view(bmp);
+    EQUAL(view.GetSize(), IntSize(5, 3));
+    VERIFY(view.Row(2) == bmp.m_data + 2 * bmp.m_row_stride);
+
+    view.Set(3, 1, BitmapFormat::Pack(color_red));
+    EQUAL(get_color_raw(bmp, 3, 1), color_red);
+    EQUAL(view.Get(3, 1), BitmapFormat::Pack(color_red));
+    EQUAL(BitmapFormat::Unpack(view.At(3, 1)), color_red);
+
+    const Bitmap& constBmp(bmp);
+    EQUAL(pixel_view(constBmp).Get(0, 0), BitmapFormat::Pack(color_white));
+  }
+
+  {
+    // A premultiplied source blends like the straight source it was
+    // premultiplied from, up to the rounding of the premultiplication.
+    using Premultiplied = PixelFormat<iR, iG, iB, iA, true>;
+    const Color c(200, 100, 50, 128);
+    uchar straight[BPP];
+    store_pixel(straight, BitmapFormat::Pack(c));
+    uchar premultiplied[BPP];
+    store_pixel(premultiplied, Premultiplied::Pack(200 * 128 / 255,
+      100 * 128 / 255, 50 * 128 / 255, 128));
+
+    uchar dst1[BPP];
+    uchar dst2[BPP];
+    store_pixel(dst1, BitmapFormat::Pack(Color(10, 250, 90, 255)));
+    store_pixel(dst2, BitmapFormat::Pack(Color(10, 250, 90, 255)));
+    blend_color_channels<BitmapFormat, BitmapFormat>(straight, dst1, c.a);
+    blend_color_channels<Premultiplied, BitmapFormat>(premultiplied, dst2, c.a);
+
+    EQUAL(BitmapFormat::Unpack(dst1), Color(105, 174, 69, 255));
+    EQUAL(BitmapFormat::Unpack(dst2), Color(104, 174, 69, 255));
+  }
+
+  {
+    // Test the filters ported to the view against per-pixel results
+    Bitmap bmp(IntSize(7, 4), Color(10, 20, 30, 40));
+    put_pixel_raw(bmp, 6, 3, Color(200, 100, 0, 255));
+
+    Bitmap inverted(bmp);
+    invert(inverted);
+    EQUAL(get_color_raw(inverted, 0, 0), Color(245, 235, 225, 40));
+    EQUAL(get_color_raw(inverted, 6, 3), Color(55, 155, 255, 255));
+
+    Bitmap desaturated(bmp);
+    desaturate_simple(desaturated);
+    EQUAL(get_color_raw(desaturated, 0, 0), Color(20, 20, 20, 40));
+    EQUAL(get_color_raw(desaturated, 6, 3), Color(100, 100, 100, 255));
+
+    Bitmap weighted(bmp);
+    desaturate_weighted(weighted);
+    EQUAL(get_color_raw(weighted, 6, 3), Color(119, 119, 119, 255));
+
+    const Bitmap difference(subtract(bmp, inverted));
+    EQUAL(get_color_raw(difference, 6, 3), Color(145, 0, 0, 0));
+  }
+}
@@ -0,0 +1,57 @@
+// -*- coding: us-ascii-unix -*-
+#include <cstdint>
+#include "test-sys/test.hh"
+#include "tests/test-util/print-objects.hh"
+#include "bitmap/bitmap.hh"
+#include "bitmap/color.hh"
+#include "bitmap/draw.hh"
+#include "bitmap/planar-image.hh"
+#include "util/scratch-arena.hh"
+
+void test_planar_image(){
+  using namespace faint;
+
+  Bitmap bmp(IntSize(70, 9));
+  for (int y = 0; y != bmp.m_h; y++){
+    for (int x = 0; x != bmp.m_w; x++){
+      put_pixel_raw(bmp, x, y, color_from_ints(x, y, x + y, 255 - x));
+    }
+  }
+
+  ScratchArena arena;
+  {
+    // Test "deinterleave", "interleave" for the entire bitmap
+    const PlanarImage planes(bmp.GetSize(), arena);
+    EQUAL(planes.GetSize(), bmp.GetSize());
+    deinterleave(bmp, 0, planes);
+
+    const Plane red(planes.Channel(iR));
+    const Plane alpha(planes.Channel(iA));
+    VERIFY(red.GetStride() >= bmp.m_w);
+    for (int y = 0; y != bmp.m_h; y++){
+      VERIFY(reinterpret_cast<uintptr_t>(red.Row(y)) %
+        scratch_alignment == 0);
+    }
+    EQUAL(red.Row(3)[5], 5);
+    EQUAL(planes.Channel(iG).Row(3)[5], 3);
+    EQUAL(planes.Channel(iB).Row(3)[5], 8);
+    EQUAL(alpha.Row(3)[5], 250);
+
+    Bitmap dst(bmp.GetSize(), color_magenta);
+    interleave(planes, dst, 0);
+    VERIFY(dst == bmp);
+  }
+
+  {
+    // Converting in bands of rows, with planes for one band
+    arena.Reset();
+    const PlanarImage band(IntSize(bmp.m_w, 3), arena);
+    Bitmap dst(bmp.GetSize(), color_magenta);
+    for (int y0 = 0; y0 != bmp.m_h; y0 += 3){
+      deinterleave(bmp, y0, band);
+      EQUAL(band.Channel(iG).Row(0)[0], y0);
+      interleave(band, dst, y0);
+    }
+    VERIFY(dst == bmp);
+  }
+}
@@ -0,0 +1,112 @@
+// -*- coding: us-ascii-unix -*-
+#include "test-sys/test.hh"
+#include "tests/test-util/print-objects.hh"
+#include "bitmap/bitmap.hh"
+#include "bitmap/color.hh"
+#include "bitmap/draw.hh"
+#include "bitmap/filter.hh"
+#include "bitmap/gaussian-blur.hh"
+#include "geo/angle.hh"
+#include "geo/int-rect.hh"
+#include "util/preview-filter.hh"
+
+void test_preview_filter(){
+  using namespace faint;
+
+  Bitmap bmp(IntSize(50, 40), color_white);
+  for (int y = 0; y != bmp.m_h; y++){
+    for (int x = 0; x != bmp.m_w; x++){
+      put_pixel_raw(bmp, x, y, color_from_ints((x * 5) % 256, (y * 7) % 256,
+        (x * y) % 256, 255));
+    }
+  }
+
+  const auto notCancelled = [](){return false;};
+  const IntRect region(IntPoint(7, 5), IntSize(20, 30));
+
+  {
+    // Pixelwise filters at full resolution match the filtered bitmap
+    const auto filter = PreviewFilter::Pixelwise(
+      [](const Bitmap& src){
+        Bitmap dst(src);
+        invert(dst);
+        return dst;
+      });
+    Bitmap full(bmp);
+    invert(full);
+    const auto preview = filter_region(bmp, filter, region, 1.0,
+      notCancelled);
+    VERIFY(preview.IsSet());
+    VERIFY(preview.Get() == subbitmap(full, region));
+
+    // ..and are expanded to the region size when zoomed out
+    const auto zoomedOut = filter_region(bmp, filter, region, 0.25,
+      notCancelled);
+    VERIFY(zoomedOut.IsSet());
+    EQUAL(zoomedOut.Get().GetSize(), region.GetSize());
+    EQUAL(get_color_raw(zoomedOut.Get(), 0, 0),
+      get_color_raw(full, region.x, region.y));
+  }
+
+  {
+    // Local filters use the margin around the region
+    const double sigma = 2.0;
+    const auto filter = PreviewFilter::Local(static_cast<int>(3 * sigma) + 2,
+      1, [=](const Bitmap& src){
+        return gaussian_blur_fast(src, sigma);
+      });
+    const auto preview = filter_region(bmp, filter, region, 1.0,
+      notCancelled);
+    VERIFY(preview.IsSet());
+    VERIFY(preview.Get() == subbitmap(gaussian_blur_fast(bmp, sigma),
+      region));
+  }
+
+  {
+    // Aligned local filters are computed on whole cells
+    const auto filter = PreviewFilter::Local(0, 6,
+      [](const Bitmap& src){
+        Bitmap dst(src);
+        pixelize(dst, pixelize_range_t(6));
+        return dst;
+      });
+    Bitmap full(bmp);
+    pixelize(full, pixelize_range_t(6));
+    const auto preview = filter_region(bmp, filter, region, 1.0,
+      notCancelled);
+    VERIFY(preview.IsSet());
+    VERIFY(preview.Get() == subbitmap(full, region));
+  }
+
+  {
+    // Scale invariant filters use the entire bitmap, scaled when
+    // zoomed out
+    const auto filter = PreviewFilter::ScaleInvariant(
+      [](const Bitmap& src){
+        Bitmap dst(src);
+        filter_pinch_whirl(dst, 0.5, Angle::Deg(45));
+        return dst;
+      });
+    Bitmap full(bmp);
+    filter_pinch_whirl(full, 0.5, Angle::Deg(45));
+    const auto preview = filter_region(bmp, filter, region, 1.0,
+      notCancelled);
+    VERIFY(preview.IsSet());
+    VERIFY(preview.Get() == subbitmap(full, region));
+
+    const auto zoomedOut = filter_region(bmp, filter, region, 0.5,
+      notCancelled);
+    VERIFY(zoomedOut.IsSet());
+    EQUAL(zoomedOut.Get().GetSize(), region.GetSize());
+  }
+
+  {
+    // Cancelled previews give no result
+    const auto filter = PreviewFilter::Global(
+      [](const Bitmap& src){
+        return src;
+      });
+    VERIFY(filter_region(bmp, filter, region, 1.0,
+      [](){return true;}).NotSet());
+  }
+}
@@ -0,0 +1,80 @@
+// -*- coding: us-ascii-unix -*-
+#include <functional>
+#include <thread>
+#include <vector>
+#include "test-sys/test.hh"
+#include "util/ring-buffer.hh"
+
+void test_ring_buffer(){
+  using namespace faint;
+
+  {
+    // Single thread, filling and wrapping around
+    RingBuffer<int, 4> buffer;
+    VERIFY(buffer.Empty());
+    VERIFY(buffer.Push(1));
+    VERIFY(buffer.Push(2));
+    VERIFY(buffer.Push(3));
+    VERIFY(buffer.Push(4));
+    VERIFY(!buffer.Push(5));
+    VERIFY(!buffer.Empty());
+
+    std::vector<int> drained;
+    EQUAL(buffer.Drain([&](int v){drained.push_back(v);}), 4);
+    VERIFY(drained == std::vector<int>({1, 2, 3, 4}));
+    VERIFY(buffer.Empty());
+    EQUAL(buffer.Drain([&](int v){drained.push_back(v);}), 0);
+
+    VERIFY(buffer.Push(6));
+    VERIFY(buffer.Push(7));
+    drained.clear();
+    EQUAL(buffer.Drain([&](int v){drained.push_back(v);}), 2);
+    VERIFY(drained == std::vector<int>({6, 7}));
+  }
+
+  {
+    // Draining from within func, e.g. when handling an item flushes
+    // the queue again: every item is passed once.
+    RingBuffer<int, 8> buffer;
+    for (int i = 0; i != 5; i++){
+      buffer.Push(i);
+    }
+    std::vector<int> drained;
+    std::function<void(int)> handle = [&](int v){
+      drained.push_back(v);
+      if (v == 1){
+        buffer.Push(5);
+        buffer.Drain(handle);
+      }
+    };
+    EQUAL(buffer.Drain(handle), 2);
+    VERIFY(drained == std::vector<int>({0, 1, 2, 3, 4, 5}));
+    VERIFY(buffer.Empty());
+  }
+
+  {
+    // A producer thread pushing while this thread drains: every item
+    // arrives once, in order.
+    RingBuffer<int, 64> buffer;
+    const int count = 100000;
+    std::thread producer([&](){
+      for (int i = 0; i != count; i++){
+        while (!buffer.Push(i)){
+          std::this_thread::yield();
+        }
+      }
+    });
+
+    int expected = 0;
+    bool ordered = true;
+    while (expected != count){
+      buffer.Drain([&](int v){
+        ordered = ordered && v == expected;
+        expected++;
+      });
+    }
+    producer.join();
+    VERIFY(ordered);
+    VERIFY(buffer.Empty());
+  }
+}
@@ -0,0 +1,75 @@
+// -*- coding: us-ascii-unix -*-
+#include "test-sys/test.hh"
+#include "tests/test-util/print-objects.hh"
+#include "bitmap/bitmap.hh"
+#include "bitmap/color.hh"
+#include "bitmap/draw.hh"
+#include "bitmap/rotate-util.hh"
+#include "geo/angle.hh"
+#include "geo/int-size.hh"
+
+static faint::Bitmap rotate_per_pixel(const faint::Bitmap& bmp,
+  const faint::Angle& angle,
+  const faint::Color& bg)
+{
+  // Maps every destination pixel separately, like rotate_nearest did
+  // before using stepped rows
+  using namespace faint;
+  const RotationAdjustment adj = get_rotation_adjustment(angle,
+    bmp.GetSize());
+  Bitmap dst(adj.size, bg);
+  const coord ca = cos(angle);
+  const coord sa = sin(angle);
+  const coord divisor = ca * ca + sa * sa;
+  for (int y = 0; y != dst.m_h; y++){
+    for (int x = 0; x != dst.m_w; x++){
+      const double X = static_cast<double>(x) + adj.offset.x;
+      const double Y = static_cast<double>(y) + adj.offset.y;
+      const int srcX = static_cast<int>((ca * X + sa * Y) / divisor);
+      const int srcY = static_cast<int>(-X * sa + ca * Y);
+      if (srcX >= 0 && srcY >= 0 && srcX < bmp.m_w && srcY < bmp.m_h){
+        put_pixel_raw(dst, x, y, get_color_raw(bmp, srcX, srcY));
+      }
+    }
+  }
+  return dst;
+}
+
+void test_rotate_nearest(){
+  using namespace faint;
+
+  const Color bg(10, 20, 30, 40);
+  for (const IntSize& size : {IntSize(1, 1), IntSize(2, 3), IntSize(37, 23),
+    IntSize(64, 64)})
+  {
+    Bitmap src(size);
+    for (int y = 0; y != size.h; y++){
+      for (int x = 0; x != size.w; x++){
+        put_pixel_raw(src, x, y, Color(uchar(x * 7), uchar(y * 11),
+          uchar(x ^ y), 255));
+      }
+    }
+
+    for (int deg = -360; deg <= 360; deg += 5){
+      const Angle angle = Angle::Deg(deg + 0.25 * (deg % 3));
+      const Bitmap expected = rotate_per_pixel(src, angle, bg);
+      VERIFY(rotate_nearest(src, angle, bg) == expected);
+    }
+
+    // Right angles, where the sine or cosine is not exactly zero
+    for (int deg : {0, 90, 180, 270, -90}){
+      const Angle angle = Angle::Deg(deg);
+      VERIFY(rotate_nearest(src, angle, bg) ==
+        rotate_per_pixel(src, angle, bg));
+      VERIFY(rotate_nearest(src, angle, color_transparent_black) ==
+        rotate_per_pixel(src, angle, color_transparent_black));
+    }
+
+    // Tiny angles
+    for (double rad : {1e-9, -1e-9, 1e-3, -2e-4}){
+      const Angle angle = Angle::Rad(rad);
+      VERIFY(rotate_nearest(src, angle, bg) ==
+        rotate_per_pixel(src, angle, bg));
+    }
+  }
+}
@@ -0,0 +1,116 @@
+// -*- coding: us-ascii-unix -*-
+#include <cstdint>
+#include "test-sys/test.hh"
+#include "util/scratch-arena.hh"
+
+static bool is_aligned(const void* p){
+  return reinterpret_cast<uintptr_t>(p) % faint::scratch_alignment == 0;
+}
+
+void test_scratch_arena(){
+  using namespace faint;
+
+  ScratchArena arena;
+  EQUAL(arena.Capacity(), 0);
+  EQUAL(arena.Used(), 0);
+
+  void* p1 = arena.Allocate(10);
+  void* p2 = arena.Allocate(100);
+  VERIFY(is_aligned(p1));
+  VERIFY(is_aligned(p2));
+  VERIFY(static_cast<char*>(p2) >= static_cast<char*>(p1) + 10);
+  VERIFY(arena.Used() >= 110);
+
+  // Allocations beyond the first block add blocks
+  const size_t large = 2 * arena.Capacity();
+  int* values = arena.AllocateArray<int>(large / sizeof(int));
+  VERIFY(is_aligned(values));
+  values[large / sizeof(int) - 1] = 1;
+  const size_t used = arena.Used();
+  VERIFY(arena.Capacity() >= used);
+
+  // Reset merges the blocks, so that the same allocations then fit
+  // without growing the arena.
+  arena.Reset();
+  EQUAL(arena.Used(), 0);
+  const size_t capacity = arena.Capacity();
+  VERIFY(capacity >= used);
+  void* p3 = arena.Allocate(10);
+  arena.Allocate(100);
+  arena.AllocateArray<int>(large / sizeof(int));
+  EQUAL(arena.Capacity(), capacity);
+
+  // Without growth, the memory is handed out again in the same order
+  arena.Reset();
+  EQUAL(arena.Allocate(10), p3);
+  EQUAL(arena.Capacity(), capacity);
+
+  // The peak is kept across resets, the heap is only used for new
+  // blocks
+  VERIFY(arena.Peak() >= used);
+  VERIFY(arena.Peak() > arena.Used());
+  const size_t heapAllocations = arena.HeapAllocations();
+  VERIFY(heapAllocations >= 3);
+  arena.Reset();
+  arena.AllocateArray<int>(large / sizeof(int));
+  EQUAL(arena.HeapAllocations(), heapAllocations);
+
+  {
+    // Rewinding releases the allocations since the mark, so that
+    // temporaries taken and rewound one after another reuse the same
+    // memory and the peak is the largest one rather than their sum.
+    ScratchArena rewound;
+    rewound.Allocate(10);
+    const size_t before = rewound.Used();
+    const ScratchArena::Mark mark = rewound.GetMark();
+    const size_t temporary = 4 * rewound.Capacity();
+    void* t1 = rewound.Allocate(temporary);
+    rewound.Rewind(mark);
+    EQUAL(rewound.Used(), before);
+    const size_t peak = rewound.Peak();
+    const size_t blocks = rewound.HeapAllocations();
+    for (int i = 0; i != 3; i++){
+      const ScratchArenaRewind rewind(&rewound);
+      EQUAL(rewound.Allocate(temporary), t1);
+    }
+    EQUAL(rewound.Used(), before);
+    EQUAL(rewound.Peak(), peak);
+    EQUAL(rewound.HeapAllocations(), blocks);
+
+    // A null arena is ignored
+    const ScratchArenaRewind ignored(nullptr);
+  }
+
+  {
+    // Reset frees rather than keeps an arena larger than
+    // scratch_max_kept
+    ScratchArena huge;
+    huge.Allocate(scratch_max_kept + 1);
+    huge.Reset();
+    EQUAL(huge.Capacity(), 0);
+    huge.Allocate(10);
+    VERIFY(huge.Capacity() < scratch_max_kept);
+  }
+
+  {
+    // Test the frame arena
+    VERIFY(frame_arena() == nullptr);
+    FrameArenaScope frame;
+    VERIFY(frame_arena() == &frame.Arena());
+    frame.Arena().Allocate(10);
+    const size_t outerUsed = frame.Arena().Used();
+    {
+      // Nested scopes share the arena and rewind it to where it was
+      // when they started, rather than reset it
+      FrameArenaScope nested;
+      VERIFY(&nested.Arena() == &frame.Arena());
+      nested.Arena().Allocate(1000);
+      VERIFY(frame.Arena().Used() > outerUsed);
+    }
+    VERIFY(frame_arena() == &frame.Arena());
+    EQUAL(frame.Arena().Used(), outerUsed);
+    VERIFY(outerUsed >= 10);
+  }
+  VERIFY(frame_arena() == nullptr);
+  EQUAL(FrameArenaScope().Arena().Used(), 0);
+}
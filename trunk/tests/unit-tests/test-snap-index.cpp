@@ -0,0 +1,75 @@
+// -*- coding: us-ascii-unix -*-
+#include <memory>
+#include "test-sys/test.hh"
+#include "tests/test-util/print-objects.hh"
+#include "geo/tri.hh"
+#include "objects/object.hh"
+#include "objects/objrectangle.hh"
+#include "util/default-settings.hh"
+#include "util/grid.hh"
+#include "util/image.hh"
+#include "util/object-util.hh"
+#include "util/snap-index.hh"
+
+void test_snap_index(){
+  using namespace faint;
+
+  // A grid of 20x20 rectangles with a few coinciding corners
+  std::vector<std::unique_ptr<Object> > owner;
+  objects_t objects;
+  for (int y = 0; y != 20; y++){
+    for (int x = 0; x != 20; x++){
+      const Point p0(x * 37.0 + (y % 3), y * 23.0 + (x % 5));
+      owner.emplace_back(create_rectangle_object(
+        Tri(p0, p0 + Point(11.5, 0), p0 + Point(0, 7.25)),
+        default_rectangle_settings()));
+      objects.push_back(owner.back().get());
+    }
+  }
+
+  Image image;
+  for (Object* obj : objects){
+    image.Add(obj);
+  }
+
+  const size_t pointsPerObject = objects[0]->GetAttachPoints().size();
+  EQUAL(image.GetSnapIndex().Size(), pointsPerObject * objects.size());
+
+  const Grid noGrid(false);
+  const Grid grid(true, 10);
+  const objects_t ignored = {objects[0], objects[21], objects[399]};
+  objects_t notIgnored(objects);
+  for (Object* obj : ignored){
+    remove(obj, from(notIgnored));
+  }
+
+  // The index must give the same results as the linear search
+  for (int y = -20; y < 500; y += 7){
+    for (int x = -20; x < 760; x += 11){
+      const Point p(x + 0.5, y + 0.25);
+      EQUAL(snap(p, image, objects_t(), noGrid), snap(p, objects, noGrid));
+      EQUAL(snap(p, image, ignored, noGrid), snap(p, notIgnored, noGrid));
+      EQUAL(snap(p, image, ignored, grid), snap(p, notIgnored, grid));
+      EQUAL(snap(p, image, objects_t(), noGrid, 5.0),
+        snap(p, objects, noGrid, 5.0));
+
+      EQUAL(snap_x(p.x, image, ignored, noGrid, p.y, p.y + 30),
+        snap_x(p.x, notIgnored, noGrid, p.y, p.y + 30));
+      EQUAL(snap_y(p.y, image, ignored, noGrid, p.x, p.x + 30),
+        snap_y(p.y, notIgnored, noGrid, p.x, p.x + 30));
+      EQUAL(snap_x(p.x, image, objects_t(), grid, p.y, p.y + 30),
+        snap_x(p.x, objects, grid, p.y, p.y + 30));
+    }
+  }
+
+  // Removing an object invalidates the index
+  image.Remove(objects[5]);
+  EQUAL(image.GetSnapIndex().Size(),
+    pointsPerObject * (objects.size() - 1));
+  const Point corner(objects[5]->GetTri().P0());
+  EQUAL(image.GetSnapIndex().Closest(corner, 0.1, objects_t()).IsSet(),
+    false);
+  EQUAL(objects[4]->GetTri().P0(),
+    image.GetSnapIndex().Closest(objects[4]->GetTri().P0(), 0.1,
+      objects_t()).Get());
+}
@@ -1,8 +1,12 @@
 // -*- coding: us-ascii-unix -*-
 #include "test-sys/test.hh"
+#include "tests/test-util/print-objects.hh"
 #include "bitmap/bitmap.hh"
 #include "bitmap/color.hh"
+#include "bitmap/draw.hh"
 #include "bitmap/filter.hh"
+#include "bitmap/gaussian-blur.hh"
+#include "geo/int-rect.hh"
 #include "tests/test-util/file-handling.hh"
 
 void test_unsharp_mask(){
@@ -12,4 +16,40 @@ void test_unsharp_mask(){
 
   // Verify that alpha is not lost
   VERIFY(translucent(get_color_raw(bmp, 0, 0)));
+
+  Bitmap src(IntSize(40, 90), Color(100, 100, 100));
+  fill_rect_color(src, IntRect(IntPoint(10, 20), IntSize(20, 50)),
+    Color(150, 200, 50));
+
+  {
+    // The banded blur matches gaussian_blur_fast, for any band height
+    auto blur_bands = [&](int bandHeight){
+      Bitmap dst(src.GetSize(), color_magenta);
+      gaussian_blur_fast_bands(src, 3.0, bandHeight,
+        [&](const Bitmap& band, int y){
+          EQUAL(band.m_w, src.m_w);
+          blit(offsat(band, 0, y), onto(dst));
+        });
+      return dst;
+    };
+    const Bitmap full(gaussian_blur_fast(src, 3.0));
+    VERIFY(blur_bands(src.m_h) == full);
+    VERIFY(blur_bands(1) == full);
+    VERIFY(blur_bands(7) == full);
+    VERIFY(blur_bands(64) == full);
+  }
+
+  {
+    // Edges are sharpened in both directions, uniform areas are kept
+    const Bitmap sharp(unsharp_mask(src, unsharp_mask_t(2.0, 1.5)));
+    EQUAL(get_color_raw(sharp, 20, 45), Color(150, 200, 50));
+    EQUAL(get_color_raw(sharp, 1, 1), Color(100, 100, 100));
+    const Color inside(get_color_raw(sharp, 10, 45));
+    const Color outside(get_color_raw(sharp, 9, 45));
+    VERIFY(inside.r > 150 && inside.g > 200 && inside.b < 50);
+    VERIFY(outside.r < 100 && outside.g < 100 && outside.b > 100);
+
+    // Differences below the threshold are not sharpened
+    VERIFY(unsharp_mask(src, unsharp_mask_t(2.0, 1.5, 255)) == src);
+  }
 }
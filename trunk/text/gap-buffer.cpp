@@ -0,0 +1,229 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <algorithm>
+#include <cassert>
+#include "text/char-constants.hh"
+#include "text/gap-buffer.hh"
+#include "text/utf8.hh"
+
+namespace faint{
+
+static const size_t min_gap = 64;
+
+const size_t GapBuffer::npos(utf8_string::npos);
+
+GapBuffer::GapBuffer()
+  : m_gapStart(0),
+    m_gapEnd(0)
+{}
+
+GapBuffer::GapBuffer(const utf8_string& text)
+  : GapBuffer()
+{
+  insert(0, text);
+}
+
+utf8_char GapBuffer::at(size_t pos) const{
+  assert(pos < size());
+  return pos < m_gapStart ?
+    m_chars[pos] :
+    m_chars[pos + (m_gapEnd - m_gapStart)];
+}
+
+void GapBuffer::clear(){
+  m_chars.clear();
+  m_gapStart = m_gapEnd = 0;
+  m_eolBeforeGap.clear();
+  m_eolAfterGap.clear();
+}
+
+bool GapBuffer::empty() const{
+  return size() == 0;
+}
+
+void GapBuffer::erase(size_t pos, size_t n){
+  assert(pos <= size());
+  const size_t oldSize = size();
+  n = std::min(n, oldSize - pos);
+  move_gap(pos);
+  m_gapEnd += n;
+
+  // Remove the indexed eols within the erased range. These are the
+  // eols closest to the gap.
+  const size_t endDist = oldSize - (pos + n);
+  while (!m_eolAfterGap.empty() && m_eolAfterGap.back() > endDist){
+    m_eolAfterGap.pop_back();
+  }
+}
+
+size_t GapBuffer::find(const utf8_char& ch, size_t start) const{
+  const size_t numChars = size();
+  if (start >= numChars){
+    return npos;
+  }
+
+  if (ch == eol){
+    auto it = std::lower_bound(begin(m_eolBeforeGap),
+      end(m_eolBeforeGap), start);
+    if (it != end(m_eolBeforeGap)){
+      return *it;
+    }
+
+    // The first eol after start is the one with the largest distance
+    // to the end not exceeding the distance of start.
+    auto after = std::upper_bound(begin(m_eolAfterGap),
+      end(m_eolAfterGap), numChars - start);
+    return after == begin(m_eolAfterGap) ?
+      npos : numChars - *(after - 1);
+  }
+
+  for (size_t i = start; i != numChars; i++){
+    if (at(i) == ch){
+      return i;
+    }
+  }
+  return npos;
+}
+
+size_t GapBuffer::rfind(const utf8_char& ch, size_t start) const{
+  const size_t numChars = size();
+  if (numChars == 0){
+    return npos;
+  }
+  const size_t last = std::min(start, numChars - 1);
+
+  if (ch == eol){
+    // The last eol before start is the one with the smallest distance
+    // to the end not less than the distance of start.
+    auto after = std::lower_bound(begin(m_eolAfterGap),
+      end(m_eolAfterGap), numChars - last);
+    if (after != end(m_eolAfterGap)){
+      return numChars - *after;
+    }
+
+    auto it = std::upper_bound(begin(m_eolBeforeGap),
+      end(m_eolBeforeGap), last);
+    return it == begin(m_eolBeforeGap) ?
+      npos : *(it - 1);
+  }
+
+  for (size_t i = last + 1; i != 0; i--){
+    if (at(i - 1) == ch){
+      return i - 1;
+    }
+  }
+  return npos;
+}
+
+void GapBuffer::insert(size_t pos, const utf8_char& ch){
+  assert(pos <= size());
+  move_gap(pos);
+  reserve_gap(1);
+  if (ch == eol){
+    m_eolBeforeGap.push_back(pos);
+  }
+  m_chars[m_gapStart++] = ch;
+}
+
+void GapBuffer::insert(size_t pos, const utf8_string& str){
+  assert(pos <= size());
+  move_gap(pos);
+  reserve_gap(str.size());
+
+  // Decode the bytes directly, indexing the utf8_string per character
+  // would be quadratic.
+  const std::string& bytes = str.str();
+  for (size_t i = 0; i < bytes.size();){
+    const size_t numBytes = utf8::prefix_num_bytes(bytes[i]);
+    const utf8_char ch(
+      utf8::byte_string_to_codepoint(bytes.substr(i, numBytes)));
+    if (ch == eol){
+      m_eolBeforeGap.push_back(m_gapStart);
+    }
+    m_chars[m_gapStart++] = ch;
+    i += numBytes;
+  }
+}
+
+size_t GapBuffer::size() const{
+  return m_chars.size() - (m_gapEnd - m_gapStart);
+}
+
+utf8_string GapBuffer::str() const{
+  return substr(0, size());
+}
+
+utf8_string GapBuffer::substr(size_t pos, size_t n) const{
+  assert(pos <= size());
+  const size_t last = std::min(size(), pos + std::min(n, size() - pos));
+  std::string bytes;
+  bytes.reserve(last - pos);
+  for (size_t i = pos; i != last; i++){
+    bytes += at(i).str();
+  }
+  return utf8_string(bytes);
+}
+
+void GapBuffer::move_gap(size_t pos){
+  const size_t numChars = size();
+  if (pos < m_gapStart){
+    // Move the characters in [pos, gapStart) to the end of the gap.
+    const size_t n = m_gapStart - pos;
+    std::copy_backward(begin(m_chars) + pos, begin(m_chars) + m_gapStart,
+      begin(m_chars) + m_gapEnd);
+    m_gapStart -= n;
+    m_gapEnd -= n;
+
+    while (!m_eolBeforeGap.empty() && m_eolBeforeGap.back() >= pos){
+      m_eolAfterGap.push_back(numChars - m_eolBeforeGap.back());
+      m_eolBeforeGap.pop_back();
+    }
+  }
+  else if (pos > m_gapStart){
+    // Move the characters in [gapEnd, gapEnd + n) to the start of the
+    // gap.
+    const size_t n = pos - m_gapStart;
+    std::copy(begin(m_chars) + m_gapEnd, begin(m_chars) + m_gapEnd + n,
+      begin(m_chars) + m_gapStart);
+    m_gapStart += n;
+    m_gapEnd += n;
+
+    while (!m_eolAfterGap.empty() && numChars - m_eolAfterGap.back() < pos){
+      m_eolBeforeGap.push_back(numChars - m_eolAfterGap.back());
+      m_eolAfterGap.pop_back();
+    }
+  }
+}
+
+void GapBuffer::reserve_gap(size_t n){
+  const size_t gapSize = m_gapEnd - m_gapStart;
+  if (gapSize >= n){
+    return;
+  }
+
+  const size_t numChars = size();
+  const size_t newGap = std::max(n, std::max(min_gap, numChars));
+  const size_t numAfter = m_chars.size() - m_gapEnd;
+
+  std::vector<utf8_char> chars(numChars + newGap, utf8_null);
+  std::copy(begin(m_chars), begin(m_chars) + m_gapStart, begin(chars));
+  std::copy(begin(m_chars) + m_gapEnd, end(m_chars),
+    end(chars) - numAfter);
+  m_chars.swap(chars);
+  m_gapEnd = m_gapStart + newGap;
+}
+
+} // namespace
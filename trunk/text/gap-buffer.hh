@@ -0,0 +1,76 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FAINT_GAP_BUFFER_HH
+#define FAINT_GAP_BUFFER_HH
+#include <vector>
+#include "text/utf8-string.hh"
+
+namespace faint{
+
+class GapBuffer{
+  // Character storage for the TextBuffer.
+  //
+  // Stores code points with a gap at the most recent edit position,
+  // so that consecutive inserts and deletes at the caret are
+  // (amortized) constant time, and indexing is constant time.
+  //
+  // The positions of the eol-characters are indexed, so that
+  // searching for line breaks (e.g. when moving the caret up or down)
+  // is logarithmic.
+public:
+  GapBuffer();
+  explicit GapBuffer(const utf8_string&);
+  utf8_char at(size_t) const;
+  void clear();
+  bool empty() const;
+  void erase(size_t pos, size_t n);
+
+  // Returns the position of the first occurence of the character at
+  // or after start, or npos.
+  size_t find(const utf8_char&, size_t start) const;
+
+  // Returns the position of the last occurence of the character at
+  // or before start, or npos.
+  size_t rfind(const utf8_char&, size_t start) const;
+  void insert(size_t pos, const utf8_char&);
+  void insert(size_t pos, const utf8_string&);
+  size_t size() const;
+  utf8_string str() const;
+  utf8_string substr(size_t pos, size_t n) const;
+
+  static const size_t npos;
+private:
+  void move_gap(size_t pos);
+  void reserve_gap(size_t n);
+
+  // The characters with the unused range [m_gapStart, m_gapEnd).
+  std::vector<utf8_char> m_chars;
+  size_t m_gapStart;
+  size_t m_gapEnd;
+
+  // Positions of the eol-characters before the gap, ascending.
+  std::vector<size_t> m_eolBeforeGap;
+
+  // Distances from the end of the text (size() - position) for the
+  // eol-characters after the gap, ascending, so that the eol closest
+  // to the gap is last. Expressed relative to the end, these are
+  // unaffected by edits at the gap.
+  std::vector<size_t> m_eolAfterGap;
+};
+
+} // namespace
+
+#endif
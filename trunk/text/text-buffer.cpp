@@ -42,7 +42,8 @@ bool CaretRange::operator!=(const CaretRange& other) const{
 }
 
 TextBuffer::TextBuffer()
-  : m_caret(0)
+  : m_caret(0),
+    m_textChanged(false)
 {
   m_sel.active = false;
   m_sel.origin = 0;
@@ -51,7 +52,9 @@ TextBuffer::TextBuffer()
 
 TextBuffer::TextBuffer(const utf8_string& text)
   : m_data(text),
-    m_caret(0)
+    m_caret(0),
+    m_text(text),
+    m_textChanged(false)
 {
   m_sel.active = false;
   m_sel.origin = 0;
@@ -73,7 +76,7 @@ CaretRange TextBuffer::all() const{
 
 utf8_char TextBuffer::at(size_t pos) const{
   assert(pos < m_data.size());
-  return m_data[pos];
+  return m_data.at(pos);
 }
 
 Caret TextBuffer::caret() const{
@@ -91,6 +94,7 @@ void TextBuffer::caret(Caret caret, bool select){
 
 void TextBuffer::clear(){
   m_data.clear();
+  m_textChanged = true;
   m_caret = 0;
   m_sel.active = false;
 }
@@ -102,6 +106,7 @@ void TextBuffer::del(){
   else {
     if (m_data.size() > m_caret){
       m_data.erase(m_caret,1);
+      m_textChanged = true;
     }
   }
 }
@@ -124,6 +129,7 @@ void TextBuffer::del_selection(){
     return;
   }
   m_data.erase(m_sel.min(), m_sel.num());
+  m_textChanged = true;
   m_caret = m_sel.min();
   m_sel.active = false;
   return;
@@ -147,7 +153,11 @@ bool TextBuffer::empty() const{
 }
 
 const utf8_string& TextBuffer::get() const{
-  return m_data;
+  if (m_textChanged){
+    m_text = m_data.str();
+    m_textChanged = false;
+  }
+  return m_text;
 }
 
 CaretRange TextBuffer::get_sel_range() const{
@@ -164,13 +174,15 @@ utf8_string TextBuffer::get_selection() const{
 
 void TextBuffer::insert(const utf8_char& c){
   del_selection();
-  m_data.insert(m_caret, 1, c);
+  m_data.insert(m_caret, c);
+  m_textChanged = true;
   m_caret+=1;
 }
 
 void TextBuffer::insert(const utf8_string& str){
   del_selection();
   m_data.insert(m_caret, str);
+  m_textChanged = true;
   m_caret += str.size();
 }
 
@@ -214,10 +226,11 @@ void TextBuffer::select(const CaretRange& range){
 
 
 void TextBuffer::set(const utf8_string& s){
-  m_data = s;
+  m_data = GapBuffer(s);
+  m_text = s;
+  m_textChanged = false;
   select_none();
   m_caret = std::min(m_caret, m_data.size());
-
 }
 
 size_t TextBuffer::size() const{
@@ -230,7 +243,7 @@ size_t TextBuffer::next(const utf8_char& c) const{
 
 size_t TextBuffer::next(const utf8_char& c, size_t pos) const{
   size_t found = m_data.find(c, pos);
-  if (found == utf8_string::npos){
+  if (found == GapBuffer::npos){
     return m_data.size();
   }
   return found;
@@ -242,7 +255,7 @@ size_t TextBuffer::prev(const utf8_char& c) const{
 
 size_t TextBuffer::prev(const utf8_char& c, size_t pos) const{
   size_t found = m_data.rfind(c, pos - 1);
-  if (found == utf8_string::npos){
+  if (found == GapBuffer::npos){
     return 0;
   }
   return found;
@@ -16,6 +16,7 @@
 #ifndef FAINT_TEXT_BUFFER_HH
 #define FAINT_TEXT_BUFFER_HH
 #include <algorithm>
+#include "text/gap-buffer.hh"
 #include "text/utf8-string.hh"
 
 namespace faint{
@@ -91,8 +92,12 @@ private:
     }
   } m_sel;
 
-  utf8_string m_data;
+  GapBuffer m_data;
   Caret m_caret;
+
+  // The text as a utf8_string, for get(). Updated lazily after edits.
+  mutable utf8_string m_text;
+  mutable bool m_textChanged;
 };
 
 // Finds the boundaries of the word encompassing the position
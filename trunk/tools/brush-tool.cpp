@@ -18,6 +18,7 @@
 #include "bitmap/alpha-map.hh"
 #include "bitmap/brush.hh"
 #include "bitmap/color.hh"
+#include "commands/brush-stroke-cmd.hh"
 #include "commands/command.hh"
 #include "geo/adjust.hh"
 #include "geo/geo-func.hh"
@@ -30,6 +31,7 @@
 #include "rendering/render-brush.hh"
 #include "text/formatting.hh"
 #include "tools/standard-tool.hh"
+#include "util/optional.hh"
 #include "util/pos-info.hh"
 #include "util/setting-util.hh"
 #include "util/tool-util.hh"
@@ -53,36 +55,6 @@ static bool translucent(const Brush& b){
   return false;
 }
 
-class BrushCommand : public Command{
-public:
-  BrushCommand(const UpperLeft& topLeft,
-    const AlphaMap& alphaMap,
-    const UpperLeft& first,
-    const Settings& settings)
-    : Command(CommandType::RASTER),
-      m_settings(settings),
-      m_alphaMap(alphaMap),
-      m_first(first.Get()),
-      m_topLeft(topLeft.Get())
-  {
-    finalize_swap_colors_erase_bg(m_settings);
-  }
-
-  utf8_string Name() const{
-    return "Brush Stroke";
-  }
-
-  void Do(CommandContext& context){
-    context.GetDC().Blend(m_alphaMap, m_topLeft, m_first, m_settings);
-  }
-
-private:
-  Settings m_settings;
-  AlphaMap m_alphaMap;
-  IntPoint m_first;
-  IntPoint m_topLeft;
-};
-
 static Settings brush_settings(const Settings& allSettings){
   Settings s;
   s.Set(ts_BrushSize, 1);
@@ -274,7 +246,7 @@ private:
       return ToolResult::NONE;
     }
 
-    m_command.Set(new BrushCommand(r.TopLeft(),
+    m_command.Set(brush_stroke_command(r.TopLeft(),
       m_alphaMap.SubCopy(r),
       m_first, maybe_offsat_paint(GetSettings(), m_brush)));
     return ToolResult::COMMIT;
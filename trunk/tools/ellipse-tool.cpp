@@ -82,7 +82,7 @@ public:
     m_active = true;
 
     if (info.modifiers.Primary()){
-      m_p0 = m_origP0 = snap(info.pos, info.canvas.GetObjects(),
+      m_p0 = m_origP0 = snap(info.pos, info.canvas.GetImage(), objects_t(),
         info.canvas.GetGrid());
     }
     else {
@@ -254,11 +254,12 @@ private:
   Point GetPos(const PosInfo& info, bool first){
     if (first){
       return info.modifiers.Primary() ?
-        snap(info.pos, info.canvas.GetObjects(), info.canvas.GetGrid()) :
+        snap(info.pos, info.canvas.GetImage(), objects_t(),
+          info.canvas.GetGrid()) :
         info.pos;
     }
     else if (info.modifiers.Primary()){
-      return snap(info.pos, info.canvas.GetObjects(),
+      return snap(info.pos, info.canvas.GetImage(), objects_t(),
         info.canvas.GetGrid());
     }
     else if (info.modifiers.Secondary() && m_points.size() > 1){
@@ -18,6 +18,7 @@
 #include "commands/command.hh"
 #include "geo/adjust.hh"
 #include "geo/geo-func.hh"
+#include "geo/geo-list-points.hh"
 #include "geo/int-rect.hh"
 #include "geo/int-size.hh"
 #include "geo/measure.hh"
@@ -27,6 +28,7 @@
 #include "text/formatting.hh"
 #include "tools/standard-tool.hh"
 #include "util/container-util.hh"
+#include "util/optional.hh"
 #include "util/setting-util.hh"
 #include "util/pos-info.hh"
 
@@ -46,6 +48,10 @@ public:
     context.GetDC().PenStroke(m_points, m_settings);
   }
 
+  Optional<IntRect> RasterBounds() const{
+    return option(inflated(bounding_rect(m_points), 1));
+  }
+
   utf8_string Name() const{
     return "Pen Stroke";
   }
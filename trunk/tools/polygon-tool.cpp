@@ -83,7 +83,7 @@ static std::vector<Point> get_point_intersections(const Points& in_points,
 }
 
 static Point polygon_snap(const Point& pos, Canvas& canvas, const Points& points){
-  return snap(pos, canvas.GetObjects(), canvas.GetGrid(),
+  return snap(pos, canvas.GetImage(), objects_t(), canvas.GetGrid(),
     get_point_intersections(points, points.Size() - 1));
 }
 
@@ -34,10 +34,10 @@ namespace faint{
 
 static Point snap_p1(const Point& p0,
   const Point& p1,
-  const objects_t& objects,
+  const Image& image,
   const Grid& grid)
 {
-  const Point snapped = snap(p1, objects, grid);
+  const Point snapped = snap(p1, image, objects_t(), grid);
   // Do not snap to points on the rectangle start point
   return snapped == p0 ? p1 : snapped;
 }
@@ -48,7 +48,7 @@ static Point adjust_p1(const Point& p0, const PosInfo& info, bool subPixel){
     return constrain_to_square(p0, p1, subPixel);
   }
   else if (info.modifiers.Primary()){
-    return snap_p1(p0, p1, info.canvas.GetObjects(), info.canvas.GetGrid());
+    return snap_p1(p0, p1, info.canvas.GetImage(), info.canvas.GetGrid());
   }
   return info.pos;
 }
@@ -93,7 +93,8 @@ public:
     SetAntiAlias(info);
     SetSwapColors(info.modifiers.RightMouse());
     m_p0 = info.modifiers.Primary() ?
-      snap(info.pos, info.canvas.GetObjects(), info.canvas.GetGrid()) :
+      snap(info.pos, info.canvas.GetImage(), objects_t(),
+        info.canvas.GetGrid()) :
       info.pos;
     m_p1 = info.pos;
     return ToolResult::NONE;
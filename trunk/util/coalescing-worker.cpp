@@ -0,0 +1,85 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include "util/coalescing-worker.hh"
+
+namespace faint{
+
+CoalescingWorker::CoalescingWorker()
+  : m_generation(0),
+    m_quit(false)
+{}
+
+CoalescingWorker::~CoalescingWorker(){
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_quit = true;
+    m_pending = nullptr;
+    m_generation++;
+  }
+  m_condition.notify_one();
+  if (m_thread.joinable()){
+    m_thread.join();
+  }
+}
+
+void CoalescingWorker::Cancel(){
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_pending = nullptr;
+  m_generation++;
+}
+
+unsigned int CoalescingWorker::Generation() const{
+  return m_generation;
+}
+
+unsigned int CoalescingWorker::Post(const job_t& job){
+  unsigned int generation = 0;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending = job;
+    generation = ++m_generation;
+    if (!m_thread.joinable()){
+      // Started on the first job, so that unused workers are cheap.
+      m_thread = std::thread([this](){Run();});
+    }
+  }
+  m_condition.notify_one();
+  return generation;
+}
+
+void CoalescingWorker::Run(){
+  for (;;){
+    job_t job;
+    unsigned int generation = 0;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition.wait(lock, [this](){
+        return m_quit || m_pending != nullptr;
+      });
+      if (m_quit){
+        return;
+      }
+      job.swap(m_pending);
+      generation = m_generation;
+    }
+
+    job([this, generation](){
+      return m_generation != generation;
+    });
+  }
+}
+
+} // namespace
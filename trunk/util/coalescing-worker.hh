@@ -0,0 +1,69 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FAINT_COALESCING_WORKER_HH
+#define FAINT_COALESCING_WORKER_HH
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace faint{
+
+class CoalescingWorker{
+  // Runs jobs on a single worker thread, keeping only the most
+  // recently posted job.
+  //
+  // A job which is superseded by a newer one before it starts is
+  // dropped. A running job can poll the is_cancelled-function it is
+  // passed to stop early once a newer job is posted.
+public:
+  using is_cancelled_t = std::function<bool()>;
+  using job_t = std::function<void(const is_cancelled_t&)>;
+
+  CoalescingWorker();
+
+  // Cancels any running job and waits for the thread to finish.
+  ~CoalescingWorker();
+
+  // Cancels any pending or running job.
+  void Cancel();
+
+  // Returns the generation of the most recently posted (or
+  // cancelled) job. A job's results are stale unless its generation
+  // is still the current.
+  unsigned int Generation() const;
+
+  // Replaces the pending job, and cancels the running one. Returns
+  // the generation of the posted job.
+  unsigned int Post(const job_t&);
+
+  CoalescingWorker(const CoalescingWorker&) = delete;
+  CoalescingWorker& operator=(const CoalescingWorker&) = delete;
+private:
+  void Run();
+
+  std::condition_variable m_condition;
+  std::atomic<unsigned int> m_generation;
+  std::mutex m_mutex;
+  job_t m_pending;
+  bool m_quit;
+  std::thread m_thread;
+};
+
+} // namespace
+
+#endif
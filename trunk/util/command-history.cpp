@@ -14,7 +14,9 @@
 // permissions and limitations under the License.
 
 #include <cassert>
+#include "bitmap/bitmap.hh"
 #include "commands/command.hh"
+#include "commands/raster-delta.hh"
 #include "geo/canvas-geo.hh"
 #include "geo/geo-func.hh"
 #include "gui/canvas-panel-contexts.hh"
@@ -33,6 +35,29 @@ static void clear_list(std::deque<OldCommand>& list){
   list.clear();
 }
 
+static void undo_raster(const OldCommand& undone,
+  TargetableCommandContext& cmdContext,
+  const std::deque<OldCommand>& undoList)
+{
+  // Undoes the raster changes of the undone command, which must be
+  // last in the undo list.
+  if (undone.delta != nullptr){
+    // Restore the pixels modified by the command
+    undone.delta->Restore(cmdContext.GetRawBitmap());
+    return;
+  }
+
+  // Reset the image and reapply the raster steps of all commands to
+  // undo the irreversible changes of the undone command.
+  // Fixme: This is extremely wasteful with multiple commands
+  cmdContext.RevertFrame();
+  for (auto item : but_last(undoList)){
+    if (item.targetFrame == undone.targetFrame){
+      item.command->DoRaster(cmdContext);
+    }
+  }
+}
+
 static utf8_string get_command_name(Command& cmd,
   const Image& targetFrame,
   const ImageList& frames)
@@ -108,6 +133,16 @@ void CommandHistory::CloseUndoBundle(const utf8_string& name){
   return no_option();
 }
 
+size_t CommandHistory::GetRasterDeltaBytes() const{
+  size_t bytes = 0;
+  for (const OldCommand& item : m_undoList){
+    if (item.delta != nullptr){
+      bytes += item.delta->GetByteCount();
+    }
+  }
+  return bytes;
+}
+
 bool CommandHistory::Bundling() const{
   return m_openBundle;
 }
@@ -198,20 +233,13 @@ bool CommandHistory::Undo(TargetableCommandContext& cmdContext,
         if (somewhat_reversible(undoType)){
           // Reverse undoable changes
           undone.command->Undo(cmdContext);
+          undone.targetFrame->NotifyObjectsModified();
         }
         if (!fully_reversible(undoType)){
-          // Reset the image and reapply the raster steps of all commands to
-          // undo the irreversible changes of the undone command.
-          // Fixme: This is extremely wasteful with multiple commands
-          cmdContext.RevertFrame();
-          for (auto item : but_last(m_undoList)){
-            if (item.targetFrame == undone.targetFrame){
-              Command& reapplied = *item.command;
-              reapplied.DoRaster(cmdContext);
-            }
-          }
+          undo_raster(undone, cmdContext, m_undoList);
         }
       }
+      undone.delta.reset();
       m_undoList.pop_back();
       m_redoList.push_front(undone);
     } while (undone.type == UndoType::NORMAL_COMMAND);
@@ -228,17 +256,10 @@ bool CommandHistory::Undo(TargetableCommandContext& cmdContext,
   if (somewhat_reversible(undoType)){
     // Reverse undoable changes
     undone.command->Undo(cmdContext);
+    activeImage->NotifyObjectsModified();
   }
   if (!fully_reversible(undoType)){
-    // Reset the image and reapply the raster steps of all commands to
-    // undo the irreversible changes of the undone command.
-    cmdContext.RevertFrame();
-    for (auto item : but_last(m_undoList)){
-      if (item.targetFrame == activeImage){
-        Command* reapplied = item.command;
-        reapplied->DoRaster(cmdContext);
-      }
-    }
+    undo_raster(undone, cmdContext, m_undoList);
     if (oldSize != activeImage->GetSize()){
       Point pos(geo.pos.x, geo.pos.y);
       coord zoom = geo.zoom.GetScaleFactor();
@@ -247,6 +268,7 @@ bool CommandHistory::Undo(TargetableCommandContext& cmdContext,
     }
   }
 
+  undone.delta.reset();
   m_undoList.pop_back();
   m_redoList.push_front(undone);
   return true;
@@ -308,9 +330,24 @@ Optional<IntPoint> CommandHistory::Apply(Command* cmd,
     }
   }
 
+  // Store the pixels the command will modify, if known, so that it
+  // can be undone without reapplying earlier commands.
+  std::shared_ptr<const RasterDelta> delta;
+  if (affects_raster(cmd)){
+    cmd->RasterBounds().Visit(
+      [&](const IntRect& bounds){
+        delta = std::make_shared<const RasterDelta>(
+          commandContext.GetBitmap(), bounds);
+      });
+  }
+
   IntSize oldSize(activeImage->GetSize());
   Optional<IntPoint> offset;
   cmd->Do(commandContext);
+  if (somewhat_reversible(cmd->Type())){
+    // The command may have modified objects
+    activeImage->NotifyObjectsModified();
+  }
   if (oldSize != activeImage->GetSize()){
     if (targetCurrentFrame){
       Point pos(geo.pos.x, geo.pos.y); // Fixme: geo should have an IntPoint
@@ -326,17 +363,18 @@ Optional<IntPoint> CommandHistory::Apply(Command* cmd,
     clear_list(m_redoList);
   }
 
+  OldCommand mappedCmd(cmd, activeImage);
+  mappedCmd.delta = delta;
   if (Bundling()){
-    m_undoList.push_back(OldCommand(cmd, activeImage));
+    m_undoList.push_back(mappedCmd);
   }
   else{
-    OldCommand mappedCmd(cmd, activeImage);
     bool merged = !m_undoList.empty() && m_undoList.back().Merge(mappedCmd);
     if (merged){
       cmd = nullptr;
     }
     else{
-      m_undoList.push_back(OldCommand(cmd, activeImage));
+      m_undoList.push_back(mappedCmd);
     }
   }
   return offset;
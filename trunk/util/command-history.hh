@@ -59,6 +59,10 @@ public:
   // unset Optional if there's no modifying command in the list)
   Optional<CommandId> GetLastModifying() const;
 
+  // The number of bytes used for the pixels stored for undoing raster
+  // commands.
+  size_t GetRasterDeltaBytes() const;
+
   void Redo(TargetableCommandContext&, const CanvasGeo&, ImageList&);
   bool Undo(TargetableCommandContext&, const CanvasGeo&);
 private:
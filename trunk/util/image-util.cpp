@@ -16,10 +16,14 @@
 #include <algorithm>
 #include <cassert>
 #include <memory>
+#include "geo/geo-func.hh"
+#include "geo/int-rect.hh"
 #include "objects/object.hh"
 #include "rendering/faint-dc.hh"
 #include "util/command-util.hh"
+#include "util/image-util.hh"
 #include "util/image.hh"
+#include "util/object-util.hh"
 
 namespace faint{
 
@@ -66,31 +70,47 @@ Bitmap subbitmap(const Image& image, const IntRect& rect){
 }
 
 static void flatten_onto(Bitmap& bmp,
+  const IntRect& region,
   const objects_t& objects,
   const RasterSelection& selection,
   ExpressionContext& ctx)
 {
-  FaintDC dc(bmp);
+  FaintDC dc(bmp, origin_t(-floated(region.TopLeft())));
   selection.DrawFloating(dc);
   for (Object* obj : objects){
-    obj->Draw(dc, ctx);
+    if (!empty(intersection(get_drawn_rect(obj), region))){
+      obj->Draw(dc, ctx);
+    }
   }
 }
 
 Bitmap flatten(const Image& image){
-  const objects_t& objects = image.GetObjects();
-  const RasterSelection& selection = image.GetRasterSelection();
-  return image.GetBackground().Visit(
-    [&](const Bitmap& bmp){
-      Bitmap copy(bmp);
-      flatten_onto(copy, objects, selection, image.GetExpressionContext());
-      return copy;
-    },
-    [&](const ColorSpan& span){
-      Bitmap bmp(span.size, span.color);
-      flatten_onto(bmp, objects, selection, image.GetExpressionContext());
-      return bmp;
-    });
+  return flatten(image, image_rect(image));
+}
+
+Bitmap flatten(const Image& image, const IntRect& rect){
+  const IntRect region(intersection(rect, image_rect(image)));
+  assert(!empty(region));
+  Bitmap bmp(subbitmap(image, region));
+  flatten_onto(bmp, region, image.GetObjects(), image.GetRasterSelection(),
+    image.GetExpressionContext());
+  return bmp;
+}
+
+void flatten_bands(const Image& image,
+  int bandHeight,
+  BandOrder order,
+  const band_sink_t& sink)
+{
+  assert(bandHeight > 0);
+  const IntSize size(image.GetSize());
+  const int numBands = (size.h + bandHeight - 1) / bandHeight;
+  for (int i = 0; i != numBands; i++){
+    const int band = order == BandOrder::TOP_DOWN ? i : numBands - i - 1;
+    const int y = band * bandHeight;
+    const int h = std::min(bandHeight, size.h - y);
+    sink(flatten(image, IntRect(IntPoint(0, y), IntSize(size.w, h))), y);
+  }
 }
 
 int get_highest_z(const Image& image){
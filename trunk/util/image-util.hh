@@ -15,6 +15,7 @@
 
 #ifndef FAINT_IMAGE_UTIL_HH
 #define FAINT_IMAGE_UTIL_HH
+#include <functional>
 #include "util/common-fwd.hh"
 
 namespace faint{
@@ -48,6 +49,26 @@ Bitmap stamp_raster_selection(const Image&);
 // when saving to raster formats.
 Bitmap flatten(const Image&);
 
+// Returns the flattened image within the rectangle, which must
+// intersect the image. Only the objects intersecting the rectangle
+// are drawn.
+Bitmap flatten(const Image&, const IntRect&);
+
+enum class BandOrder{
+  TOP_DOWN,
+  BOTTOM_UP
+};
+
+// Receives a band of the flattened image, and the y-coordinate of the
+// top row of the band.
+using band_sink_t = std::function<void(const Bitmap&, int)>;
+
+// Flattens the image in full-width bands of at most bandHeight rows,
+// passing them to the sink one at a time. Requires memory for a band
+// rather than for the entire image.
+void flatten_bands(const Image&, int bandHeight, BandOrder,
+  const band_sink_t&);
+
 // Gets the highest Z-value in the image (the front-most object).
 // Asserts that the image has objects.
 int get_highest_z(const Image&);
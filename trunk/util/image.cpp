@@ -62,7 +62,7 @@ public:
   }
 
   const Object* GetObject(const utf8_string& name) const override{
-    return get_by_name(m_image->GetObjects(), name);
+    return m_image->FindObject(name);
   }
 
 private:
@@ -76,8 +76,11 @@ Image::Image(FrameProps&& props)
     m_hotSpot(props.GetHotSpot()),
     m_objects(props.TakeObjects()),
     m_original(),
-    m_originalObjects(m_objects)
+    m_originalObjects(m_objects),
+    m_snapIndexValid(false),
+    m_namesValid(false)
 {
+  IndexObjects();
   m_expressionContext = new ImageExpressionContext(this);
 }
 
@@ -85,15 +88,20 @@ Image::Image(const Image& other)
   : m_bg(other.m_bg),
     m_delay(other.GetDelay()),
     m_hotSpot(other.m_hotSpot),
-    m_original()
+    m_original(),
+    m_snapIndexValid(false),
+    m_namesValid(false)
 {
   m_originalObjects = m_objects = clone(other.GetObjects());
+  IndexObjects();
   m_expressionContext = new ImageExpressionContext(this);
 }
 
 Image::Image()
   : m_bg(ColorSpan(color_white, IntSize(1,1))),
-    m_delay(0)
+    m_delay(0),
+    m_snapIndexValid(false),
+    m_namesValid(false)
 {
   m_expressionContext = new ImageExpressionContext(this);
 }
@@ -156,9 +164,47 @@ IntSize Image::GetSize() const{
     });
 }
 
+static void add_ids(const Object* object, std::unordered_multiset<int>& ids){
+  ids.insert(object->GetId().Raw());
+  const int numObjects = object->GetObjectCount();
+  for (int i = 0; i != numObjects; i++){
+    add_ids(object->GetObject(i), ids);
+  }
+}
+
+static void remove_ids(const Object* object,
+  std::unordered_multiset<int>& ids)
+{
+  auto it = ids.find(object->GetId().Raw());
+  assert(it != ids.end());
+  ids.erase(it);
+  const int numObjects = object->GetObjectCount();
+  for (int i = 0; i != numObjects; i++){
+    remove_ids(object->GetObject(i), ids);
+  }
+}
+
+static void add_names(Object* object,
+  std::unordered_map<std::string, Object*>& names)
+{
+  // Keeps the first object for each name, so that the lookup matches
+  // a depth first search in z-order.
+  object->GetName().Visit(
+    [&](const utf8_string& name){
+      names.insert(std::make_pair(name.str(), object));
+    });
+  const int numObjects = object->GetObjectCount();
+  for (int i = 0; i != numObjects; i++){
+    add_names(object->GetObject(i), names);
+  }
+}
+
 void Image::Add(Object* object){
   assert(!Has(object));
   m_objects.push_back(object);
+  m_objectZ[object] = m_objects.size() - 1;
+  add_ids(object, m_objectIds);
+  NotifyObjectsModified();
 }
 
 void Image::Add(Object* object, int z){
@@ -166,6 +212,9 @@ void Image::Add(Object* object, int z){
   assert(z >= 0);
   assert(to_size_t(z) <= m_objects.size());
   m_objects.insert(begin(m_objects) + z, object);
+  RenumberObjects(to_size_t(z), m_objects.size());
+  add_ids(object, m_objectIds);
+  NotifyObjectsModified();
 }
 
 bool Image::Deselect(const Object* object){
@@ -192,14 +241,30 @@ const objects_t& Image::GetObjectSelection() const{
   return m_objectSelection;
 }
 
-int Image::GetObjectZ(const Object* obj) const{
-  for (size_t i = 0; i != m_objects.size(); i++){
-    if (m_objects[i] == obj){
-      return resigned(i);
+Object* Image::FindObject(const utf8_string& name) const{
+  if (!m_namesValid){
+    m_names.clear();
+    for (Object* obj : m_objects){
+      add_names(obj, m_names);
     }
+    m_namesValid = true;
+  }
+  auto it = m_names.find(name.str());
+  return it == m_names.end() ? nullptr : it->second;
+}
+
+int Image::GetObjectZ(const Object* obj) const{
+  auto it = m_objectZ.find(obj);
+  assert(it != m_objectZ.end());
+  return it == m_objectZ.end() ? 0 : resigned(it->second);
+}
+
+const SnapIndex& Image::GetSnapIndex() const{
+  if (!m_snapIndexValid){
+    m_snapIndex = SnapIndex(m_objects);
+    m_snapIndexValid = true;
   }
-  assert(false);
-  return 0;
+  return m_snapIndex;
 }
 
 RasterSelection& Image::GetRasterSelection(){
@@ -224,20 +289,56 @@ void Image::SetCalibration(const Optional<Calibration>& c){
 }
 
 void Image::SetObjectZ(Object* obj, int z){
-  bool wasSelected = contains(m_objectSelection, obj);
-  Remove(obj);
-  z = std::min(z, resigned(m_objects.size()));
-  m_objects.insert(begin(m_objects) + z, obj);
+  assert(z >= 0);
+  bool wasSelected = remove(obj, from(m_objectSelection));
+
+  // Move the object by rotating the objects between the old and new
+  // position, so that only those need renumbering.
+  const size_t oldZ = to_size_t(GetObjectZ(obj));
+  const size_t newZ = std::min(to_size_t(z), m_objects.size() - 1);
+  const auto first = begin(m_objects);
+  if (oldZ < newZ){
+    std::rotate(first + resigned(oldZ), first + resigned(oldZ + 1),
+      first + resigned(newZ + 1));
+  }
+  else{
+    std::rotate(first + resigned(newZ), first + resigned(oldZ),
+      first + resigned(oldZ + 1));
+  }
+  RenumberObjects(std::min(oldZ, newZ), std::max(oldZ, newZ) + 1);
+
   if (wasSelected){
     size_t pos = get_sorted_insertion_pos(obj, m_objectSelection, m_objects);
     m_objectSelection.insert(begin(m_objectSelection) + resigned(pos), obj);
   }
+  NotifyObjectsModified();
 }
 
 void Image::Remove(Object* obj){
   remove(obj, from(m_objectSelection));
-  bool removed = remove(obj, from(m_objects));
-  assert(removed);
+  auto it = m_objectZ.find(obj);
+  assert(it != m_objectZ.end());
+  const size_t z = it->second;
+  m_objectZ.erase(it);
+  m_objects.erase(begin(m_objects) + resigned(z));
+  RenumberObjects(z, m_objects.size());
+  remove_ids(obj, m_objectIds);
+  NotifyObjectsModified();
+}
+
+void Image::IndexObjects(){
+  m_objectZ.clear();
+  m_objectIds.clear();
+  RenumberObjects(0, m_objects.size());
+  for (const Object* obj : m_objects){
+    add_ids(obj, m_objectIds);
+  }
+}
+
+void Image::RenumberObjects(size_t first, size_t last){
+  for (size_t i = first; i != last; i++){
+    m_objectZ[m_objects[i]] = i;
+  }
 }
 
 int Image::GetNumObjects() const{
@@ -245,16 +346,16 @@ int Image::GetNumObjects() const{
 }
 
 bool Image::Has(const ObjectId& objId) const{
-  for (const Object* obj : m_objects){
-    if (is_or_has(obj, objId)){
-      return true;
-    }
-  }
-  return false;
+  return m_objectIds.count(objId.Raw()) != 0;
 }
 
 bool Image::Has(const Object* obj) const{
-  return contains(m_objects, obj);
+  return m_objectZ.count(obj) != 0;
+}
+
+void Image::NotifyObjectsModified(){
+  m_snapIndexValid = false;
+  m_namesValid = false;
 }
 
 void Image::Revert(){
@@ -15,6 +15,9 @@
 
 #ifndef FAINT_IMAGE_HH
 #define FAINT_IMAGE_HH
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "bitmap/bitmap.hh"
 #include "geo/calibration.hh"
@@ -26,6 +29,7 @@
 #include "util/id-types.hh"
 #include "util/optional.hh"
 #include "util/raster-selection.hh"
+#include "util/snap-index.hh"
 
 namespace faint {
 
@@ -58,6 +62,10 @@ public:
   // The time to remain on this image if saved as an animation.
   Delay GetDelay() const;
 
+  // Returns the first object with the given name, including objects
+  // within groups, or nullptr.
+  Object* FindObject(const utf8_string& name) const;
+
   ExpressionContext& GetExpressionContext() const;
   HotSpot GetHotSpot() const;
   FrameId GetId() const;
@@ -70,9 +78,18 @@ public:
   const Optional<Calibration>& GetCalibration() const;
   const RasterSelection& GetRasterSelection() const;
   IntSize GetSize() const;
+
+  // Returns an index of the attach points of the objects, rebuilt if
+  // the objects have changed since the last call.
+  const SnapIndex& GetSnapIndex() const;
   bool Has(const ObjectId&) const;
   bool Has(const Object*) const;
   bool HasStoredOriginal() const;
+
+  // Must be called when objects have been modified (e.g. moved or
+  // renamed) by other means than the Image-functions, so that the
+  // SnapIndex and name lookup are rebuilt.
+  void NotifyObjectsModified();
   void Remove(Object*);
   void Revert();
 
@@ -101,6 +118,11 @@ public:
 
   Image& operator=(const Image&) = delete;
 private:
+  void IndexObjects();
+  // Updates the z-index for the objects in [first, last), after they
+  // were shifted.
+  void RenumberObjects(size_t first, size_t last);
+
   Either<Bitmap, ColorSpan> m_bg;
   Optional<Calibration> m_calibration;
   Delay m_delay;
@@ -112,6 +134,18 @@ private:
   Optional<Either<Bitmap, ColorSpan> > m_original;
   objects_t m_originalObjects;
   RasterSelection m_rasterSelection;
+  mutable SnapIndex m_snapIndex;
+  mutable bool m_snapIndexValid;
+
+  // The z-position of each object in m_objects
+  std::unordered_map<const Object*, size_t> m_objectZ;
+
+  // The raw ids of the objects and the objects within groups
+  std::unordered_multiset<int> m_objectIds;
+
+  // The first object for each name, built on demand
+  mutable std::unordered_map<std::string, Object*> m_names;
+  mutable bool m_namesValid;
 };
 
 // Rectangle with the same size as the image, anchored at 0,0
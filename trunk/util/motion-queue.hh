@@ -0,0 +1,64 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FAINT_MOTION_QUEUE_HH
+#define FAINT_MOTION_QUEUE_HH
+#include "geo/canvas-geo.hh"
+#include "geo/int-point.hh"
+#include "util/pos-info.hh"
+#include "util/ring-buffer.hh"
+
+namespace faint{
+
+class MotionSample{
+  // A mouse position from a motion event, with the view geometry at
+  // the time of the event.
+public:
+  IntPoint pos; // In view coordinates
+  ToolModifiers modifiers;
+  CanvasGeo geo;
+};
+
+class MotionQueue{
+  // Mouse positions from motion events, forwarded to the tool in one
+  // batch when the event queue has been processed, so that fast input
+  // is painted once instead of for every position.
+  //
+  // Each position is kept with the geometry it was received with, so
+  // that scrolling or zooming before the batch is forwarded (e.g. by
+  // the mouse wheel) does not move the positions on the image.
+public:
+  // Adds the position, unless the queue is full. Returns false if the
+  // position was not added.
+  bool Push(const IntPoint& viewPos, const ToolModifiers& modifiers,
+    const CanvasGeo& geo)
+  {
+    return m_samples.Push({viewPos, modifiers, geo});
+  }
+
+  // Calls func with each queued MotionSample, in order, and removes
+  // them. Like RingBuffer::Drain, func may drain the queue itself.
+  template<typename FUNC>
+  size_t Drain(const FUNC& func){
+    return m_samples.Drain(func);
+  }
+
+private:
+  RingBuffer<MotionSample, 1024> m_samples;
+};
+
+} // namespace
+
+#endif
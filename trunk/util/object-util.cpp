@@ -15,6 +15,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <memory>
 #include "bitmap/paint.hh"
 #include "bitmap/pattern.hh"
 #include "geo/geo-func.hh"
@@ -26,9 +27,11 @@
 #include "objects/objraster.hh"
 #include "objects/objtext.hh"
 #include "rendering/faint-dc.hh"
+#include "rendering/filter-class.hh"
 #include "text/utf8-string.hh"
 #include "util/default-settings.hh"
 #include "util/grid.hh"
+#include "util/image.hh"
 #include "util/iter.hh"
 #include "util/math-constants.hh"
 #include "util/object-util.hh"
@@ -186,6 +189,12 @@ utf8_string get_collective_type(const objects_t& objects){
   return first + "s"; // Naive plural
 }
 
+IntRect get_drawn_rect(const Object* obj){
+  const IntRect r(inflated(obj->GetRefreshRect(), 1));
+  std::unique_ptr<Filter> f(get_filter(obj->GetSettings()));
+  return f == nullptr ? r : padded(r, f->GetPadding());
+}
+
 objects_t get_groups(const objects_t& objects){
   objects_t groups;
   for (Object* obj : objects){
@@ -373,6 +382,63 @@ ColorSetting setting_used_for_fill(const Object* obj){
 }
 
 const coord g_maxSnapDistance = 20.0;
+static Point snap_grid_and_extra(const Point& sourcePt,
+  const Point& objectPt,
+  coord lastSnapDistance,
+  const Grid& grid,
+  const std::vector<Point>& extraPoints)
+{
+  Point currentPt(objectPt);
+  if (grid.Enabled()){
+    Point gridPoint = grid.Snap(sourcePt);
+    coord snapDistance = distance(sourcePt, gridPoint);
+    if (snapDistance < lastSnapDistance){
+      lastSnapDistance = snapDistance;
+      currentPt = gridPoint;
+    }
+  }
+
+  for (const Point& pt : extraPoints){
+    coord snapDistance = distance(sourcePt, pt);
+    if (snapDistance < lastSnapDistance){
+      // Snap to this closer point instead
+      lastSnapDistance = snapDistance;
+      currentPt = pt;
+    }
+  }
+  return currentPt;
+}
+
+static coord snap_grid_x(coord sourceX,
+  coord objectX,
+  coord lastSnapDistance,
+  const Grid& grid)
+{
+  if (grid.Enabled()){
+    Point gridPoint = grid.Snap(Point(sourceX, 0));
+    coord snapDistance = std::fabs(sourceX - gridPoint.x);
+    if (snapDistance < lastSnapDistance){
+      return gridPoint.x;
+    }
+  }
+  return objectX;
+}
+
+static coord snap_grid_y(coord sourceY,
+  coord objectY,
+  coord lastSnapDistance,
+  const Grid& grid)
+{
+  if (grid.Enabled()){
+    Point gridPoint = grid.Snap(Point(0, sourceY));
+    coord snapDistance = std::fabs(sourceY - gridPoint.y);
+    if (snapDistance < lastSnapDistance){
+      return gridPoint.y;
+    }
+  }
+  return objectY;
+}
+
 Point snap(const Point& sourcePt,
   const objects_t& objects,
   const Grid& grid,
@@ -400,25 +466,39 @@ Point snap(const Point& sourcePt,
       }
     }
   }
+  return snap_grid_and_extra(sourcePt, currentPt, lastSnapDistance, grid,
+    extraPoints);
+}
 
-  if (grid.Enabled()){
-    Point gridPoint = grid.Snap(sourcePt);
-    coord snapDistance = distance(sourcePt, gridPoint);
-    if (snapDistance < lastSnapDistance){
-      lastSnapDistance = snapDistance;
-      currentPt = gridPoint;
-    }
-  }
+Point snap(const Point& sourcePt,
+  const Image& image,
+  const objects_t& ignored,
+  const Grid& grid,
+  coord maxSnapDistance)
+{
+  std::vector<Point> noExtraPoints;
+  return snap(sourcePt, image, ignored, grid, noExtraPoints,
+    maxSnapDistance);
+}
 
-  for (const Point& pt : extraPoints){
-    coord snapDistance = distance(sourcePt, pt);
-    if (snapDistance < lastSnapDistance){
-      // Snap to this closer point instead
-      lastSnapDistance = snapDistance;
-      currentPt = pt;
-    }
-  }
-  return currentPt;
+Point snap(const Point& sourcePt,
+  const Image& image,
+  const objects_t& ignored,
+  const Grid& grid,
+  const std::vector<Point>& extraPoints,
+  coord maxSnapDistance)
+{
+  Optional<Point> objectPt = image.GetSnapIndex().Closest(sourcePt,
+    maxSnapDistance, ignored);
+  return objectPt.Visit(
+    [&](const Point& pt){
+      return snap_grid_and_extra(sourcePt, pt, distance(sourcePt, pt),
+        grid, extraPoints);
+    },
+    [&](){
+      return snap_grid_and_extra(sourcePt, sourcePt, maxSnapDistance,
+        grid, extraPoints);
+    });
 }
 
 coord snap_x(coord sourceX,
@@ -442,15 +522,26 @@ coord snap_x(coord sourceX,
       }
     }
   }
+  return snap_grid_x(sourceX, current, lastSnapDistance, grid);
+}
 
-  if (grid.Enabled()){
-    Point gridPoint = grid.Snap(Point(sourceX, 0));
-    coord snapDistance = std::fabs(sourceX - gridPoint.x);
-    if (snapDistance < lastSnapDistance){
-      current = gridPoint.x;
-    }
-  }
-  return current;
+coord snap_x(coord sourceX,
+  const Image& image,
+  const objects_t& ignored,
+  const Grid& grid,
+  coord y0,
+  coord y1,
+  coord maxSnapDistance)
+{
+  Optional<coord> objectX = image.GetSnapIndex().ClosestX(sourceX, y0, y1,
+    maxSnapDistance, ignored);
+  return objectX.Visit(
+    [&](coord x){
+      return snap_grid_x(sourceX, x, std::fabs(x - sourceX), grid);
+    },
+    [&](){
+      return snap_grid_x(sourceX, sourceX, maxSnapDistance, grid);
+    });
 }
 
 coord snap_y(coord sourceY,
@@ -474,14 +565,26 @@ coord snap_y(coord sourceY,
       }
     }
   }
-  if (grid.Enabled()){
-    Point gridPoint = grid.Snap(Point(0, sourceY));
-    coord snapDistance = fabs(sourceY - gridPoint.y);
-    if (snapDistance < lastSnapDistance){
-      current = gridPoint.y;
-    }
-  }
-  return current;
+  return snap_grid_y(sourceY, current, lastSnapDistance, grid);
+}
+
+coord snap_y(coord sourceY,
+  const Image& image,
+  const objects_t& ignored,
+  const Grid& grid,
+  coord x0,
+  coord x1,
+  coord maxSnapDistance)
+{
+  Optional<coord> objectY = image.GetSnapIndex().ClosestY(sourceY, x0, x1,
+    maxSnapDistance, ignored);
+  return objectY.Visit(
+    [&](coord y){
+      return snap_grid_y(sourceY, y, std::fabs(y - sourceY), grid);
+    },
+    [&](){
+      return snap_grid_y(sourceY, sourceY, maxSnapDistance, grid);
+    });
 }
 
 bool supports_object_aligned_resize(Object* object){
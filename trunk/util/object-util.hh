@@ -25,6 +25,8 @@ namespace faint{
 class Color;
 class ExpressionContext;
 class Grid;
+class Image;
+class IntRect;
 class ObjRaster;
 class Point;
 class Rect;
@@ -66,6 +68,11 @@ Object* get_by_name(Object*, const utf8_string& name);
 // within groups.
 Object* get_by_name(const objects_t&, const utf8_string& name);
 
+// Returns the refresh rectangle of the object, padded for its filter
+// (e.g. a shadow) and by a pixel for antialiasing, i.e. a bound for
+// the pixels drawing the object can change.
+IntRect get_drawn_rect(const Object*);
+
 objects_t get_groups(const objects_t&);
 objects_t get_intersected(const objects_t&, const Rect&);
 
@@ -126,6 +133,22 @@ coord snap_x(coord x, const objects_t&, const Grid&, coord y0, coord y1,
 coord snap_y(coord y, const objects_t&, const Grid&, coord x0, coord x1,
   coord maxDistance=g_maxSnapDistance);
 
+// Variants of snap, snap_x and snap_y which use the SnapIndex of the
+// image instead of retrieving the attach points of every object. The
+// attach points of the ignored objects are not snapped to (e.g. the
+// objects being moved).
+Point snap(const Point&, const Image&, const objects_t& ignored,
+  const Grid&, coord maxDistance=g_maxSnapDistance);
+
+Point snap(const Point&, const Image&, const objects_t& ignored,
+  const Grid&, const std::vector<Point>& extraPoints,
+  coord maxDistance=g_maxSnapDistance);
+
+coord snap_x(coord x, const Image&, const objects_t& ignored, const Grid&,
+  coord y0, coord y1, coord maxDistance=g_maxSnapDistance);
+coord snap_y(coord y, const Image&, const objects_t& ignored, const Grid&,
+  coord x0, coord x1, coord maxDistance=g_maxSnapDistance);
+
 bool supports_object_aligned_resize(Object*);
 bool supports_point_editing(Object*);
 
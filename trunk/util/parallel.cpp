@@ -0,0 +1,301 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "util/parallel.hh"
+
+namespace faint{
+
+class Job{
+  // A parallel_for-call, split into ranges.
+public:
+  Job(const range_func_t& func, int numRanges)
+    : failed(false),
+      func(func),
+      remaining(numRanges)
+  {}
+
+  std::atomic<bool> failed;
+  const range_func_t& func;
+  std::atomic<int> remaining;
+  std::mutex errorMutex;
+  std::exception_ptr error;
+};
+
+class Task{
+public:
+  Job* job;
+  int begin;
+  int end;
+};
+
+class TaskQueue{
+public:
+  std::mutex mutex;
+  std::deque<Task> tasks;
+};
+
+static std::atomic<long long> g_jobs(0);
+static std::atomic<long long> g_tasks(0);
+static std::atomic<long long> g_taskNanoseconds(0);
+
+// True for pool workers, and for threads running a parallel_for.
+static thread_local bool t_inParallel = false;
+
+static void run_task(const Task& task){
+  const auto start = std::chrono::steady_clock::now();
+  Job& job = *task.job;
+  try{
+    if (!job.failed){
+      job.func(task.begin, task.end);
+    }
+  }
+  catch (...){
+    std::lock_guard<std::mutex> lock(job.errorMutex);
+    if (!job.error){
+      job.error = std::current_exception();
+      job.failed = true;
+    }
+  }
+  const auto duration = std::chrono::steady_clock::now() - start;
+  g_tasks++;
+  g_taskNanoseconds += std::chrono::duration_cast<
+    std::chrono::nanoseconds>(duration).count();
+
+  // Must be last, the Job is gone once the caller sees zero.
+  job.remaining--;
+}
+
+class ThreadPool{
+  // Worker threads with a queue each. A worker takes tasks from the
+  // front of its own queue, and steals from the back of the others'
+  // when its queue is empty.
+public:
+  explicit ThreadPool(int numWorkers)
+    : m_queued(0),
+      m_queues(static_cast<size_t>(numWorkers)),
+      m_quit(false)
+  {
+    for (auto& queue : m_queues){
+      queue.reset(new TaskQueue());
+    }
+    for (int i = 0; i != numWorkers; i++){
+      m_threads.emplace_back([this, i](){
+        t_inParallel = true;
+        Work(i);
+      });
+    }
+  }
+
+  ~ThreadPool(){
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_quit = true;
+    }
+    m_wakeUp.notify_all();
+    for (auto& thread : m_threads){
+      thread.join();
+    }
+  }
+
+  void Run(int count, int grain, const range_func_t& func){
+    const int numRanges = (count - 1) / grain + 1;
+    Job job(func, numRanges);
+
+    // Deal the ranges over the queues, keeping neighbouring ranges
+    // on the same worker.
+    const int numQueues = static_cast<int>(m_queues.size());
+    for (int q = 0; q != numQueues; q++){
+      const int first = numRanges * q / numQueues;
+      const int last = numRanges * (q + 1) / numQueues;
+      if (first == last){
+        continue;
+      }
+      TaskQueue& queue = *m_queues[static_cast<size_t>(q)];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      for (int r = first; r != last; r++){
+        queue.tasks.push_back({&job, r * grain,
+          std::min((r + 1) * grain, count)});
+      }
+      std::lock_guard<std::mutex> countLock(m_mutex);
+      m_queued += last - first;
+    }
+    m_wakeUp.notify_all();
+
+    // Help out until all ranges are done. This may run tasks from
+    // other callers' jobs too.
+    t_inParallel = true;
+    while (job.remaining != 0){
+      Task task;
+      if (TakeTask(0, task)){
+        run_task(task);
+      }
+      else{
+        std::this_thread::yield();
+      }
+    }
+    t_inParallel = false;
+
+    if (job.error){
+      std::rethrow_exception(job.error);
+    }
+  }
+
+  int NumWorkers() const{
+    return static_cast<int>(m_threads.size());
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+private:
+  bool TakeTask(int first, Task& task){
+    // Pops from the front of the queue first, or steals from the back
+    // of the others.
+    const size_t numQueues = m_queues.size();
+    for (size_t i = 0; i != numQueues; i++){
+      TaskQueue& queue = *m_queues[(static_cast<size_t>(first) + i) %
+        numQueues];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (!queue.tasks.empty()){
+        if (i == 0){
+          task = queue.tasks.front();
+          queue.tasks.pop_front();
+        }
+        else{
+          task = queue.tasks.back();
+          queue.tasks.pop_back();
+        }
+        std::lock_guard<std::mutex> countLock(m_mutex);
+        m_queued--;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Work(int index){
+    for (;;){
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wakeUp.wait(lock, [this](){
+          return m_quit || m_queued != 0;
+        });
+        if (m_quit){
+          return;
+        }
+      }
+
+      Task task;
+      while (TakeTask(index, task)){
+        run_task(task);
+      }
+    }
+  }
+
+  std::mutex m_mutex;
+  int m_queued;
+  std::vector<std::unique_ptr<TaskQueue>> m_queues;
+  bool m_quit;
+  std::vector<std::thread> m_threads;
+  std::condition_variable m_wakeUp;
+};
+
+static std::mutex g_poolMutex;
+static std::shared_ptr<ThreadPool> g_pool;
+static int g_concurrency = 0;
+
+static int num_cores(){
+  return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+static std::shared_ptr<ThreadPool> get_pool(){
+  // Started on first use. The pool is shared, so that a call to
+  // set_concurrency does not pull it from under running jobs.
+  std::lock_guard<std::mutex> lock(g_poolMutex);
+  if (g_pool == nullptr){
+    g_pool = std::make_shared<ThreadPool>(
+      (g_concurrency > 0 ? g_concurrency : num_cores()) - 1);
+  }
+  return g_pool;
+}
+
+int get_concurrency(){
+  std::lock_guard<std::mutex> lock(g_poolMutex);
+  return g_concurrency > 0 ? g_concurrency : num_cores();
+}
+
+void set_concurrency(int concurrency){
+  std::shared_ptr<ThreadPool> oldPool;
+  {
+    std::lock_guard<std::mutex> lock(g_poolMutex);
+    g_concurrency = std::max(0, concurrency);
+    oldPool.swap(g_pool);
+  }
+  // The old workers are joined here, or by the last parallel_for
+  // still using them.
+}
+
+ParallelStats get_parallel_stats(){
+  ParallelStats stats;
+  stats.jobs = g_jobs;
+  stats.tasks = g_tasks;
+  stats.taskSeconds = static_cast<double>(g_taskNanoseconds) / 1e9;
+  return stats;
+}
+
+void reset_parallel_stats(){
+  g_jobs = 0;
+  g_tasks = 0;
+  g_taskNanoseconds = 0;
+}
+
+int parallel_grain(int count, int minGrain){
+  const int rangesPerThread = 4;
+  return std::max(std::max(1, minGrain),
+    count / (rangesPerThread * get_concurrency()));
+}
+
+void parallel_for(int count, int grain, const range_func_t& func){
+  if (count <= 0){
+    return;
+  }
+  grain = std::max(1, grain);
+  g_jobs++;
+
+  std::shared_ptr<ThreadPool> pool = t_inParallel || count <= grain ?
+    nullptr : get_pool();
+
+  if (pool == nullptr || pool->NumWorkers() == 0){
+    // Nested, too small to split or single-threaded
+    Job job(func, (count - 1) / grain + 1);
+    for (int begin = 0; begin < count; begin += grain){
+      run_task({&job, begin, std::min(begin + grain, count)});
+    }
+    if (job.error){
+      std::rethrow_exception(job.error);
+    }
+    return;
+  }
+  pool->Run(count, grain, func);
+}
+
+} // namespace
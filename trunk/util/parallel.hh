@@ -0,0 +1,91 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FAINT_PARALLEL_HH
+#define FAINT_PARALLEL_HH
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace faint{
+
+// Returns the number of threads used for parallel work, including
+// the calling thread.
+int get_concurrency();
+
+// Sets the number of threads used for parallel work. Values less
+// than one select one thread per core.
+void set_concurrency(int);
+
+class ParallelStats{
+  // Counters for the work done by parallel_for and parallel_reduce.
+public:
+  // The number of parallel_for-calls
+  long long jobs = 0;
+
+  // The number of ranges run, over all threads
+  long long tasks = 0;
+
+  // The time spent running ranges, summed over all threads
+  double taskSeconds = 0.0;
+};
+
+ParallelStats get_parallel_stats();
+void reset_parallel_stats();
+
+using range_func_t = std::function<void(int begin, int end)>;
+
+// Calls func(begin, end) for consecutive ranges covering [0, count),
+// each at most grain long. The ranges are run by a shared pool of
+// worker threads and the calling thread, which returns when all
+// ranges are done.
+//
+// The first exception thrown by func is rethrown by parallel_for,
+// ranges not yet started are then skipped. Calls from within func
+// run serially on the calling thread.
+void parallel_for(int count, int grain, const range_func_t& func);
+
+// Returns a grain which splits count into a few ranges per thread,
+// but no ranges shorter than minGrain.
+int parallel_grain(int count, int minGrain);
+
+template<typename T, typename MAP, typename REDUCE>
+T parallel_reduce(int count, int grain, T init,
+  const MAP& map,
+  const REDUCE& reduce)
+{
+  // Maps each range to a T with map(begin, end), in parallel, and
+  // then combines the results in order with init = reduce(init, t),
+  // so the result is the same for any number of threads.
+  if (count <= 0){
+    return init;
+  }
+  grain = std::max(1, grain);
+  const int numRanges = (count - 1) / grain + 1;
+  std::vector<T> results(static_cast<size_t>(numRanges), init);
+  parallel_for(count, grain, [&](int begin, int end){
+    results[static_cast<size_t>(begin / grain)] = map(begin, end);
+  });
+
+  for (T& result : results){
+    init = reduce(std::move(init), std::move(result));
+  }
+  return init;
+}
+
+} // namespace
+
+#endif
@@ -0,0 +1,226 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <algorithm>
+#include <cassert>
+#include "bitmap/color.hh"
+#include "bitmap/draw.hh"
+#include "geo/geo-func.hh"
+#include "geo/int-point.hh"
+#include "geo/offsat.hh"
+#include "util/preview-filter.hh"
+
+namespace faint{
+
+// Rows filtered between checks for cancellation
+static const int band_height = 64;
+
+PreviewFilter::PreviewFilter(PreviewKind kind,
+  int margin,
+  int alignment,
+  const func_t& func)
+  : func(func),
+    kind(kind),
+    margin(margin),
+    alignment(alignment)
+{}
+
+PreviewFilter PreviewFilter::Pixelwise(const func_t& func){
+  return PreviewFilter(PreviewKind::PIXELWISE, 0, 1, func);
+}
+
+PreviewFilter PreviewFilter::Local(int margin,
+  int alignment,
+  const func_t& func)
+{
+  return PreviewFilter(PreviewKind::LOCAL, std::max(margin, 0),
+    std::max(alignment, 1), func);
+}
+
+PreviewFilter PreviewFilter::Global(const func_t& func){
+  return PreviewFilter(PreviewKind::GLOBAL, 0, 1, func);
+}
+
+PreviewFilter PreviewFilter::ScaleInvariant(const func_t& func){
+  return PreviewFilter(PreviewKind::SCALE_INVARIANT, 0, 1, func);
+}
+
+static Bitmap resized_nearest(const Bitmap& src, const IntSize& size){
+  Bitmap dst(size);
+  for (int y = 0; y != size.h; y++){
+    const int srcY = static_cast<int>((static_cast<long long>(y) * src.m_h) /
+      size.h);
+    for (int x = 0; x != size.w; x++){
+      const int srcX = static_cast<int>(
+        (static_cast<long long>(x) * src.m_w) / size.w);
+      put_pixel_raw(dst, x, y, get_color_raw(src, srcX, srcY));
+    }
+  }
+  return dst;
+}
+
+static Bitmap resized_nearest(const Bitmap& src, const IntSize& fullSize,
+  const IntRect& region)
+{
+  // Returns the region of the source scaled up to the full size,
+  // without scaling the rest.
+  Bitmap dst(region.GetSize());
+  for (int y = 0; y != region.h; y++){
+    const int srcY = static_cast<int>(
+      (static_cast<long long>(region.y + y) * src.m_h) / fullSize.h);
+    for (int x = 0; x != region.w; x++){
+      const int srcX = static_cast<int>(
+        (static_cast<long long>(region.x + x) * src.m_w) / fullSize.w);
+      put_pixel_raw(dst, x, y, get_color_raw(src, srcX, srcY));
+    }
+  }
+  return dst;
+}
+
+static IntSize shown_size(const IntSize& size, coord zoom){
+  return IntSize(std::max(1, static_cast<int>(size.w * zoom)),
+    std::max(1, static_cast<int>(size.h * zoom)));
+}
+
+static Optional<Bitmap> filter_bands(const Bitmap& src,
+  const PreviewFilter::func_t& func,
+  const CoalescingWorker::is_cancelled_t& isCancelled)
+{
+  Bitmap dst(src.GetSize());
+  for (int y = 0; y < src.m_h; y += band_height){
+    if (isCancelled()){
+      return no_option();
+    }
+    const IntRect band(IntPoint(0, y),
+      IntSize(src.m_w, std::min(band_height, src.m_h - y)));
+    blit(offsat(func(subbitmap(src, band)), band.TopLeft()), onto(dst));
+  }
+  return option(dst);
+}
+
+static int aligned_down(int v, int alignment){
+  return v - v % alignment;
+}
+
+static int aligned_up(int v, int alignment){
+  return aligned_down(v + alignment - 1, alignment);
+}
+
+static Optional<Bitmap> filter_pixelwise(const Bitmap& src,
+  const PreviewFilter& filter,
+  const IntRect& region,
+  coord zoom,
+  const CoalescingWorker::is_cancelled_t& isCancelled)
+{
+  const Bitmap original(subbitmap(src, region));
+  if (zoom >= 1.0){
+    return filter_bands(original, filter.func, isCancelled);
+  }
+
+  // Zoomed out, so filter only as many pixels as are shown
+  const auto filtered = filter_bands(
+    resized_nearest(original, shown_size(region.GetSize(), zoom)),
+    filter.func, isCancelled);
+  if (filtered.NotSet()){
+    return no_option();
+  }
+  return option(resized_nearest(filtered.Get(), region.GetSize()));
+}
+
+static Optional<Bitmap> filter_local(const Bitmap& src,
+  const PreviewFilter& filter,
+  const IntRect& region,
+  const CoalescingWorker::is_cancelled_t& isCancelled)
+{
+  const int a = filter.alignment;
+  const IntRect extended(inflated(region, filter.margin));
+  const IntRect aligned(
+    IntPoint(aligned_down(std::max(extended.x, 0), a),
+      aligned_down(std::max(extended.y, 0), a)),
+    IntPoint(aligned_up(extended.Right() + 1, a) - 1,
+      aligned_up(extended.Bottom() + 1, a) - 1));
+  const IntRect computed(intersection(aligned, rect_from_size(src.GetSize())));
+
+  if (isCancelled()){
+    return no_option();
+  }
+  const Bitmap filtered(filter.func(subbitmap(src, computed)));
+  if (isCancelled()){
+    return no_option();
+  }
+  return option(subbitmap(filtered,
+    translated(region, -computed.TopLeft())));
+}
+
+static Optional<Bitmap> filter_global(const Bitmap& src,
+  const PreviewFilter& filter,
+  const IntRect& region,
+  const CoalescingWorker::is_cancelled_t& isCancelled)
+{
+  if (isCancelled()){
+    return no_option();
+  }
+  const Bitmap filtered(filter.func(src));
+  if (isCancelled()){
+    return no_option();
+  }
+  return option(subbitmap(filtered, region));
+}
+
+static Optional<Bitmap> filter_scale_invariant(const Bitmap& src,
+  const PreviewFilter& filter,
+  const IntRect& region,
+  coord zoom,
+  const CoalescingWorker::is_cancelled_t& isCancelled)
+{
+  if (zoom >= 1.0){
+    return filter_global(src, filter, region, isCancelled);
+  }
+  if (isCancelled()){
+    return no_option();
+  }
+  const Bitmap filtered(filter.func(
+    resized_nearest(src, shown_size(src.GetSize(), zoom))));
+  if (isCancelled()){
+    return no_option();
+  }
+  return option(resized_nearest(filtered, src.GetSize(), region));
+}
+
+Optional<Bitmap> filter_region(const Bitmap& src,
+  const PreviewFilter& filter,
+  const IntRect& region,
+  coord zoom,
+  const CoalescingWorker::is_cancelled_t& isCancelled)
+{
+  switch (filter.kind){
+  case PreviewKind::PIXELWISE:
+    return filter_pixelwise(src, filter, region, zoom, isCancelled);
+
+  case PreviewKind::LOCAL:
+    return filter_local(src, filter, region, isCancelled);
+
+  case PreviewKind::GLOBAL:
+    return filter_global(src, filter, region, isCancelled);
+
+  case PreviewKind::SCALE_INVARIANT:
+    return filter_scale_invariant(src, filter, region, zoom, isCancelled);
+  }
+
+  assert(false);
+  return no_option();
+}
+
+} // namespace
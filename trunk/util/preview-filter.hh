@@ -0,0 +1,84 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FAINT_PREVIEW_FILTER_HH
+#define FAINT_PREVIEW_FILTER_HH
+#include <functional>
+#include "bitmap/bitmap.hh"
+#include "geo/int-rect.hh"
+#include "util/coalescing-worker.hh"
+#include "util/optional.hh"
+
+namespace faint{
+
+enum class PreviewKind{
+  // Each pixel depends only on itself, so the preview can be computed
+  // for the visible region only, at display resolution when zoomed
+  // out.
+  PIXELWISE,
+
+  // Each pixel depends on pixels within a margin, so the preview is
+  // computed for the visible region extended by the margin.
+  LOCAL,
+
+  // Each pixel may depend on any pixel, so the preview is computed
+  // for the entire bitmap.
+  GLOBAL,
+
+  // Each pixel may depend on any pixel, but filtering a scaled
+  // bitmap gives the scaled result, so the preview is computed for
+  // the entire bitmap at display resolution when zoomed out.
+  SCALE_INVARIANT
+};
+
+class PreviewFilter{
+  // A filter to preview, and how far its effect on a pixel reaches.
+public:
+  using func_t = std::function<Bitmap(const Bitmap&)>;
+
+  static PreviewFilter Pixelwise(const func_t&);
+
+  // A filter reading pixels at most margin pixels away. If alignment
+  // is greater than one, the filter works on cells of that size
+  // anchored at the top left corner, and the computed region is
+  // aligned to the cells.
+  static PreviewFilter Local(int margin, int alignment, const func_t&);
+
+  static PreviewFilter Global(const func_t&);
+
+  static PreviewFilter ScaleInvariant(const func_t&);
+
+  func_t func;
+  PreviewKind kind;
+  int margin;
+  int alignment;
+private:
+  PreviewFilter(PreviewKind, int margin, int alignment, const func_t&);
+};
+
+// Returns the filtered region of the bitmap, computed from as little
+// of the bitmap as the filter kind allows. Pixelwise filters are
+// computed at the given zoom if it is less than one, and expanded to
+// the size of the region, and likewise scale invariant filters.
+// Returns nothing if cancelled.
+Optional<Bitmap> filter_region(const Bitmap&,
+  const PreviewFilter&,
+  const IntRect& region,
+  coord zoom,
+  const CoalescingWorker::is_cancelled_t&);
+
+} // namespace
+
+#endif
@@ -0,0 +1,89 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FAINT_RING_BUFFER_HH
+#define FAINT_RING_BUFFER_HH
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace faint{
+
+template<typename T, size_t CAPACITY>
+class RingBuffer{
+  // A fixed-capacity queue for one producing and one consuming
+  // thread, which may push and drain concurrently without locking.
+  //
+  // The positions increase without wrapping the index into the
+  // buffer, so that a full buffer can be told from an empty one.
+  static_assert(CAPACITY != 0 && (CAPACITY & (CAPACITY - 1)) == 0,
+    "RingBuffer capacity must be a power of two");
+public:
+  RingBuffer()
+    : m_read(0),
+      m_write(0)
+  {}
+
+  // Returns true if there are no items to drain. Only exact on the
+  // consuming thread.
+  bool Empty() const{
+    return m_read.load(std::memory_order_relaxed) ==
+      m_write.load(std::memory_order_acquire);
+  }
+
+  // Adds the item, unless the buffer is full. Returns false if the
+  // item was not added. Call only from the producing thread.
+  bool Push(const T& item){
+    const size_t write = m_write.load(std::memory_order_relaxed);
+    if (write - m_read.load(std::memory_order_acquire) == CAPACITY){
+      return false;
+    }
+    m_items[write & (CAPACITY - 1)] = item;
+    m_write.store(write + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Calls func for each item pushed so far, in order, and removes
+  // them. Returns the number of items passed to func. Call only from
+  // the consuming thread.
+  //
+  // Each item is removed before func is called with it, so func may
+  // itself drain the buffer without an item being passed twice.
+  template<typename FUNC>
+  size_t Drain(const FUNC& func){
+    size_t count = 0;
+    for (;;){
+      const size_t read = m_read.load(std::memory_order_relaxed);
+      if (read == m_write.load(std::memory_order_acquire)){
+        return count;
+      }
+      const T item(m_items[read & (CAPACITY - 1)]);
+      m_read.store(read + 1, std::memory_order_release);
+      func(item);
+      count++;
+    }
+  }
+
+  RingBuffer(const RingBuffer&) = delete;
+  RingBuffer& operator=(const RingBuffer&) = delete;
+private:
+  std::array<T, CAPACITY> m_items;
+  std::atomic<size_t> m_read;
+  std::atomic<size_t> m_write;
+};
+
+} // namespace
+
+#endif
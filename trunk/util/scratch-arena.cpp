@@ -0,0 +1,187 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include "util/scratch-arena.hh"
+
+namespace faint{
+
+// The smallest block allocated, to avoid many blocks for small
+// allocations.
+static const size_t min_block_size = 64 * 1024;
+
+static unsigned char* aligned(unsigned char* p){
+  const uintptr_t v = reinterpret_cast<uintptr_t>(p);
+  return p + (scratch_alignment - v % scratch_alignment) % scratch_alignment;
+}
+
+ScratchArena::ScratchArena()
+  : m_current(0),
+    m_offset(0),
+    m_used(0),
+    m_peak(0),
+    m_heapAllocations(0)
+{}
+
+ScratchArena::~ScratchArena(){}
+
+void ScratchArena::AddBlock(size_t minSize){
+  // Inserts the block after the current block, so that blocks kept
+  // after a Rewind are used in order.
+  const size_t insertAt = m_blocks.empty() ? 0 : m_current + 1;
+  const size_t grown = m_blocks.empty() ? 0 :
+    2 * m_blocks[m_current].size;
+
+  // Extra room so that the start can be aligned
+  const size_t size = std::max({minSize + scratch_alignment, grown,
+    min_block_size});
+  m_blocks.insert(begin(m_blocks) + static_cast<std::ptrdiff_t>(insertAt),
+    Block{std::unique_ptr<unsigned char[]>(new unsigned char[size]), size});
+  m_current = insertAt;
+  m_offset = 0;
+  m_heapAllocations++;
+}
+
+void* ScratchArena::Allocate(size_t bytes){
+  if (m_blocks.empty()){
+    AddBlock(bytes);
+  }
+  Block* block = &m_blocks[m_current];
+  unsigned char* p = aligned(block->data.get() + m_offset);
+  if (static_cast<size_t>(p - block->data.get()) + bytes > block->size){
+    const size_t next = m_current + 1;
+    if (next < m_blocks.size() &&
+      m_blocks[next].size >= bytes + scratch_alignment)
+    {
+      // Reuse a block kept after a Rewind
+      m_current = next;
+      m_offset = 0;
+    }
+    else{
+      AddBlock(bytes);
+    }
+    block = &m_blocks[m_current];
+    p = aligned(block->data.get());
+  }
+  const size_t end = static_cast<size_t>(p - block->data.get()) + bytes;
+  m_used += end - m_offset;
+  m_peak = std::max(m_peak, m_used);
+  m_offset = end;
+  return p;
+}
+
+ScratchArena::Mark ScratchArena::GetMark() const{
+  Mark mark;
+  mark.block = m_current;
+  mark.offset = m_offset;
+  mark.used = m_used;
+  return mark;
+}
+
+void ScratchArena::Rewind(const Mark& mark){
+  assert(mark.used <= m_used);
+  m_current = mark.block;
+  m_offset = mark.offset;
+  m_used = mark.used;
+}
+
+void ScratchArena::Reset(){
+  const size_t total = Capacity();
+  if (total > scratch_max_kept){
+    m_blocks.clear();
+  }
+  else if (m_blocks.size() > 1){
+    m_blocks.clear();
+    AddBlock(total);
+  }
+  m_current = 0;
+  m_offset = 0;
+  m_used = 0;
+}
+
+size_t ScratchArena::Used() const{
+  return m_used;
+}
+
+size_t ScratchArena::Capacity() const{
+  size_t total = 0;
+  for (const Block& block : m_blocks){
+    total += block.size;
+  }
+  return total;
+}
+
+size_t ScratchArena::Peak() const{
+  return m_peak;
+}
+
+size_t ScratchArena::HeapAllocations() const{
+  return m_heapAllocations;
+}
+
+ScratchArenaRewind::ScratchArenaRewind(ScratchArena* arena)
+  : m_arena(arena)
+{
+  if (m_arena != nullptr){
+    m_mark = m_arena->GetMark();
+  }
+}
+
+ScratchArenaRewind::~ScratchArenaRewind(){
+  if (m_arena != nullptr){
+    m_arena->Rewind(m_mark);
+  }
+}
+
+class FrameArena{
+public:
+  ScratchArena arena;
+  bool active = false;
+};
+
+static FrameArena& thread_frame_arena(){
+  static thread_local FrameArena frameArena;
+  return frameArena;
+}
+
+ScratchArena* frame_arena(){
+  FrameArena& frame = thread_frame_arena();
+  return frame.active ? &frame.arena : nullptr;
+}
+
+FrameArenaScope::FrameArenaScope()
+  : m_outermost(!thread_frame_arena().active),
+    m_mark(thread_frame_arena().arena.GetMark())
+{
+  thread_frame_arena().active = true;
+}
+
+FrameArenaScope::~FrameArenaScope(){
+  FrameArena& frame = thread_frame_arena();
+  if (m_outermost){
+    frame.active = false;
+    frame.arena.Reset();
+  }
+  else{
+    frame.arena.Rewind(m_mark);
+  }
+}
+
+ScratchArena& FrameArenaScope::Arena(){
+  return thread_frame_arena().arena;
+}
+
+} // namespace
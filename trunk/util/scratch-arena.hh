@@ -0,0 +1,149 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+#ifndef FAINT_SCRATCH_ARENA_HH
+#define FAINT_SCRATCH_ARENA_HH
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace faint{
+
+// The alignment of the memory returned by ScratchArena::Allocate.
+const size_t scratch_alignment = 64;
+
+// The most memory ScratchArena::Reset keeps for reuse. Larger
+// arenas are released, so that an exceptional operation does not
+// hold its memory for the rest of the session.
+const size_t scratch_max_kept = 32 * 1024 * 1024;
+
+class ScratchArena{
+  // Bump allocator for temporary buffers. Everything allocated is
+  // released at once by Reset, which keeps the memory for reuse, so
+  // that an operation repeated with the same arena only allocates
+  // from the heap the first time.
+  //
+  // Not thread safe, use one arena per thread.
+public:
+  ScratchArena();
+  ~ScratchArena();
+
+  // Returns uninitialized memory for the given number of bytes,
+  // aligned to scratch_alignment. The memory is valid until Reset or
+  // the arena is destroyed.
+  void* Allocate(size_t bytes);
+
+  template<typename T>
+  T* AllocateArray(size_t count){
+    // Note: For trivial types only, no constructors are run.
+    return static_cast<T*>(Allocate(count * sizeof(T)));
+  }
+
+  class Mark{
+    // A position in the arena, for releasing the allocations made
+    // after it with Rewind.
+  private:
+    friend class ScratchArena;
+    size_t block = 0;
+    size_t offset = 0;
+    size_t used = 0;
+  };
+
+  // Returns the current position, for Rewind.
+  Mark GetMark() const;
+
+  // Releases the allocations made since the mark was taken, for
+  // reuse by later allocations. The memory is kept by the arena.
+  void Rewind(const Mark&);
+
+  // Releases all allocations. Memory from several blocks is merged
+  // into one block, so that the next round fits without allocating,
+  // unless it exceeds scratch_max_kept, in which case it is freed.
+  void Reset();
+
+  // The number of bytes allocated since the last Reset, including
+  // alignment padding.
+  size_t Used() const;
+
+  // The number of bytes held by the arena.
+  size_t Capacity() const;
+
+  // The largest Used() seen, across resets.
+  size_t Peak() const;
+
+  // The number of blocks allocated from the heap by the arena, for
+  // checking that a repeated operation has stopped allocating.
+  size_t HeapAllocations() const;
+
+  ScratchArena(const ScratchArena&) = delete;
+  ScratchArena& operator=(const ScratchArena&) = delete;
+private:
+  class Block{
+  public:
+    std::unique_ptr<unsigned char[]> data;
+    size_t size;
+  };
+  void AddBlock(size_t minSize);
+
+  std::vector<Block> m_blocks;
+  size_t m_current; // The block allocated from
+  size_t m_offset; // Within the current block
+  size_t m_used;
+  size_t m_peak;
+  size_t m_heapAllocations;
+};
+
+class ScratchArenaRewind{
+  // Rewinds the arena to where it was when the ScratchArenaRewind
+  // was created, when it goes out of scope, so that the temporaries
+  // of a call do not add up over many calls. Does nothing for a
+  // nullptr arena.
+public:
+  explicit ScratchArenaRewind(ScratchArena*);
+  ~ScratchArenaRewind();
+
+  ScratchArenaRewind(const ScratchArenaRewind&) = delete;
+  ScratchArenaRewind& operator=(const ScratchArenaRewind&) = delete;
+private:
+  ScratchArena* m_arena;
+  ScratchArena::Mark m_mark;
+};
+
+// Returns the frame arena of the calling thread if a FrameArenaScope
+// is active on it, otherwise nullptr.
+ScratchArena* frame_arena();
+
+class FrameArenaScope{
+  // Makes the thread's frame arena available via frame_arena() for
+  // the lifetime of the scope (e.g. a paint event), and resets it
+  // when the outermost scope ends. A nested scope instead rewinds the
+  // arena to where it was when the nested scope started. Anything
+  // allocated from the frame arena within a scope must be released
+  // before the scope ends.
+public:
+  FrameArenaScope();
+  ~FrameArenaScope();
+
+  ScratchArena& Arena();
+
+  FrameArenaScope(const FrameArenaScope&) = delete;
+  FrameArenaScope& operator=(const FrameArenaScope&) = delete;
+private:
+  bool m_outermost;
+  ScratchArena::Mark m_mark;
+};
+
+} // namespace
+
+#endif
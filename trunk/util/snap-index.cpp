@@ -0,0 +1,210 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include "geo/measure.hh"
+#include "objects/object.hh"
+#include "util/object-util.hh"
+#include "util/snap-index.hh"
+
+namespace faint{
+
+using entries_t = std::vector<SnapIndex::Entry>;
+using entry_iter = entries_t::iterator;
+
+static coord axis_value(const Point& p, int depth){
+  return depth % 2 == 0 ? p.x : p.y;
+}
+
+static void build_tree(entry_iter lo, entry_iter hi, int depth){
+  // Orders the entries as an implicit 2d-tree: the median of each
+  // range splits the range on alternating axes.
+  if (hi - lo <= 1){
+    return;
+  }
+  entry_iter mid = lo + (hi - lo) / 2;
+  std::nth_element(lo, mid, hi,
+    [depth](const SnapIndex::Entry& e1, const SnapIndex::Entry& e2){
+      return axis_value(e1.pos, depth) < axis_value(e2.pos, depth);
+    });
+  build_tree(lo, mid, depth + 1);
+  build_tree(mid + 1, hi, depth + 1);
+}
+
+class BestEntry{
+public:
+  BestEntry(coord maxDistance)
+    : m_distance(maxDistance),
+      m_entry(nullptr)
+  {}
+
+  // The distance a point must be within to possibly replace the
+  // current best entry.
+  coord Distance() const{
+    return m_distance;
+  }
+
+  const SnapIndex::Entry* Get() const{
+    return m_entry;
+  }
+
+  void Offer(const SnapIndex::Entry& e, coord distance){
+    if (distance < m_distance ||
+      (m_entry != nullptr && distance == m_distance &&
+        e.order < m_entry->order))
+    {
+      m_distance = distance;
+      m_entry = &e;
+    }
+  }
+
+private:
+  coord m_distance;
+  const SnapIndex::Entry* m_entry;
+};
+
+static bool excluded_object(const SnapIndex::Entry& e,
+  const objects_t& excluded)
+{
+  return !excluded.empty() && contains(excluded, e.object);
+}
+
+static void find_closest(const entries_t& entries,
+  size_t lo,
+  size_t hi,
+  int depth,
+  const Point& p,
+  const objects_t& excluded,
+  BestEntry& best)
+{
+  if (lo >= hi){
+    return;
+  }
+  const size_t mid = lo + (hi - lo) / 2;
+  const SnapIndex::Entry& e = entries[mid];
+  if (!excluded_object(e, excluded)){
+    best.Offer(e, distance(p, e.pos));
+  }
+
+  const coord delta = axis_value(p, depth) - axis_value(e.pos, depth);
+  if (delta < 0){
+    find_closest(entries, lo, mid, depth + 1, p, excluded, best);
+    if (-delta <= best.Distance()){
+      find_closest(entries, mid + 1, hi, depth + 1, p, excluded, best);
+    }
+  }
+  else{
+    find_closest(entries, mid + 1, hi, depth + 1, p, excluded, best);
+    if (delta <= best.Distance()){
+      find_closest(entries, lo, mid, depth + 1, p, excluded, best);
+    }
+  }
+}
+
+static void find_closest_in_band(const entries_t& entries,
+  size_t lo,
+  size_t hi,
+  int depth,
+  int axis,
+  coord value,
+  coord bandMin,
+  coord bandMax,
+  const objects_t& excluded,
+  BestEntry& best)
+{
+  // Finds the entry with the value on the given axis (0 for x, 1 for
+  // y) closest to value, with the other coordinate within the band.
+  if (lo >= hi){
+    return;
+  }
+  const size_t mid = lo + (hi - lo) / 2;
+  const SnapIndex::Entry& e = entries[mid];
+  const coord entryValue = axis_value(e.pos, axis);
+  const coord entryBand = axis_value(e.pos, axis + 1);
+  if (bandMin <= entryBand && entryBand <= bandMax &&
+    !excluded_object(e, excluded))
+  {
+    best.Offer(e, std::fabs(entryValue - value));
+  }
+
+  const coord split = axis_value(e.pos, depth);
+  const bool splitOnValue = depth % 2 == axis;
+  const coord rangeMin = splitOnValue ? value - best.Distance() : bandMin;
+  if (rangeMin <= split){
+    find_closest_in_band(entries, lo, mid, depth + 1, axis, value,
+      bandMin, bandMax, excluded, best);
+  }
+  const coord rangeMax = splitOnValue ? value + best.Distance() : bandMax;
+  if (rangeMax >= split){
+    find_closest_in_band(entries, mid + 1, hi, depth + 1, axis, value,
+      bandMin, bandMax, excluded, best);
+  }
+}
+
+SnapIndex::SnapIndex(const objects_t& objects){
+  size_t order = 0;
+  for (const Object* obj : objects){
+    for (const Point& pt : obj->GetAttachPoints()){
+      m_entries.push_back({pt, obj, order++});
+    }
+  }
+  build_tree(begin(m_entries), end(m_entries), 0);
+}
+
+Optional<Point> SnapIndex::Closest(const Point& p,
+  coord maxDistance,
+  const objects_t& excluded) const
+{
+  BestEntry best(maxDistance);
+  find_closest(m_entries, 0, m_entries.size(), 0, p, excluded, best);
+  return best.Get() == nullptr ?
+    no_option() :
+    option(best.Get()->pos);
+}
+
+Optional<coord> SnapIndex::ClosestX(coord x,
+  coord y0,
+  coord y1,
+  coord maxDistance,
+  const objects_t& excluded) const
+{
+  BestEntry best(maxDistance);
+  find_closest_in_band(m_entries, 0, m_entries.size(), 0, 0, x, y0, y1,
+    excluded, best);
+  return best.Get() == nullptr ?
+    no_option() :
+    option(best.Get()->pos.x);
+}
+
+Optional<coord> SnapIndex::ClosestY(coord y,
+  coord x0,
+  coord x1,
+  coord maxDistance,
+  const objects_t& excluded) const
+{
+  BestEntry best(maxDistance);
+  find_closest_in_band(m_entries, 0, m_entries.size(), 0, 1, y, x0, x1,
+    excluded, best);
+  return best.Get() == nullptr ?
+    no_option() :
+    option(best.Get()->pos.y);
+}
+
+size_t SnapIndex::Size() const{
+  return m_entries.size();
+}
+
+} // namespace
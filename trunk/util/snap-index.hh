@@ -0,0 +1,65 @@
+// -*- coding: us-ascii-unix -*-
+// Copyright 2015 Lukas Kemmer
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License. You
+// may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FAINT_SNAP_INDEX_HH
+#define FAINT_SNAP_INDEX_HH
+#include <vector>
+#include "geo/point.hh"
+#include "util/objects.hh"
+#include "util/optional.hh"
+
+namespace faint{
+
+class SnapIndex{
+  // A 2d-tree of the attach points of a list of objects, for finding
+  // points to snap to without retrieving the attach points of every
+  // object.
+  //
+  // Ties are resolved in favor of the object earliest in the list,
+  // like when searching the objects linearly.
+public:
+  SnapIndex() = default;
+  explicit SnapIndex(const objects_t&);
+
+  // Returns the attach point closest to the point, and closer than
+  // maxDistance, ignoring the points of the excluded objects.
+  Optional<Point> Closest(const Point&, coord maxDistance,
+    const objects_t& excluded) const;
+
+  // Returns the x-coordinate of the attach point with y within [y0,
+  // y1] which is closest to x, and closer than maxDistance.
+  Optional<coord> ClosestX(coord x, coord y0, coord y1, coord maxDistance,
+    const objects_t& excluded) const;
+
+  // Returns the y-coordinate of the attach point with x within [x0,
+  // x1] which is closest to y, and closer than maxDistance.
+  Optional<coord> ClosestY(coord y, coord x0, coord x1, coord maxDistance,
+    const objects_t& excluded) const;
+
+  size_t Size() const;
+
+  struct Entry{
+    Point pos;
+    const Object* object;
+    size_t order;
+  };
+
+private:
+  std::vector<Entry> m_entries;
+};
+
+} // namespace
+
+#endif